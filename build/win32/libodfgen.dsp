@@ -85,6 +85,14 @@ LIB32=link.exe -lib
 # PROP Default_Filter "cpp;c;cxx;rc;def;r;odl;idl;hpj;bat"
 # Begin Source File
 
+SOURCE=..\..\src\DataSink.cxx
+# End Source File
+# Begin Source File
+
+SOURCE=..\..\src\Deflater.cxx
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\DocumentElement.cxx
 # End Source File
 # Begin Source File
@@ -105,6 +113,22 @@ SOURCE=..\..\src\ListStyle.cxx
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\NameTable.cxx
+# End Source File
+# Begin Source File
+
+SOURCE=..\..\src\OdfDocumentHandler.cxx
+# End Source File
+# Begin Source File
+
+SOURCE=..\..\src\OdfPackageWriter.cxx
+# End Source File
+# Begin Source File
+
+SOURCE=..\..\src\OdfXMLWriter.cxx
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\OdgGenerator.cxx
 # End Source File
 # Begin Source File
@@ -113,6 +137,10 @@ SOURCE=..\..\src\OdpGenerator.cxx
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\OdsCellBlock.cxx
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\OdsGenerator.cxx
 # End Source File
 # Begin Source File
@@ -133,10 +161,18 @@ SOURCE=..\..\src\SheetStyle.cxx
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\StyleHash.cxx
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\TableStyle.cxx
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\TaskRunner.cxx
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\TextRunStyle.cxx
 # End Source File
 # End Group
@@ -145,6 +181,14 @@ SOURCE=..\..\src\TextRunStyle.cxx
 # PROP Default_Filter "h;hpp;hxx;hm;inl"
 # Begin Source File
 
+SOURCE=..\..\src\DataSink.hxx
+# End Source File
+# Begin Source File
+
+SOURCE=..\..\src\Deflater.hxx
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\DocumentElement.hxx
 # End Source File
 # Begin Source File
@@ -173,10 +217,22 @@ SOURCE=..\..\src\ListStyle.hxx
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\NameTable.hxx
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\inc\libodfgen\OdfDocumentHandler.hxx
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\inc\libodfgen\OdfPackageWriter.hxx
+# End Source File
+# Begin Source File
+
+SOURCE=..\..\inc\libodfgen\OdfXMLWriter.hxx
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\inc\libodfgen\OdgGenerator.hxx
 # End Source File
 # Begin Source File
@@ -185,6 +241,10 @@ SOURCE=..\..\inc\libodfgen\OdpGenerator.hxx
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\inc\libodfgen\OdsCellBlock.hxx
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\inc\libodfgen\OdsGenerator.hxx
 # End Source File
 # Begin Source File
@@ -205,6 +265,10 @@ SOURCE=..\..\src\Style.hxx
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\StyleHash.hxx
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\SheetStyle.hxx
 # End Source File
 # Begin Source File
@@ -213,6 +277,10 @@ SOURCE=..\..\src\TableStyle.hxx
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\TaskRunner.hxx
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\TextRunStyle.hxx
 # End Source File
 # End Group
@@ -95,6 +95,78 @@ public:
 	  */
 	virtual void characters(const librevenge::RVNGString &sCharacters) = 0;
 };
+
+/** An attribute sent to an OdfFastDocumentHandler.
+  *
+  * The name and the value point to memory owned by the generator;
+  * they are only valid during the call to
+  * OdfFastDocumentHandler::startElement.
+  */
+struct OdfAttribute
+{
+	//! the attribute's name
+	const char *name;
+	//! the attribute's value, terminated by a 0
+	const char *value;
+	//! the value's length in bytes
+	unsigned long length;
+	/** true if the value is already escaped and can be written as is
+	  * in the XML output.
+	  *
+	  * Most values are sent unescaped; only some values built by the
+	  * generators (formulas, link targets, style and layer names) are
+	  * escaped. The attributes converted from a property list are never
+	  * marked as escaped.
+	  */
+	bool escaped;
+};
+
+/** XML writer with a fast path.
+  *
+  * A handler deriving from this class receives the attributes of a
+  * start tag as an array of OdfAttribute pointing directly into the
+  * generator's storage and the textual content as a character array,
+  * so no intermediate librevenge::RVNGPropertyList or
+  * librevenge::RVNGString is created. The generators detect this
+  * interface, any other handler still receives the usual
+  * OdfDocumentHandler calls.
+  *
+  * @note a class which only overrides the fast functions should add
+  * using declarations to keep the property list functions visible.
+  */
+class ODFGENAPI OdfFastDocumentHandler : public OdfDocumentHandler
+{
+public:
+	virtual ~OdfFastDocumentHandler() {}
+
+	/** Add a start tag to the XML document.
+	  *
+	  * @param[in] psName name of the element
+	  * @param[in] pAttributes the attributes
+	  * @param[in] numAttributes the number of attributes
+	  */
+	virtual void startElement(const char *psName, const OdfAttribute *pAttributes, unsigned long numAttributes) = 0;
+
+	/** Insert a textual content into the currently opened element.
+	  *
+	  * @param[in] psCharacters the content, not escaped
+	  * @param[in] length the content's length in bytes
+	  */
+	virtual void characters(const char *psCharacters, unsigned long length) = 0;
+
+	/** Add a start tag to the XML document.
+	  *
+	  * The default implementation converts the property list and
+	  * calls the fast startElement.
+	  */
+	virtual void startElement(const char *psName, const librevenge::RVNGPropertyList &xPropList);
+
+	/** Insert a textual content into the currently opened element.
+	  *
+	  * The default implementation calls the fast characters.
+	  */
+	virtual void characters(const librevenge::RVNGString &sCharacters);
+};
 #endif
 
 /* vim:set shiftwidth=4 softtabstop=4 noexpandtab: */
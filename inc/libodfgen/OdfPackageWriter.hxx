@@ -0,0 +1,97 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* libodfgen
+ * Version: MPL 2.0 / LGPLv2.1+
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU Lesser General Public License Version 2.1 or later
+ * (LGPLv2.1+), in which case the provisions of the LGPLv2.1+ are
+ * applicable instead of those above.
+ *
+ * For further information visit http://libwpd.sourceforge.net
+ */
+
+#ifndef _ODFPACKAGEWRITER_HXX_
+#define _ODFPACKAGEWRITER_HXX_
+
+#include <stdio.h>
+
+#include <librevenge/librevenge.h>
+
+#include "libodfgen-api.hxx"
+#include "OdfDocumentHandler.hxx"
+#include "OdfXMLWriter.hxx"
+
+class OdfPackageWriterPrivate;
+
+/** A writer of ODF packages (zip files).
+  *
+  * When it is given to a generator with setPackageWriter, the generator
+  * writes the whole document in the package: the mimetype file, the
+  * XML files, the embedded objects and the manifest. Each file is
+  * compressed while it is created and sent to the output (a FILE, a
+  * file descriptor or a callback), so the memory used does not depend
+  * on the package size; when no output is given, the package is kept
+  * in memory and can be retrieved with getData.
+  *
+  * The compressor is included in libodfgen. The zip64 extensions are
+  * not supported, so the package must be smaller than 4 GB and contain
+  * at most 65535 files: when a limit is reached, nothing more is
+  * written and hasError returns true.
+  */
+class ODFGENAPI OdfPackageWriter
+{
+public:
+	//! creates a writer which keeps the package in memory
+	OdfPackageWriter();
+	//! creates a writer which writes in a file
+	explicit OdfPackageWriter(FILE *file);
+	//! creates a writer which writes in a file descriptor
+	explicit OdfPackageWriter(int fd);
+	//! creates a writer which sends the data to a callback
+	OdfPackageWriter(OdfXMLWriterCallback callback, void *userData);
+	~OdfPackageWriter();
+
+	/** adds a file in the package.
+	  *
+	  * @param[in] name the file's path in the package
+	  * @param[in] data the file's content
+	  * @param[in] size the content size
+	  * @param[in] compress false if the file must be stored without compression
+	  */
+	bool addFile(const char *name, const unsigned char *data, unsigned long size, bool compress=true);
+	/** starts a XML file: the returned handler writes the XML document
+	  * in the package until endXMLFile is called.
+	  */
+	OdfDocumentHandler *startXMLFile(const char *name);
+	//! ends the current XML file
+	bool endXMLFile();
+	/** writes the package directory: no file can be added after. It is
+	  * called by the generators at the end of the document.
+	  */
+	bool close();
+
+	/** returns the package data when the writer keeps it in memory, or
+	  * the data which are not yet sent to the output.
+	  */
+	const char *getData() const;
+	//! returns the size of the data returned by getData
+	unsigned long getDataSize() const;
+	//! returns true if some data could not be sent to the output or if the package is too big
+	bool hasError() const;
+
+private:
+	OdfPackageWriter(OdfPackageWriter const &);
+	OdfPackageWriter &operator=(OdfPackageWriter const &);
+
+	OdfPackageWriterPrivate *mpImpl;
+};
+
+#endif
+
+/* vim:set shiftwidth=4 softtabstop=4 noexpandtab: */
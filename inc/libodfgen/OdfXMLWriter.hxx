@@ -0,0 +1,92 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* libodfgen
+ * Version: MPL 2.0 / LGPLv2.1+
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU Lesser General Public License Version 2.1 or later
+ * (LGPLv2.1+), in which case the provisions of the LGPLv2.1+ are
+ * applicable instead of those above.
+ *
+ * For further information visit http://libwpd.sourceforge.net
+ */
+
+#ifndef _ODFXMLWRITER_HXX_
+#define _ODFXMLWRITER_HXX_
+
+#include <stdio.h>
+
+#include <librevenge/librevenge.h>
+
+#include "libodfgen-api.hxx"
+#include "OdfDocumentHandler.hxx"
+
+class OdfXMLWriterPrivate;
+
+/** Output function used by an OdfXMLWriter.
+  *
+  * @param[in] data the data to write
+  * @param[in] size the data size in bytes
+  * @param[in] userData the pointer given to the OdfXMLWriter
+  * @return false if the data can not be written
+  */
+typedef bool (*OdfXMLWriterCallback)(const char *data, unsigned long size, void *userData);
+
+/** A buffered XML writer.
+  *
+  * It serializes the generator's events as XML text: the text and the
+  * attributes which are not already escaped are escaped, the
+  * attributes with a librevenge: prefix are filtered out and an
+  * element without content is written as an empty-element tag. The
+  * output is accumulated in a growable buffer which is sent to the
+  * output (a FILE, a file descriptor or a callback) when it is full
+  * and at the end of the document; when no output is given, the whole
+  * document is kept in memory and can be retrieved with getData.
+  */
+class ODFGENAPI OdfXMLWriter : public OdfFastDocumentHandler
+{
+public:
+	using OdfFastDocumentHandler::startElement;
+	using OdfFastDocumentHandler::characters;
+
+	//! creates a writer which keeps the document in memory
+	OdfXMLWriter();
+	//! creates a writer which writes in a file
+	explicit OdfXMLWriter(FILE *file);
+	//! creates a writer which writes in a file descriptor
+	explicit OdfXMLWriter(int fd);
+	//! creates a writer which sends the data to a callback
+	OdfXMLWriter(OdfXMLWriterCallback callback, void *userData);
+	~OdfXMLWriter();
+
+	/** returns the document data when the writer keeps it in memory,
+	  * or the data which are not yet sent to the output. The data are
+	  * not terminated by a 0.
+	  */
+	const char *getData() const;
+	//! returns the size of the data returned by getData
+	unsigned long getDataSize() const;
+	//! returns true if some data could not be sent to the output
+	bool hasError() const;
+
+	void startDocument();
+	void endDocument();
+	void startElement(const char *psName, const OdfAttribute *pAttributes, unsigned long numAttributes);
+	void endElement(const char *psName);
+	void characters(const char *psCharacters, unsigned long length);
+
+private:
+	OdfXMLWriter(OdfXMLWriter const &);
+	OdfXMLWriter &operator=(OdfXMLWriter const &);
+
+	OdfXMLWriterPrivate *mpImpl;
+};
+
+#endif
+
+/* vim:set shiftwidth=4 softtabstop=4 noexpandtab: */
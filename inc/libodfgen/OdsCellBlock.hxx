@@ -0,0 +1,82 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* libodfgen
+ * Version: MPL 2.0 / LGPLv2.1+
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU Lesser General Public License Version 2.1 or later
+ * (LGPLv2.1+), in which case the provisions of the LGPLv2.1+ are
+ * applicable instead of those above.
+ *
+ * For further information visit http://libwpd.sourceforge.net
+ */
+
+#ifndef _ODSCELLBLOCK_HXX_
+#define _ODSCELLBLOCK_HXX_
+
+#include "libodfgen-api.hxx"
+
+class OdsCellBlockPrivate;
+
+/** A rectangular block of cells sent to a spreadsheet in one call.
+  *
+  * The values are given column by column: each column is an array
+  * which contains one value by row. The arrays are not copied, so they
+  * must stay valid until the block is given to
+  * OdsGenerator::insertSheetCellBlock.
+  */
+class ODFGENAPI OdsCellBlock
+{
+public:
+	//! the type of the values of a column
+	enum ValueType { Empty, Float, String, Boolean, Date };
+
+	//! creates a block of numRows rows and no column
+	explicit OdsCellBlock(unsigned numRows);
+	~OdsCellBlock();
+
+	//! returns the number of rows
+	unsigned getNumRows() const;
+	//! returns the number of columns
+	unsigned getNumColumns() const;
+	//! removes all the columns
+	void clear();
+
+	//! adds a column of empty cells
+	void addEmptyColumn();
+	//! adds a column of numbers: a NaN value creates an empty cell
+	void addFloatColumn(const double *values);
+	//! adds a column of strings: a null string creates an empty cell
+	void addStringColumn(const char *const *values);
+	//! adds a column of booleans
+	void addBooleanColumn(const bool *values);
+	/** adds a column of dates: each value is a ISO 8601 date or date-time,
+	  * e.g. "2015-02-28" or "2015-02-28T12:30:00", a null string creates
+	  * an empty cell.
+	  */
+	void addDateColumn(const char *const *values);
+
+	//! returns the type of a column
+	ValueType getColumnType(unsigned column) const;
+	//! returns the values of a Float column or 0
+	const double *getFloatValues(unsigned column) const;
+	//! returns the values of a String or Date column or 0
+	const char *const *getStringValues(unsigned column) const;
+	//! returns the values of a Boolean column or 0
+	const bool *getBooleanValues(unsigned column) const;
+
+private:
+	OdsCellBlock(OdsCellBlock const &);
+	OdsCellBlock &operator=(OdsCellBlock const &);
+
+	OdsCellBlockPrivate *mpImpl;
+};
+
+#endif
+
+/* vim:set shiftwidth=4 softtabstop=4 noexpandtab: */
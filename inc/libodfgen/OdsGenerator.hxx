@@ -31,6 +31,8 @@
 
 #include "libodfgen-api.hxx"
 #include "OdfDocumentHandler.hxx"
+#include "OdfPackageWriter.hxx"
+#include "OdsCellBlock.hxx"
 
 class OdfGenerator;
 class OdsGeneratorPrivate;
@@ -52,6 +54,90 @@ public:
 	librevenge::RVNGStringVector getObjectNames() const;
 	/** retrieve an embedded object content via a document handler */
 	bool getObjectContent(librevenge::RVNGString const &objectName, OdfDocumentHandler *pHandler);
+	/** returns the names of the pictures stored in separate files, see
+		setExternalPictures */
+	librevenge::RVNGStringVector getPictureNames() const;
+	//! retrieves the content and the mime type of a picture stored in a separate file
+	bool getPictureContent(librevenge::RVNGString const &name, librevenge::RVNGBinaryData &data, librevenge::RVNGString &mimeType) const;
+	/** asks to spool the content.xml body: the body elements are moved in a
+		temporary file as soon as they use more than 1 MiB instead of being kept
+		in memory until endDocument, so the memory used no longer depends on the
+		document size. At the end of the document, the automatic styles are
+		written in content.xml, then the body is read back from the file, so the
+		files created are the same as without this mode. It must be called
+		before startDocument.
+	 */
+	void setContentStreaming(bool stream);
+	/** asks to write the whole document in an ODF package: the mimetype,
+		the XML files, the embedded objects and the manifest are written in
+		pWriter at the end of the document, and the package is closed. In this
+		mode, the registered document handlers are not used. It must be called
+		before startDocument.
+	 */
+	void setPackageWriter(OdfPackageWriter *pWriter);
+	/** asks to write the different files of the document in parallel at the
+		end of the document when the library is built with thread support:
+		each registered document handler is then called from only one
+		thread, but not necessarily from the calling thread, and the handlers
+		must be distinct. With a package writer, the XML files are created in
+		memory in parallel, then added in the package. Without a package
+		writer, the files are written sequentially when the body has been
+		moved in a temporary file, see setContentStreaming.
+	 */
+	void setParallelWriting(bool parallel);
+	/** asks to store the images in separate files of the package
+		(Pictures/<hash>.<ext>) referenced by xlink:href instead of inlining
+		them in office:binary-data. It is ignored if an ODF_FLAT_XML handler
+		is registered. The pictures are listed in the manifest; with a
+		package writer, they are written in the package, otherwise they
+		must be retrieved with getPictureNames and getPictureContent. It
+		must be called before startDocument.
+	 */
+	void setExternalPictures(bool external);
+	/** asks to delay the conversions done by the embedded image handlers:
+		the images are stored unconverted and the conversions are run when
+		the document is written, in parallel when the library is built with
+		thread support, so the registered image handlers must be reentrant.
+	 */
+	void setAsynchronousImageConversion(bool async);
+	/** sets the maximal number of embedded objects converted by the
+		registered object handlers which are kept in a cache (16 by default):
+		when the same object data are inserted again, the converted object is
+		reused instead of calling the handler. 0 disables the cache.
+	 */
+	void setEmbeddedObjectCacheSize(unsigned size);
+	//! returns the number of embedded objects found and not found in the cache
+	void getEmbeddedObjectCacheStatistics(unsigned long &hits, unsigned long &misses) const;
+	/** returns the number of styles found and not found in the small caches
+		of the last used styles, which avoid looking up the style tables */
+	void getStyleCacheStatistics(unsigned long &hits, unsigned long &misses) const;
+	/** asks to move each sheet in a temporary file when it is closed, so
+		that the memory used by the document content only depends on the
+		largest sheet: the sheets are read back from the file at the end of
+		the document. With setContentStreaming, the sheets are also moved in
+		the temporary file while they are created.
+	 */
+	void setSheetSpilling(bool spill);
+	/** asks to share the row and the cell styles between all the sheets,
+		so that an identical style used in many sheets is only created and
+		written once. By default, each sheet has its own styles. It must be
+		called before opening the first sheet.
+	 */
+	void setSheetStyleSharing(bool share);
+	/** asks to accept the sheet rows and cells in any order: the cells
+		are stored in a sparse index sorted by row and column and the sheet
+		content is sent in closeSheet, with the identical consecutive cells
+		and rows merged. A cell sent twice replaces the previous one. It
+		must be called before opening the sheets.
+	 */
+	void setSheetRandomOrder(bool randomOrder);
+	/** asks to store only once the cell texts which contain at least
+		minLength bytes: each cell keeps a reference to a shared copy of
+		its text, which saves memory when the same texts are repeated in
+		many cells. 0 (the default) means that each text is stored in its
+		cell. The output is not changed.
+	 */
+	void setTextInterning(unsigned minLength);
 
 	void setDocumentMetaData(const librevenge::RVNGPropertyList &propList);
 	void startDocument(const librevenge::RVNGPropertyList &);
@@ -79,6 +165,16 @@ public:
 	void closeSheetRow();
 	void openSheetCell(const librevenge::RVNGPropertyList &propList);
 	void closeSheetCell();
+	/** inserts a block of rows in the current sheet: this is equivalent to
+		calling openSheetRow with rowPropList, then openSheetCell with
+		cellPropList and the cell value and closeSheetCell for each cell and
+		closeSheetRow for each row of the block, but the row and the cell
+		styles are created only once. It must be called outside a row. The
+		position of the block can be set with librevenge:row in rowPropList
+		and librevenge:column in cellPropList.
+	 */
+	void insertSheetCellBlock(const librevenge::RVNGPropertyList &rowPropList,
+	                          const librevenge::RVNGPropertyList &cellPropList, const OdsCellBlock &block);
 
 	void defineChartStyle(const librevenge::RVNGPropertyList &propList);
 	void openChart(const librevenge::RVNGPropertyList &propList);
@@ -26,8 +26,11 @@
 #include <librevenge/librevenge.h>
 
 #include "OdfDocumentHandler.hxx"
+#include "OdfPackageWriter.hxx"
+#include "OdfXMLWriter.hxx"
 #include "OdgGenerator.hxx"
 #include "OdpGenerator.hxx"
+#include "OdsCellBlock.hxx"
 #include "OdsGenerator.hxx"
 #include "OdtGenerator.hxx"
 
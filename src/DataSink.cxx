@@ -0,0 +1,122 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* libodfgen
+ * Version: MPL 2.0 / LGPLv2.1+
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU Lesser General Public License Version 2.1 or later
+ * (LGPLv2.1+), in which case the provisions of the LGPLv2.1+ are
+ * applicable instead of those above.
+ *
+ * For further information visit http://libwpd.sourceforge.net
+ */
+
+#include <errno.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "DataSink.hxx"
+
+#include "FilterInternal.hxx"
+
+namespace libodfgen
+{
+DataSink::DataSink() : mOutput(O_Memory), mpFile(0), miFileDescriptor(-1), mpCallback(0), mpUserData(0),
+	mBuffer(4096), mSize(0), mFlushedSize(0), mbError(false)
+{
+}
+
+DataSink::DataSink(FILE *file) : mOutput(O_File), mpFile(file), miFileDescriptor(-1), mpCallback(0), mpUserData(0),
+	mBuffer(65536), mSize(0), mFlushedSize(0), mbError(false)
+{
+}
+
+DataSink::DataSink(int fd) : mOutput(O_FileDescriptor), mpFile(0), miFileDescriptor(fd), mpCallback(0), mpUserData(0),
+	mBuffer(65536), mSize(0), mFlushedSize(0), mbError(false)
+{
+}
+
+DataSink::DataSink(OdfXMLWriterCallback callback, void *userData) : mOutput(O_Callback), mpFile(0), miFileDescriptor(-1),
+	mpCallback(callback), mpUserData(userData), mBuffer(65536), mSize(0), mFlushedSize(0), mbError(false)
+{
+}
+
+DataSink::~DataSink()
+{
+	flush();
+}
+
+void DataSink::reserve(size_t length)
+{
+	if (mOutput!=O_Memory)
+	{
+		flush();
+		if (mSize+length <= mBuffer.size())
+			return;
+	}
+	size_t newSize=2*mBuffer.size();
+	if (newSize<mSize+length)
+		newSize=mSize+length;
+	mBuffer.resize(newSize);
+}
+
+void DataSink::flush()
+{
+	if (mOutput==O_Memory || !mSize)
+		return;
+	if (!mbError && !write(&mBuffer[0], mSize))
+	{
+		ODFGEN_DEBUG_MSG(("DataSink::flush: can not write the data\n"));
+		mbError=true;
+	}
+	mFlushedSize+=(unsigned long) mSize;
+	mSize=0;
+	if (!mbError && mOutput==O_File && fflush(mpFile)!=0)
+	{
+		ODFGEN_DEBUG_MSG(("DataSink::flush: can not flush the file\n"));
+		mbError=true;
+	}
+}
+
+bool DataSink::write(const char *data, size_t length)
+{
+	switch (mOutput)
+	{
+	case O_File:
+		return mpFile && fwrite(data, 1, length, mpFile)==length;
+	case O_FileDescriptor:
+		while (length)
+		{
+#ifdef _WIN32
+			int const written=_write(miFileDescriptor, data, unsigned(length));
+#else
+			ssize_t const written=::write(miFileDescriptor, data, length);
+#endif
+			if (written<0 && errno==EINTR)
+				continue;
+			if (written<=0)
+				return false;
+			data+=written;
+			length-=size_t(written);
+		}
+		return true;
+	case O_Callback:
+		return mpCallback && mpCallback(data, (unsigned long) length, mpUserData);
+	case O_Memory:
+	default:
+		break;
+	}
+	return true;
+}
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 noexpandtab: */
@@ -0,0 +1,119 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* libodfgen
+ * Version: MPL 2.0 / LGPLv2.1+
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU Lesser General Public License Version 2.1 or later
+ * (LGPLv2.1+), in which case the provisions of the LGPLv2.1+ are
+ * applicable instead of those above.
+ *
+ * For further information visit http://libwpd.sourceforge.net
+ */
+
+#ifndef _DATASINK_HXX_
+#define _DATASINK_HXX_
+
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include <libodfgen/libodfgen.hxx>
+
+namespace libodfgen
+{
+/** small class used to send data to an output: a FILE, a file descriptor or
+	a callback. The data are accumulated in a buffer which is sent to the
+	output when it is full; without output, all the data are kept in memory.
+ */
+class DataSink
+{
+public:
+	//! creates a sink which keeps the data in memory
+	DataSink();
+	//! creates a sink which writes in a file
+	explicit DataSink(FILE *file);
+	//! creates a sink which writes in a file descriptor
+	explicit DataSink(int fd);
+	//! creates a sink which sends the data to a callback
+	DataSink(OdfXMLWriterCallback callback, void *userData);
+	//! destructor: sends the remaining data to the output
+	~DataSink();
+
+	//! adds data
+	void append(const char *data, size_t length)
+	{
+		if (mSize+length > mBuffer.size())
+			reserve(length);
+		if (length)
+			memcpy(&mBuffer[0]+mSize, data, length);
+		mSize+=length;
+	}
+	//! adds a 0 terminated string
+	void append(const char *data)
+	{
+		append(data, strlen(data));
+	}
+	//! sends the buffered data to the output (does nothing for a memory sink)
+	void flush();
+	//! returns the data which are not yet sent to the output
+	const char *getData() const
+	{
+		return mSize ? &mBuffer[0] : "";
+	}
+	//! returns the size of the data which are not yet sent to the output
+	size_t getDataSize() const
+	{
+		return mSize;
+	}
+	//! returns the number of bytes added since the creation
+	unsigned long getPosition() const
+	{
+		return mFlushedSize+(unsigned long) mSize;
+	}
+	//! returns true if some data could not be sent to the output
+	bool hasError() const
+	{
+		return mbError;
+	}
+
+private:
+	DataSink(DataSink const &);
+	DataSink &operator=(DataSink const &);
+
+	//! the different outputs
+	enum Output { O_Memory, O_File, O_FileDescriptor, O_Callback };
+	//! makes room for length bytes in the buffer
+	void reserve(size_t length);
+	//! sends data to the output
+	bool write(const char *data, size_t length);
+
+	//! the output
+	Output mOutput;
+	//! the file
+	FILE *mpFile;
+	//! the file descriptor
+	int miFileDescriptor;
+	//! the callback
+	OdfXMLWriterCallback mpCallback;
+	//! the callback data
+	void *mpUserData;
+	//! the buffer
+	std::vector<char> mBuffer;
+	//! the used size of the buffer
+	size_t mSize;
+	//! the number of bytes already sent to the output
+	unsigned long mFlushedSize;
+	//! true if some data could not be written
+	bool mbError;
+};
+}
+
+#endif
+/* vim:set shiftwidth=4 softtabstop=4 noexpandtab: */
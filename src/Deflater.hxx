@@ -0,0 +1,101 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* libodfgen
+ * Version: MPL 2.0 / LGPLv2.1+
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU Lesser General Public License Version 2.1 or later
+ * (LGPLv2.1+), in which case the provisions of the LGPLv2.1+ are
+ * applicable instead of those above.
+ *
+ * For further information visit http://libwpd.sourceforge.net
+ */
+
+#ifndef _DEFLATER_HXX_
+#define _DEFLATER_HXX_
+
+#include <stddef.h>
+
+#include <vector>
+
+namespace libodfgen
+{
+class DataSink;
+
+//! returns the CRC-32 of data, crc being the CRC-32 of the previous data (or 0)
+unsigned long updateCRC32(unsigned long crc, const unsigned char *data, size_t length);
+
+/** small deflate (RFC 1951) compressor used to create zip files
+
+	The data are compressed with a LZ77 matcher on a 32 KB sliding window
+	and encoded with the fixed Huffman codes, so no external library is
+	needed. The compressed data are appended to a DataSink.
+ */
+class Deflater
+{
+public:
+	//! constructor
+	explicit Deflater(DataSink &sink);
+	//! compresses data
+	void write(const unsigned char *data, size_t length);
+	//! compresses the remaining data and ends the compressed stream
+	void finish();
+	//! returns the number of compressed bytes sent to the sink
+	unsigned long getCompressedSize() const
+	{
+		return mCompressedSize;
+	}
+
+private:
+	Deflater(Deflater const &);
+	Deflater &operator=(Deflater const &);
+
+	//! compresses the window data, keeping the last bytes if finish is false
+	void compress(bool finish);
+	//! moves the second half of the window in the first half
+	void slideWindow();
+	//! inserts the string starting at pos in the hash table
+	void insertString(size_t pos);
+	//! adds numBits bits (least significant bits first)
+	void writeBits(unsigned value, int numBits);
+	//! adds a Huffman code (most significant bits first)
+	void writeCode(unsigned code, int numBits);
+	//! adds a literal or an end of block
+	void writeSymbol(unsigned symbol);
+	//! adds a length/distance pair
+	void writeMatch(unsigned length, unsigned distance);
+	//! sends the output buffer to the sink
+	void flushOutput();
+
+	//! the sink
+	DataSink &mSink;
+	//! the window: the previous data followed by the data to compress
+	std::vector<unsigned char> mWindow;
+	//! the position of the first data to compress in the window
+	size_t mPosition;
+	//! the end of the data in the window
+	size_t mEnd;
+	//! the last position of each hash value (or -1)
+	std::vector<int> mHead;
+	//! the previous position with the same hash value (or -1)
+	std::vector<int> mPrevious;
+	//! the pending bits
+	unsigned long mBitBuffer;
+	//! the number of pending bits
+	int mNumBits;
+	//! the compressed bytes which are not yet sent to the sink
+	std::vector<char> mOutput;
+	//! the number of bytes in mOutput
+	size_t mOutputSize;
+	//! the number of compressed bytes
+	unsigned long mCompressedSize;
+};
+}
+
+#endif
+/* vim:set shiftwidth=4 softtabstop=4 noexpandtab: */
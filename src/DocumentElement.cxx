@@ -29,12 +29,18 @@
 
 void TagElement::print() const
 {
-	ODFGEN_DEBUG_MSG(("%s\n", msTagName.cstr()));
+	ODFGEN_DEBUG_MSG(("%s\n", getTagName()));
 }
 
 void TagOpenElement::write(OdfDocumentHandler *pHandler) const
 {
-	pHandler->startElement(getTagName().cstr(), maAttrList);
+	char const *pos=maAttributes.data();
+	libodfgen::sendOpenElement(pHandler, dynamic_cast<OdfFastDocumentHandler *>(pHandler), getTagName(), pos, maAttributes.size());
+}
+
+void TagOpenElement::appendTo(libodfgen::DocumentElementVector &storage) const
+{
+	storage.addOpenElement(getTagName(), maAttributes, getTagAtom());
 }
 
 void TagOpenElement::print() const
@@ -42,20 +48,22 @@ void TagOpenElement::print() const
 	TagElement::print();
 }
 
-void TagOpenElement::addAttribute(const librevenge::RVNGString &szAttributeName,
-                                  const librevenge::RVNGString &sAttributeValue, bool forceString)
+void TagOpenElement::addAttribute(const librevenge::RVNGString &szAttributeName, const librevenge::RVNGString &sAttributeValue)
 {
-	if (forceString)
-		maAttrList.insert(szAttributeName.cstr(), librevenge::RVNGPropertyFactory::newStringProp(sAttributeValue));
-	else
-		maAttrList.insert(szAttributeName.cstr(), sAttributeValue);
+	// the attributes are always stored as strings
+	maAttributes.insert(szAttributeName.cstr(), sAttributeValue.cstr(), sAttributeValue.size());
 }
 
 void TagCloseElement::write(OdfDocumentHandler *pHandler) const
 {
-	ODFGEN_DEBUG_MSG(("TagCloseElement: write (%s)\n", getTagName().cstr()));
+	ODFGEN_DEBUG_MSG(("TagCloseElement: write (%s)\n", getTagName()));
 
-	pHandler->endElement(getTagName().cstr());
+	pHandler->endElement(getTagName());
+}
+
+void TagCloseElement::appendTo(libodfgen::DocumentElementVector &storage) const
+{
+	storage.addCloseElement(getTagName(), getTagAtom());
 }
 
 void CharDataElement::write(OdfDocumentHandler *pHandler) const
@@ -64,6 +72,33 @@ void CharDataElement::write(OdfDocumentHandler *pHandler) const
 	pHandler->characters(msData);
 }
 
+void CharDataElement::appendTo(libodfgen::DocumentElementVector &storage) const
+{
+	storage.addCharacters(msData);
+}
+
+void BinaryDataElement::write(OdfDocumentHandler *pHandler) const
+{
+	libodfgen::sendBase64Data(pHandler, dynamic_cast<OdfFastDocumentHandler *>(pHandler), mData);
+}
+
+void BinaryDataElement::appendTo(libodfgen::DocumentElementVector &storage) const
+{
+	storage.addBinaryData(mData);
+}
+
+void SharedStorageElement::write(OdfDocumentHandler *pHandler) const
+{
+	if (mStorage)
+		mStorage->write(pHandler);
+}
+
+void SharedStorageElement::appendTo(libodfgen::DocumentElementVector &storage) const
+{
+	if (mStorage)
+		mStorage->appendTo(storage);
+}
+
 void TextElement::write(OdfDocumentHandler *pHandler) const
 {
 	if (msTextBuf.len() <= 0)
@@ -71,4 +106,11 @@ void TextElement::write(OdfDocumentHandler *pHandler) const
 	pHandler->characters(msTextBuf);
 }
 
+void TextElement::appendTo(libodfgen::DocumentElementVector &storage) const
+{
+	if (msTextBuf.len() <= 0)
+		return;
+	storage.addCharacters(msTextBuf);
+}
+
 /* vim:set shiftwidth=4 softtabstop=4 noexpandtab: */
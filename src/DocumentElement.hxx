@@ -30,11 +30,16 @@
 #include <librevenge/librevenge.h>
 #include <libodfgen/libodfgen.hxx>
 
+#include "FilterInternal.hxx"
+#include "NameTable.hxx"
+
 class DocumentElement
 {
 public:
 	virtual ~DocumentElement() {}
 	virtual void write(OdfDocumentHandler *pHandler) const = 0;
+	//! stores the element at the end of a storage
+	virtual void appendTo(libodfgen::DocumentElementVector &storage) const = 0;
 	virtual void print() const {}
 };
 
@@ -42,27 +47,63 @@ class TagElement : public DocumentElement
 {
 public:
 	virtual ~TagElement() {}
-	TagElement(const librevenge::RVNGString &szTagName) : msTagName(szTagName) {}
-	const librevenge::RVNGString &getTagName() const
+	TagElement(const librevenge::RVNGString &szTagName)
+		: miTagAtom(libodfgen::NameTable::getAtom(szTagName.cstr())), msTagName(miTagAtom ? "" : szTagName) {}
+	//! returns the tag name
+	char const *getTagName() const
+	{
+		return miTagAtom ? libodfgen::NameTable::getName(miTagAtom) : msTagName.cstr();
+	}
+	//! returns the tag name atom (or 0 if the name is not in the name table)
+	unsigned short getTagAtom() const
 	{
-		return msTagName;
+		return miTagAtom;
 	}
 	virtual void print() const;
 private:
+	//! the name atom
+	unsigned short miTagAtom;
+	//! the name if it is not in the name table
 	librevenge::RVNGString msTagName;
 };
 
 class TagOpenElement : public TagElement
 {
 public:
-	TagOpenElement(const librevenge::RVNGString &szTagName) : TagElement(szTagName), maAttrList() {}
+	TagOpenElement(const librevenge::RVNGString &szTagName) : TagElement(szTagName), maAttributes() {}
 	virtual ~TagOpenElement() {}
-	void addAttribute(const librevenge::RVNGString &szAttributeName,
-	                  const librevenge::RVNGString &sAttributeValue, bool forceString=true);
+	void addAttribute(const librevenge::RVNGString &szAttributeName, const librevenge::RVNGString &sAttributeValue);
+	//! adds an attribute without creating intermediate strings
+	void addAttribute(const char *szAttributeName, const char *sAttributeValue)
+	{
+		maAttributes.insert(szAttributeName, sAttributeValue);
+	}
+	//! adds an attribute without creating an intermediate name string
+	void addAttribute(const char *szAttributeName, const librevenge::RVNGString &sAttributeValue)
+	{
+		maAttributes.insert(szAttributeName, sAttributeValue.cstr(), sAttributeValue.size());
+	}
+	//! adds an attribute whose value is already escaped for XML, so that it is not escaped again
+	void addEscapedAttribute(const char *szAttributeName, const librevenge::RVNGString &sAttributeValue)
+	{
+		maAttributes.insert(szAttributeName, sAttributeValue.cstr(), sAttributeValue.size(), true);
+	}
+	//! adds an attribute given as a character array, escaped must be set if the value is already escaped
+	void addAttribute(const char *szAttributeName, const char *sAttributeValue, size_t length, bool escaped)
+	{
+		maAttributes.insert(szAttributeName, sAttributeValue, length, escaped);
+	}
+	//! returns the attributes
+	libodfgen::AttributeVector const &getAttributes() const
+	{
+		return maAttributes;
+	}
 	virtual void write(OdfDocumentHandler *pHandler) const;
+	virtual void appendTo(libodfgen::DocumentElementVector &storage) const;
 	virtual void print() const;
 private:
-	librevenge::RVNGPropertyList maAttrList;
+	//! the attributes
+	libodfgen::AttributeVector maAttributes;
 };
 
 class TagCloseElement : public TagElement
@@ -71,6 +112,7 @@ public:
 	TagCloseElement(const librevenge::RVNGString &szTagName) : TagElement(szTagName) {}
 	virtual ~TagCloseElement() {}
 	virtual void write(OdfDocumentHandler *pHandler) const;
+	virtual void appendTo(libodfgen::DocumentElementVector &storage) const;
 };
 
 class CharDataElement : public DocumentElement
@@ -79,16 +121,42 @@ public:
 	CharDataElement(const librevenge::RVNGString &sData) : DocumentElement(), msData(sData) {}
 	virtual ~CharDataElement() {}
 	virtual void write(OdfDocumentHandler *pHandler) const;
+	virtual void appendTo(libodfgen::DocumentElementVector &storage) const;
 private:
 	librevenge::RVNGString msData;
 };
 
+//! a binary data which is written encoded in base64
+class BinaryDataElement : public DocumentElement
+{
+public:
+	BinaryDataElement(const librevenge::RVNGBinaryData &data) : DocumentElement(), mData(data) {}
+	virtual ~BinaryDataElement() {}
+	virtual void write(OdfDocumentHandler *pHandler) const;
+	virtual void appendTo(libodfgen::DocumentElementVector &storage) const;
+private:
+	librevenge::RVNGBinaryData mData;
+};
+
+//! a storage shared by several documents parts, which is written in place
+class SharedStorageElement : public DocumentElement
+{
+public:
+	SharedStorageElement(shared_ptr<libodfgen::DocumentElementVector const> const &storage) : DocumentElement(), mStorage(storage) {}
+	virtual ~SharedStorageElement() {}
+	virtual void write(OdfDocumentHandler *pHandler) const;
+	virtual void appendTo(libodfgen::DocumentElementVector &storage) const;
+private:
+	shared_ptr<libodfgen::DocumentElementVector const> mStorage;
+};
+
 class TextElement : public DocumentElement
 {
 public:
 	TextElement(const librevenge::RVNGString &sTextBuf) : DocumentElement(), msTextBuf(sTextBuf) {}
 	virtual ~TextElement() {}
 	virtual void write(OdfDocumentHandler *pHandler) const;
+	virtual void appendTo(libodfgen::DocumentElementVector &storage) const;
 
 private:
 	librevenge::RVNGString msTextBuf;
@@ -17,16 +17,24 @@
 #include "DocumentElement.hxx"
 
 #include "FilterInternal.hxx"
+#include "NameTable.hxx"
 
+#include <locale.h>
+#include <math.h>
+#include <stdlib.h>
+#if !defined(_MSC_VER) || _MSC_VER>=1600
+#include <stdint.h>
+#endif
+
+#include <algorithm>
 #include <cstdarg>
 #include <cstdio>
+#include <cstring>
+#include <limits>
 
 librevenge::RVNGString libodfgen::doubleToString(const double value)
 {
-	librevenge::RVNGProperty *prop = librevenge::RVNGPropertyFactory::newDoubleProp(value);
-	librevenge::RVNGString retVal = prop->getStr();
-	delete prop;
-	return retVal;
+	return librevenge::RVNGString(NumberString().setDouble(value).cstr());
 }
 
 bool libodfgen::getInchValue(librevenge::RVNGProperty const &prop, double &value)
@@ -61,29 +69,1096 @@ bool libodfgen::getInchValue(librevenge::RVNGProperty const &prop, double &value
 
 namespace libodfgen
 {
+AttributeVector::AttributeVector(const AttributeVector &orig)
+	: mpData(mInlineData), mSize(0), mCapacity(sizeof(mInlineData)), mNumAttributes(0), mInlineData()
+{
+	*this=orig;
+}
+
+AttributeVector &AttributeVector::operator=(const AttributeVector &orig)
+{
+	if (this==&orig)
+		return *this;
+	clear();
+	if (orig.mSize)
+		memcpy(reserve(orig.mSize), orig.mpData, orig.mSize);
+	mNumAttributes=orig.mNumAttributes;
+	return *this;
+}
+
+char *AttributeVector::reserve(size_t size)
+{
+	if (mSize+size > mCapacity)
+	{
+		size_t capacity=2*mCapacity;
+		if (capacity<mSize+size)
+			capacity=mSize+size;
+		char *data=new char[capacity];
+		if (mSize)
+			memcpy(data, mpData, mSize);
+		if (mpData!=mInlineData)
+			delete [] mpData;
+		mpData=data;
+		mCapacity=capacity;
+	}
+	char *res=mpData+mSize;
+	mSize+=size;
+	return res;
+}
+
+void AttributeVector::insert(char const *name, char const *value, size_t valueLength, bool escaped)
+{
+	unsigned short const atom=NameTable::getAtom(name);
+	/* the attributes are kept sorted by name, so they are sent in the
+	   same order as the property list entries; look for the insertion
+	   position and remove the previous value if it exists */
+	size_t insertPos=mSize;
+	char const *pos=mpData;
+	for (unsigned i=0; i<mNumAttributes; ++i)
+	{
+		char const *start=pos;
+		char const *key=readName(pos);
+		pos+=strlen(pos)+1;
+		int const cmp=(atom && key==NameTable::getName(atom)) ? 0 : strcmp(key, name);
+		if (cmp<0)
+			continue;
+		insertPos=size_t(start-mpData);
+		if (cmp==0)
+		{
+			memmove(mpData+insertPos, pos, size_t(mpData+mSize-pos));
+			mSize-=size_t(pos-start);
+			--mNumAttributes;
+		}
+		break;
+	}
+	size_t const size=getNameSize(name, atom)+valueLength+1;
+	reserve(size);
+	char *buffer=mpData+insertPos;
+	if (insertPos+size<mSize)
+		memmove(buffer+size, buffer, mSize-size-insertPos);
+	char *nameStart=buffer;
+	buffer=writeName(buffer, name, atom);
+	if (escaped)
+	{
+		unsigned short const flaggedAtom=(unsigned short)(atom|EscapedBit);
+		memcpy(nameStart, &flaggedAtom, sizeof(unsigned short));
+	}
+	if (valueLength)
+		memcpy(buffer, value, valueLength);
+	buffer[valueLength]=0;
+	++mNumAttributes;
+}
+
+void AttributeVector::addTo(librevenge::RVNGPropertyList &list) const
+{
+	char const *pos=mpData;
+	readAttributes(pos, mNumAttributes, list);
+}
+
+char *AttributeVector::writeName(char *buffer, char const *name, unsigned short atom)
+{
+	memcpy(buffer, &atom, sizeof(unsigned short));
+	buffer+=sizeof(unsigned short);
+	if (atom)
+		return buffer;
+	size_t const len=strlen(name)+1;
+	memcpy(buffer, name, len);
+	return buffer+len;
+}
+
+char const *AttributeVector::readName(char const *&pos)
+{
+	unsigned short atom;
+	memcpy(&atom, pos, sizeof(unsigned short));
+	pos+=sizeof(unsigned short);
+	atom&=(unsigned short)~EscapedBit;
+	if (atom)
+		return NameTable::getName(atom);
+	char const *name=pos;
+	pos+=strlen(pos)+1;
+	return name;
+}
+
+void AttributeVector::readAttributes(char const *&pos, unsigned numAttributes, librevenge::RVNGPropertyList &list)
+{
+	for (unsigned i=0; i<numAttributes; ++i)
+	{
+		char const *key=readName(pos);
+		list.insert(key, librevenge::RVNGPropertyFactory::newStringProp(pos));
+		pos+=strlen(pos)+1;
+	}
+}
+
+namespace
+{
+/* the shortest decimal text of a double is computed with the Grisu2
+   algorithm of F. Loitsch, "Printing Floating-Point Numbers Quickly and
+   Accurately with Integers" (2010): the digits are always read back as
+   the original value and are the shortest ones for almost all values */
+#if defined(_MSC_VER) && _MSC_VER<1600
+typedef unsigned __int64 UInt64;
+#else
+typedef uint64_t UInt64;
+#endif
+
+inline UInt64 makeUInt64(unsigned high, unsigned low)
+{
+	return (UInt64(high)<<32) | UInt64(low);
+}
+
+//! a floating point number f*2^e with a 64 bits significand
+struct DiyFp
+{
+	DiyFp(UInt64 f, int e) : mF(f), mE(e)
+	{
+	}
+	//! the difference of two numbers with the same exponent
+	DiyFp operator-(DiyFp const &other) const
+	{
+		return DiyFp(mF-other.mF, mE);
+	}
+	//! the product of two numbers, rounded to 64 bits
+	DiyFp operator*(DiyFp const &other) const
+	{
+		UInt64 const mask=0xffffffffU;
+		UInt64 const a=mF>>32, b=mF&mask, c=other.mF>>32, d=other.mF&mask;
+		UInt64 const ac=a*c, bc=b*c, ad=a*d, bd=b*d;
+		UInt64 tmp=(bd>>32)+(ad&mask)+(bc&mask);
+		tmp+=UInt64(1)<<31;
+		return DiyFp(ac+(ad>>32)+(bc>>32)+(tmp>>32), mE+other.mE+64);
+	}
+	//! the significand
+	UInt64 mF;
+	//! the exponent
+	int mE;
+};
+
+//! shifts a number until the bit 63 of its significand is set
+DiyFp normalize(DiyFp value)
+{
+	while (!(value.mF & (UInt64(1)<<63)))
+	{
+		value.mF<<=1;
+		--value.mE;
+	}
+	return value;
+}
+
+/** returns the normalized 10^-K which brings a number with exponent e
+	in the range used to generate the digits and sets K */
+DiyFp getCachedPower(int e, int &K)
+{
+	// 10^k for k=-348, -340, ..., 340
+	static struct
+	{
+		unsigned mHigh, mLow;
+		int mExponent;
+	} const powers[]=
+	{
+		{ 0xfa8fd5a0U, 0x081c0288U, -1220 },
+		{ 0xbaaee17fU, 0xa23ebf76U, -1193 },
+		{ 0x8b16fb20U, 0x3055ac76U, -1166 },
+		{ 0xcf42894aU, 0x5dce35eaU, -1140 },
+		{ 0x9a6bb0aaU, 0x55653b2dU, -1113 },
+		{ 0xe61acf03U, 0x3d1a45dfU, -1087 },
+		{ 0xab70fe17U, 0xc79ac6caU, -1060 },
+		{ 0xff77b1fcU, 0xbebcdc4fU, -1034 },
+		{ 0xbe5691efU, 0x416bd60cU, -1007 },
+		{ 0x8dd01fadU, 0x907ffc3cU, -980 },
+		{ 0xd3515c28U, 0x31559a83U, -954 },
+		{ 0x9d71ac8fU, 0xada6c9b5U, -927 },
+		{ 0xea9c2277U, 0x23ee8bcbU, -901 },
+		{ 0xaecc4991U, 0x4078536dU, -874 },
+		{ 0x823c1279U, 0x5db6ce57U, -847 },
+		{ 0xc2109436U, 0x4dfb5637U, -821 },
+		{ 0x9096ea6fU, 0x3848984fU, -794 },
+		{ 0xd77485cbU, 0x25823ac7U, -768 },
+		{ 0xa086cfcdU, 0x97bf97f4U, -741 },
+		{ 0xef340a98U, 0x172aace5U, -715 },
+		{ 0xb23867fbU, 0x2a35b28eU, -688 },
+		{ 0x84c8d4dfU, 0xd2c63f3bU, -661 },
+		{ 0xc5dd4427U, 0x1ad3cdbaU, -635 },
+		{ 0x936b9fceU, 0xbb25c996U, -608 },
+		{ 0xdbac6c24U, 0x7d62a584U, -582 },
+		{ 0xa3ab6658U, 0x0d5fdaf6U, -555 },
+		{ 0xf3e2f893U, 0xdec3f126U, -529 },
+		{ 0xb5b5ada8U, 0xaaff80b8U, -502 },
+		{ 0x87625f05U, 0x6c7c4a8bU, -475 },
+		{ 0xc9bcff60U, 0x34c13053U, -449 },
+		{ 0x964e858cU, 0x91ba2655U, -422 },
+		{ 0xdff97724U, 0x70297ebdU, -396 },
+		{ 0xa6dfbd9fU, 0xb8e5b88fU, -369 },
+		{ 0xf8a95fcfU, 0x88747d94U, -343 },
+		{ 0xb9447093U, 0x8fa89bcfU, -316 },
+		{ 0x8a08f0f8U, 0xbf0f156bU, -289 },
+		{ 0xcdb02555U, 0x653131b6U, -263 },
+		{ 0x993fe2c6U, 0xd07b7facU, -236 },
+		{ 0xe45c10c4U, 0x2a2b3b06U, -210 },
+		{ 0xaa242499U, 0x697392d3U, -183 },
+		{ 0xfd87b5f2U, 0x8300ca0eU, -157 },
+		{ 0xbce50864U, 0x92111aebU, -130 },
+		{ 0x8cbccc09U, 0x6f5088ccU, -103 },
+		{ 0xd1b71758U, 0xe219652cU, -77 },
+		{ 0x9c400000U, 0x00000000U, -50 },
+		{ 0xe8d4a510U, 0x00000000U, -24 },
+		{ 0xad78ebc5U, 0xac620000U, 3 },
+		{ 0x813f3978U, 0xf8940984U, 30 },
+		{ 0xc097ce7bU, 0xc90715b3U, 56 },
+		{ 0x8f7e32ceU, 0x7bea5c70U, 83 },
+		{ 0xd5d238a4U, 0xabe98068U, 109 },
+		{ 0x9f4f2726U, 0x179a2245U, 136 },
+		{ 0xed63a231U, 0xd4c4fb27U, 162 },
+		{ 0xb0de6538U, 0x8cc8ada8U, 189 },
+		{ 0x83c7088eU, 0x1aab65dbU, 216 },
+		{ 0xc45d1df9U, 0x42711d9aU, 242 },
+		{ 0x924d692cU, 0xa61be758U, 269 },
+		{ 0xda01ee64U, 0x1a708deaU, 295 },
+		{ 0xa26da399U, 0x9aef774aU, 322 },
+		{ 0xf209787bU, 0xb47d6b85U, 348 },
+		{ 0xb454e4a1U, 0x79dd1877U, 375 },
+		{ 0x865b8692U, 0x5b9bc5c2U, 402 },
+		{ 0xc83553c5U, 0xc8965d3dU, 428 },
+		{ 0x952ab45cU, 0xfa97a0b3U, 455 },
+		{ 0xde469fbdU, 0x99a05fe3U, 481 },
+		{ 0xa59bc234U, 0xdb398c25U, 508 },
+		{ 0xf6c69a72U, 0xa3989f5cU, 534 },
+		{ 0xb7dcbf53U, 0x54e9beceU, 561 },
+		{ 0x88fcf317U, 0xf22241e2U, 588 },
+		{ 0xcc20ce9bU, 0xd35c78a5U, 614 },
+		{ 0x98165af3U, 0x7b2153dfU, 641 },
+		{ 0xe2a0b5dcU, 0x971f303aU, 667 },
+		{ 0xa8d9d153U, 0x5ce3b396U, 694 },
+		{ 0xfb9b7cd9U, 0xa4a7443cU, 720 },
+		{ 0xbb764c4cU, 0xa7a44410U, 747 },
+		{ 0x8bab8eefU, 0xb6409c1aU, 774 },
+		{ 0xd01fef10U, 0xa657842cU, 800 },
+		{ 0x9b10a4e5U, 0xe9913129U, 827 },
+		{ 0xe7109bfbU, 0xa19c0c9dU, 853 },
+		{ 0xac2820d9U, 0x623bf429U, 880 },
+		{ 0x80444b5eU, 0x7aa7cf85U, 907 },
+		{ 0xbf21e440U, 0x03acdd2dU, 933 },
+		{ 0x8e679c2fU, 0x5e44ff8fU, 960 },
+		{ 0xd433179dU, 0x9c8cb841U, 986 },
+		{ 0x9e19db92U, 0xb4e31ba9U, 1013 },
+		{ 0xeb96bf6eU, 0xbadf77d9U, 1039 },
+		{ 0xaf87023bU, 0x9bf0ee6bU, 1066 },
+	};
+	double const dk=(-61-e)*0.30102999566398114+347;
+	int k=int(dk);
+	if (dk-k>0.0)
+		++k;
+	unsigned const index=unsigned((k>>3)+1);
+	K=-(-348+int(index<<3));
+	return DiyFp(makeUInt64(powers[index].mHigh, powers[index].mLow), powers[index].mExponent);
+}
+
+//! moves the last digit towards the exact value while it stays in the rounding interval
+void roundDigits(char *digits, int len, UInt64 delta, UInt64 rest, UInt64 tenKappa, UInt64 distance)
+{
+	while (rest<distance && delta-rest>=tenKappa &&
+	        (rest+tenKappa<distance || distance-rest>rest+tenKappa-distance))
+	{
+		--digits[len-1];
+		rest+=tenKappa;
+	}
+}
+
+//! generates the digits of W, mp being the upper bound of the rounding interval
+void generateDigits(DiyFp const &W, DiyFp const &mp, UInt64 delta, char *digits, int &len, int &K)
+{
+	static unsigned const pow10[]= { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+	DiyFp const one(UInt64(1) << -mp.mE, mp.mE);
+	DiyFp const distance=mp-W;
+	unsigned p1=unsigned(mp.mF >> -one.mE);
+	UInt64 p2=mp.mF & (one.mF-1);
+	int kappa=1;
+	while (kappa<10 && p1>=pow10[kappa])
+		++kappa;
+	len=0;
+	while (kappa>0)
+	{
+		unsigned const d=p1/pow10[kappa-1];
+		p1%=pow10[kappa-1];
+		if (d || len)
+			digits[len++]=char('0'+d);
+		--kappa;
+		UInt64 const rest=(UInt64(p1) << -one.mE)+p2;
+		if (rest<=delta)
+		{
+			K+=kappa;
+			roundDigits(digits, len, delta, rest, UInt64(pow10[kappa]) << -one.mE, distance.mF);
+			return;
+		}
+	}
+	while (true)
+	{
+		p2*=10;
+		delta*=10;
+		char const d=char(p2 >> -one.mE);
+		if (d || len)
+			digits[len++]=char('0'+d);
+		p2&=one.mF-1;
+		--kappa;
+		if (p2<delta)
+		{
+			K+=kappa;
+			roundDigits(digits, len, delta, p2, one.mF, distance.mF*(-kappa<10 ? pow10[-kappa] : 0));
+			return;
+		}
+	}
+}
+
+/** writes the shortest digits of a positive finite value in digits (at
+	least 18 characters), returns their number and sets the decimal
+	exponent K such that value=digits*10^K */
+int getShortestDigits(double value, char *digits, int &K)
+{
+	UInt64 bits;
+	memcpy(&bits, &value, sizeof(double));
+	int const biasedExponent=int((bits>>52)&0x7ff);
+	UInt64 const hiddenBit=UInt64(1)<<52;
+	UInt64 const significand=bits&(hiddenBit-1);
+	DiyFp const v=biasedExponent ? DiyFp(significand+hiddenBit, biasedExponent-1075) : DiyFp(significand, -1074);
+	// the boundaries of the rounding interval of v
+	DiyFp plus=DiyFp((v.mF<<1)+1, v.mE-1);
+	while (!(plus.mF & (hiddenBit<<1)))
+	{
+		plus.mF<<=1;
+		--plus.mE;
+	}
+	plus.mF<<=10;
+	plus.mE-=10;
+	DiyFp minus=v.mF==hiddenBit ? DiyFp((v.mF<<2)-1, v.mE-2) : DiyFp((v.mF<<1)-1, v.mE-1);
+	minus.mF<<=minus.mE-plus.mE;
+	minus.mE=plus.mE;
+
+	DiyFp const cachedPower=getCachedPower(plus.mE, K);
+	DiyFp const W=normalize(v)*cachedPower;
+	DiyFp Wp=plus*cachedPower;
+	DiyFp Wm=minus*cachedPower;
+	++Wm.mF;
+	--Wp.mF;
+	int len;
+	generateDigits(W, Wp, Wp.mF-Wm.mF, digits, len, K);
+	while (len>1 && digits[len-1]=='0')
+	{
+		--len;
+		++K;
+	}
+	return len;
+}
+}
+
+void NumberString::print(char const *format, int precision, double value)
+{
+	// the buffer is large enough for any double with 4 decimals or 17 digits
+	int const len=sprintf(mBuffer, format, precision, value);
+	mSize=len<0 ? 0 : size_t(len);
+	mBuffer[mSize]=0;
+	// the decimal separator depends on the locale
+	for (size_t i=0; i<mSize; ++i)
+	{
+		if (mBuffer[i]==',')
+			mBuffer[i]='.';
+	}
+}
+
+NumberString &NumberString::setDouble(double value, char const *unit)
+{
+	mSize=0;
+	double const absValue=value<0 ? -value : value;
+	if (absValue<0.0001)
+	{
+		// librevenge writes the small values and -0 as 0
+		append("0.0000");
+	}
+	else if (absValue<1e7)
+	{
+		// the rounded value has at most 11 digits, so it is exact; the
+		// product is not, so the values near a tie are left to printf
+		double const scaled=absValue*10000.;
+		double const diff=scaled-floor(scaled);
+		if (diff>0.499 && diff<0.501)
+			print("%.*f", 4, value);
+		else
+		{
+			double const rounded=floor(scaled+0.5);
+			double const intPart=floor(rounded/10000.);
+			if (value<0)
+				append('-');
+			appendInt(int(intPart));
+			append('.');
+			appendInt(int(rounded-10000.*intPart), 4);
+		}
+	}
+	else
+		print("%.*f", 4, value);
+	if (unit)
+		append(unit);
+	return *this;
+}
+
+NumberString &NumberString::setRoundTripDouble(double value)
+{
+	double const absValue=value<0 ? -value : value;
+	if (absValue<1e9 && floor(absValue)==absValue)
+		return setInt(int(value));
+	if (value!=value || absValue-absValue!=0)
+	{
+		// nan or infinity
+		print("%.*g", 15, value);
+		return *this;
+	}
+	char digits[20];
+	int K;
+	int const len=getShortestDigits(absValue, digits, K);
+	// the text is written like printf("%.*g") with 15 digits or more
+	int const exponent=len-1+K;
+	int const precision=len<15 ? 15 : len;
+	mSize=0;
+	if (value<0)
+		append('-');
+	if (exponent<-4 || exponent>=precision)
+	{
+		append(digits[0]);
+		if (len>1)
+		{
+			append('.');
+			for (int i=1; i<len; ++i)
+				append(digits[i]);
+		}
+		append('e');
+		append(exponent<0 ? '-' : '+');
+		appendInt(exponent<0 ? -exponent : exponent, 2);
+	}
+	else if (exponent<0)
+	{
+		append("0.");
+		for (int i=exponent+1; i<0; ++i)
+			append('0');
+		for (int i=0; i<len; ++i)
+			append(digits[i]);
+	}
+	else
+	{
+		for (int i=0; i<len || i<=exponent; ++i)
+		{
+			if (i==exponent+1)
+				append('.');
+			append(i<len ? digits[i] : '0');
+		}
+	}
+	return *this;
+}
+
+NumberString &NumberString::appendInt(int value, int minDigits)
+{
+	char digits[16];
+	char *pos=digits+sizeof(digits);
+	unsigned number=value<0 ? 0u-unsigned(value) : unsigned(value);
+	do
+	{
+		*(--pos)=char('0'+number%10);
+		number/=10;
+	}
+	while (number);
+	// like printf, the sign is counted in the width
+	if (value<0)
+	{
+		append('-');
+		--minDigits;
+	}
+	for (int i=int(digits+sizeof(digits)-pos); i<minDigits; ++i)
+		append('0');
+	while (pos!=digits+sizeof(digits))
+		append(*(pos++));
+	return *this;
+}
+
+NumberString &NumberString::append(char const *str)
+{
+	while (str && *str)
+		append(*(str++));
+	return *this;
+}
+
+bool readDouble(char const *str, double &value)
+{
+	if (!str)
+		return false;
+	while (*str==' ')
+		++str;
+	if (!strncmp(str, "nan", 3) || !strncmp(str, "NAN", 3) || !strncmp(str, "NaN", 3))
+	{
+		value=std::numeric_limits<double>::quiet_NaN();
+		return true;
+	}
+	// strtod uses the decimal separator of the locale
+	std::string text(str);
+	std::string::size_type const point=text.find('.');
+	if (point!=std::string::npos)
+	{
+		lconv const *conv=localeconv();
+		if (conv && conv->decimal_point && conv->decimal_point[0] && strcmp(conv->decimal_point, "."))
+			text.replace(point, 1, conv->decimal_point);
+	}
+	char *end;
+	value=strtod(text.c_str(), &end);
+	if (end==text.c_str())
+		return false;
+	while (*end==' ')
+		++end;
+	return *end==0;
+}
+
+namespace
+{
+inline unsigned rotateLeft(unsigned value, int shift)
+{
+	return (value<<shift) | (value>>(32-shift));
+}
+
+inline unsigned finalMix(unsigned value)
+{
+	value^=value>>16;
+	value*=0x85ebca6bU;
+	value^=value>>13;
+	value*=0xc2b2ae35U;
+	value^=value>>16;
+	return value;
+}
+
+//! reads a little endian 32 bits block, so that the hash does not depend on the platform
+inline unsigned readBlock(unsigned char const *data)
+{
+	return unsigned(data[0]) | unsigned(data[1])<<8 | unsigned(data[2])<<16 | unsigned(data[3])<<24;
+}
+}
+
+BinaryHash::BinaryHash(unsigned char const *data, unsigned long size) : mValues()
+{
+	static unsigned const c[4]= { 0x239b961bU, 0xab0e9789U, 0x38b34ae5U, 0xa1e38b93U };
+	static int const rotations[4]= { 15, 16, 17, 18 };
+	static int const mixRotations[4]= { 19, 17, 15, 13 };
+	static unsigned const mixAdds[4]= { 0x561ccd1bU, 0x0bcaa747U, 0x96cd1c35U, 0x32ac3b17U };
+	unsigned h[4]= { 0, 0, 0, 0 };
+	if (!data) size=0;
+	unsigned long const numBlocks=size/16;
+	for (unsigned long b=0; b<numBlocks; ++b)
+	{
+		unsigned char const *block=data+16*b;
+		for (int i=0; i<4; ++i)
+		{
+			unsigned k=readBlock(block+4*i);
+			k*=c[i];
+			k=rotateLeft(k, rotations[i]);
+			k*=c[(i+1)%4];
+			h[i]^=k;
+			h[i]=rotateLeft(h[i], mixRotations[i]);
+			h[i]+=h[(i+1)%4];
+			h[i]=h[i]*5+mixAdds[i];
+		}
+	}
+	// the tail: the last 1 to 15 bytes
+	unsigned char const *tail=data+16*numBlocks;
+	unsigned long const tailSize=size%16;
+	for (int i=0; i<4; ++i)
+	{
+		if (tailSize<=(unsigned long)(4*i)) break;
+		unsigned k=0;
+		for (unsigned long j=4*(unsigned long)(i)+4; j>4*(unsigned long)(i); --j)
+		{
+			if (j-1<tailSize)
+				k=(k<<8) | tail[j-1];
+			else
+				k<<=8;
+		}
+		k*=c[i];
+		k=rotateLeft(k, rotations[i]);
+		k*=c[(i+1)%4];
+		h[i]^=k;
+	}
+	for (int i=0; i<4; ++i)
+		h[i]^=unsigned(size);
+	h[0]+=h[1]+h[2]+h[3];
+	h[1]+=h[0];
+	h[2]+=h[0];
+	h[3]+=h[0];
+	for (int i=0; i<4; ++i)
+		h[i]=finalMix(h[i]);
+	h[0]+=h[1]+h[2]+h[3];
+	h[1]+=h[0];
+	h[2]+=h[0];
+	h[3]+=h[0];
+	for (int i=0; i<4; ++i)
+		mValues[i]=h[i];
+}
+
+librevenge::RVNGString BinaryHash::str() const
+{
+	librevenge::RVNGString res;
+	res.sprintf("%08x%08x%08x%08x", mValues[0], mValues[1], mValues[2], mValues[3]);
+	return res;
+}
+
+librevenge::RVNGBinaryData BinaryStore::insert(librevenge::RVNGBinaryData const &data, BinaryHash &hash)
+{
+	hash=BinaryHash(data.getDataBuffer(), data.size());
+	std::map<BinaryHash, librevenge::RVNGBinaryData>::const_iterator it=mDataMap.find(hash);
+	if (it==mDataMap.end())
+	{
+		mDataMap.insert(std::make_pair(hash, data));
+		return data;
+	}
+	// check the content, in case of a collision
+	if (it->second.size()!=data.size() ||
+	        (data.size() && memcmp(it->second.getDataBuffer(), data.getDataBuffer(), data.size())!=0))
+	{
+		ODFGEN_DEBUG_MSG(("BinaryStore::insert: find a hash collision\n"));
+		return data;
+	}
+	return it->second;
+}
+
 DocumentElementVector::~DocumentElementVector()
 {
+	clear();
+}
+
+void DocumentElementVector::clear()
+{
+	for (size_t i=0; i<mChunks.size(); ++i)
+		delete [] mChunks[i].mpData;
+	mChunks.clear();
+	mRecordStart=0;
+	mNumElements=0;
+	mbMustSpill=false;
+	if (mpSpillFile)
+		fclose(mpSpillFile);
+	mpSpillFile=0;
+	mSpilledChunkSizes.clear();
+	mElements.clear();
+}
+
+bool DocumentElementVector::spill()
+{
+	if (mChunks.empty())
+		return true;
+	if (!mpSpillFile)
+	{
+		mpSpillFile=tmpfile();
+		if (!mpSpillFile)
+		{
+			ODFGEN_DEBUG_MSG(("DocumentElementVector::spill: can not create a temporary file\n"));
+			return false;
+		}
+	}
+	if (fseek(mpSpillFile, 0, SEEK_END)!=0)
+		return false;
+	// a chunk only contains complete records, so each chunk can be read back and written alone
+	for (size_t i=0; i<mChunks.size(); ++i)
+	{
+		if (fwrite(mChunks[i].mpData, 1, mChunks[i].mSize, mpSpillFile)!=mChunks[i].mSize)
+		{
+			ODFGEN_DEBUG_MSG(("DocumentElementVector::spill: can not write the temporary file\n"));
+			// the data written after the last spilled chunk are ignored
+			return false;
+		}
+	}
+	for (size_t i=0; i<mChunks.size(); ++i)
+	{
+		mSpilledChunkSizes.push_back(mChunks[i].mSize);
+		delete [] mChunks[i].mpData;
+	}
+	mChunks.clear();
+	mRecordStart=0;
+	return true;
+}
+
+bool DocumentElementVector::readSpilledChunks(void (*function)(char const *data, size_t size, void *userData), void *userData) const
+{
+	if (mSpilledChunkSizes.empty())
+		return true;
+	if (!mpSpillFile || fseek(mpSpillFile, 0, SEEK_SET)!=0)
+	{
+		ODFGEN_DEBUG_MSG(("DocumentElementVector::readSpilledChunks: can not find the temporary file\n"));
+		return false;
+	}
+	std::vector<char> buffer;
+	for (size_t i=0; i<mSpilledChunkSizes.size(); ++i)
+	{
+		size_t const size=mSpilledChunkSizes[i];
+		if (!size) continue;
+		buffer.resize(size);
+		if (fread(&buffer[0], 1, size, mpSpillFile)!=size)
+		{
+			ODFGEN_DEBUG_MSG(("DocumentElementVector::readSpilledChunks: can not read the temporary file\n"));
+			return false;
+		}
+		function(&buffer[0], size, userData);
+	}
+	return true;
+}
+
+char *DocumentElementVector::reserve(size_t size)
+{
+	if (mChunks.empty() || mChunks.back().mSize+size > mChunks.back().mCapacity)
+	{
+		// create a new chunk and move the beginning of the current record in it
+		size_t const recordSize=mChunks.empty() ? 0 : mChunks.back().mSize-mRecordStart;
+		size_t capacity=mChunks.empty() ? 256 : 2*mChunks.back().mCapacity;
+		if (capacity>65536)
+			capacity=65536;
+		if (capacity<2*(recordSize+size))
+			capacity=2*(recordSize+size);
+		Chunk chunk;
+		chunk.mpData=new char[capacity];
+		chunk.mSize=recordSize;
+		chunk.mCapacity=capacity;
+		if (recordSize)
+		{
+			memcpy(chunk.mpData, mChunks.back().mpData+mRecordStart, recordSize);
+			mChunks.back().mSize=mRecordStart;
+		}
+		if (!mChunks.empty() && mChunks.back().mSize==0)
+		{
+			delete [] mChunks.back().mpData;
+			mChunks.pop_back();
+		}
+		mChunks.push_back(chunk);
+		mRecordStart=0;
+		if (mSpillThreshold)
+		{
+			// the current record is not complete, so the chunks are spilled before the next one
+			size_t memorySize=0;
+			for (size_t i=0; i<mChunks.size(); ++i)
+				memorySize+=mChunks[i].mCapacity;
+			mbMustSpill=memorySize>mSpillThreshold;
+		}
+	}
+	Chunk &chunk=mChunks.back();
+	char *res=chunk.mpData+chunk.mSize;
+	chunk.mSize+=size;
+	return res;
 }
 
-void DocumentElementVector::resize(size_t newSize)
+void DocumentElementVector::startRecord(char type)
 {
-	mpElements.resize(newSize);
+	if (mbMustSpill)
+	{
+		mbMustSpill=false;
+		if (!spill())
+			mSpillThreshold=0;
+	}
+	mRecordStart=mChunks.empty() ? 0 : mChunks.back().mSize;
+	*reserve(1)=type;
+	++mNumElements;
 }
 
-void DocumentElementVector::push_back(shared_ptr<DocumentElement> elt)
+void DocumentElementVector::addString(char const *str, size_t len)
 {
-	mpElements.push_back(elt);
+	char *pos=reserve(len+1);
+	if (len) memcpy(pos, str, len);
+	pos[len]=0;
+}
+
+void DocumentElementVector::addNumber(unsigned value)
+{
+	memcpy(reserve(sizeof(unsigned)), &value, sizeof(unsigned));
+}
+
+void DocumentElementVector::addName(char const *name, unsigned short atom)
+{
+	if (!atom)
+		atom=NameTable::getAtom(name);
+	AttributeVector::writeName(reserve(AttributeVector::getNameSize(name, atom)), name, atom);
+}
+
+void DocumentElementVector::push_back(DocumentElement const &elt)
+{
+	elt.appendTo(*this);
 }
 
 void DocumentElementVector::push_back(DocumentElement *elt)
 {
-	mpElements.push_back(shared_ptr<DocumentElement>(elt));
+	if (!elt) return;
+	elt->appendTo(*this);
+	delete elt;
+}
+
+void DocumentElementVector::addOpenElement(const char *name, const AttributeVector &attributes, unsigned short atom)
+{
+	startRecord('O');
+	addName(name, atom);
+	addNumber(attributes.size());
+	if (attributes.dataSize())
+		memcpy(reserve(attributes.dataSize()), attributes.data(), attributes.dataSize());
+}
+
+void DocumentElementVector::addCloseElement(const char *name, unsigned short atom)
+{
+	startRecord('C');
+	addName(name, atom);
+}
+
+void DocumentElementVector::addCharacters(char const *data, size_t length)
+{
+	char const *poolString=mpStringPool ? mpStringPool->find(data, length) : 0;
+	if (poolString)
+	{
+		// a reference to the pool string
+		startRecord('S');
+		memcpy(reserve(sizeof(char const *)), &poolString, sizeof(char const *));
+		return;
+	}
+	startRecord('T');
+	addString(data, length);
+}
+
+void DocumentElementVector::addBinaryData(const librevenge::RVNGBinaryData &data)
+{
+	// RVNGBinaryData shares its buffer, so the copy is cheap
+	addElement(shared_ptr<DocumentElement const>(new BinaryDataElement(data)));
+}
+
+void DocumentElementVector::addElement(shared_ptr<DocumentElement const> const &element)
+{
+	if (!element)
+		return;
+	mElements.push_back(element);
+	DocumentElement const *ptr=element.get();
+	startRecord('E');
+	memcpy(reserve(sizeof(DocumentElement const *)), &ptr, sizeof(DocumentElement const *));
+}
+
+void DocumentElementVector::appendChunk(char const *data, size_t size, void *vector)
+{
+	DocumentElementVector &res=*static_cast<DocumentElementVector *>(vector);
+	// a chunk only contains complete records
+	res.mRecordStart=res.mChunks.empty() ? 0 : res.mChunks.back().mSize;
+	memcpy(res.reserve(size), data, size);
+}
+
+void DocumentElementVector::appendTo(DocumentElementVector &res) const
+{
+	readSpilledChunks(&DocumentElementVector::appendChunk, &res);
+	for (size_t i=0; i<mChunks.size(); ++i)
+		appendChunk(mChunks[i].mpData, mChunks[i].mSize, &res);
+	res.mNumElements+=mNumElements;
+	// the copied records point to our elements
+	res.mElements.insert(res.mElements.end(), mElements.begin(), mElements.end());
+}
+
+bool DocumentElementVector::operator==(const DocumentElementVector &other) const
+{
+	if (mNumElements!=other.mNumElements || isSpilled() || other.isSpilled())
+		return false;
+	// the records can be split differently in the two lists of chunks
+	size_t c1=0, c2=0, pos1=0, pos2=0;
+	while (true)
+	{
+		while (c1<mChunks.size() && pos1>=mChunks[c1].mSize)
+		{
+			++c1;
+			pos1=0;
+		}
+		while (c2<other.mChunks.size() && pos2>=other.mChunks[c2].mSize)
+		{
+			++c2;
+			pos2=0;
+		}
+		if (c1==mChunks.size() || c2==other.mChunks.size())
+			return c1==mChunks.size() && c2==other.mChunks.size();
+		size_t len=mChunks[c1].mSize-pos1;
+		if (len>other.mChunks[c2].mSize-pos2)
+			len=other.mChunks[c2].mSize-pos2;
+		if (memcmp(mChunks[c1].mpData+pos1, other.mChunks[c2].mpData+pos2, len)!=0)
+			return false;
+		pos1+=len;
+		pos2+=len;
+	}
+}
+
+void DocumentElementVector::swap(DocumentElementVector &other)
+{
+	mChunks.swap(other.mChunks);
+	std::swap(mRecordStart, other.mRecordStart);
+	std::swap(mNumElements, other.mNumElements);
+	std::swap(mbMustSpill, other.mbMustSpill);
+	std::swap(mpSpillFile, other.mpSpillFile);
+	mSpilledChunkSizes.swap(other.mSpilledChunkSizes);
+	mElements.swap(other.mElements);
+}
+
+namespace
+{
+//! the handlers used to write a chunk
+struct ChunkHandlers
+{
+	//! the handler
+	OdfDocumentHandler *mpHandler;
+	//! the handler if it is an OdfFastDocumentHandler
+	OdfFastDocumentHandler *mpFastHandler;
+};
+
+//! writes the records of a chunk in a handler
+void writeChunk(char const *data, size_t size, void *handlers)
+{
+	OdfDocumentHandler *pHandler=static_cast<ChunkHandlers *>(handlers)->mpHandler;
+	OdfFastDocumentHandler *pFastHandler=static_cast<ChunkHandlers *>(handlers)->mpFastHandler;
+	char const *pos=data;
+	char const *end=pos+size;
+	while (pos<end)
+	{
+		char const type=*(pos++);
+		switch (type)
+		{
+		case 'O':
+		{
+			char const *name=AttributeVector::readName(pos);
+			unsigned numAttributes;
+			memcpy(&numAttributes, pos, sizeof(unsigned));
+			pos+=sizeof(unsigned);
+			sendOpenElement(pHandler, pFastHandler, name, pos, numAttributes);
+			break;
+		}
+		case 'C':
+			pHandler->endElement(AttributeVector::readName(pos));
+			break;
+		case 'T':
+		{
+			size_t const length=strlen(pos);
+			sendCharacters(pHandler, pFastHandler, pos, length);
+			pos+=length+1;
+			break;
+		}
+		case 'S':
+		{
+			char const *str;
+			memcpy(&str, pos, sizeof(char const *));
+			pos+=sizeof(char const *);
+			sendCharacters(pHandler, pFastHandler, str, strlen(str));
+			break;
+		}
+		case 'E':
+		{
+			DocumentElement const *element;
+			memcpy(&element, pos, sizeof(DocumentElement const *));
+			pos+=sizeof(DocumentElement const *);
+			element->write(pHandler);
+			break;
+		}
+		default:
+			ODFGEN_DEBUG_MSG(("DocumentElementVector::write: find unknown record type\n"));
+			return;
+		}
+	}
+}
+}
+
+void DocumentElementVector::write(OdfDocumentHandler *pHandler) const
+{
+	if (!pHandler)
+	{
+		ODFGEN_DEBUG_MSG(("DocumentElementVector::write: called without handler\n"));
+		return;
+	}
+	ChunkHandlers handlers;
+	handlers.mpHandler=pHandler;
+	handlers.mpFastHandler=dynamic_cast<OdfFastDocumentHandler *>(pHandler);
+	readSpilledChunks(&writeChunk, &handlers);
+	for (size_t c=0; c<mChunks.size(); ++c)
+		writeChunk(mChunks[c].mpData, mChunks[c].mSize, &handlers);
 }
 
-void DocumentElementVector::appendTo(DocumentElementVector &res)
+void sendOpenElement(OdfDocumentHandler *pHandler, OdfFastDocumentHandler *pFastHandler,
+                     char const *name, char const *&pos, unsigned numAttributes)
 {
-	for (size_t i=0; i<mpElements.size(); ++i)
-		res.mpElements.push_back(mpElements[i]);
+	if (!pFastHandler)
+	{
+		librevenge::RVNGPropertyList attributes;
+		AttributeVector::readAttributes(pos, numAttributes, attributes);
+		pHandler->startElement(name, attributes);
+		return;
+	}
+	// the attributes point directly to the encoded data
+	OdfAttribute localAttributes[32];
+	std::vector<OdfAttribute> otherAttributes;
+	OdfAttribute *attributes=localAttributes;
+	if (numAttributes>ODFGEN_N_ELEMENTS(localAttributes))
+	{
+		otherAttributes.resize(numAttributes);
+		attributes=&otherAttributes[0];
+	}
+	for (unsigned i=0; i<numAttributes; ++i)
+	{
+		attributes[i].escaped=AttributeVector::isEscaped(pos);
+		attributes[i].name=AttributeVector::readName(pos);
+		attributes[i].value=pos;
+		attributes[i].length=(unsigned long) strlen(pos);
+		pos+=attributes[i].length+1;
+	}
+	pFastHandler->startElement(name, attributes, numAttributes);
+}
+
+void sendCharacters(OdfDocumentHandler *pHandler, OdfFastDocumentHandler *pFastHandler, char const *data, size_t length)
+{
+	if (pFastHandler)
+		pFastHandler->characters(data, (unsigned long) length);
+	else
+		pHandler->characters(librevenge::RVNGString(data));
+}
+
+void sendBase64Data(OdfDocumentHandler *pHandler, OdfFastDocumentHandler *pFastHandler, const librevenge::RVNGBinaryData &data)
+{
+	// the block size must be a multiple of 3, so that only the last block is padded
+	static size_t const blockSize=3*4096;
+	char buffer[4*(blockSize/3)+1];
+	unsigned char const *pos=data.getDataBuffer();
+	size_t remaining=data.size();
+	while (pos && remaining)
+	{
+		size_t const size=remaining<blockSize ? remaining : blockSize;
+		size_t const length=encodeBase64(pos, size, buffer);
+		buffer[length]=0;
+		sendCharacters(pHandler, pFastHandler, buffer, length);
+		pos+=size;
+		remaining-=size;
+	}
+}
+
+size_t encodeBase64(unsigned char const *data, size_t size, char *res)
+{
+	static char const alphabet[]="ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	char *pos=res;
+	unsigned char const *end=data+(size/3)*3;
+	for (; data<end; data+=3, pos+=4)
+	{
+		unsigned long const value=(unsigned long)(data[0])<<16 | (unsigned long)(data[1])<<8 | data[2];
+		pos[0]=alphabet[(value>>18)&0x3f];
+		pos[1]=alphabet[(value>>12)&0x3f];
+		pos[2]=alphabet[(value>>6)&0x3f];
+		pos[3]=alphabet[value&0x3f];
+	}
+	switch (size%3)
+	{
+	case 1:
+		pos[0]=alphabet[data[0]>>2];
+		pos[1]=alphabet[(data[0]&0x3)<<4];
+		pos[2]=pos[3]='=';
+		pos+=4;
+		break;
+	case 2:
+		pos[0]=alphabet[data[0]>>2];
+		pos[1]=alphabet[((data[0]&0x3)<<4) | (data[1]>>4)];
+		pos[2]=alphabet[(data[1]&0xf)<<2];
+		pos[3]='=';
+		pos+=4;
+		break;
+	default:
+		break;
+	}
+	return size_t(pos-res);
 }
 
 void debugPrint(const char *format, ...)
@@ -23,8 +23,12 @@
 #define __FILTERINTERNAL_HXX__
 
 #include <assert.h> // for assert
-#include <string.h> // for strcmp
+#include <stdio.h> // for FILE
+#include <string.h> // for strcmp, strlen
 
+#include <map>
+#include <set>
+#include <string>
 #include <vector>
 
 #include <librevenge/librevenge.h>
@@ -40,7 +44,6 @@
 #endif
 
 #ifdef DEBUG
-#include <stdio.h>
 #define ODFGEN_DEBUG_MSG(M) libodfgen::debugPrint M
 #else
 #define ODFGEN_DEBUG_MSG(M)
@@ -60,6 +63,8 @@ using boost::shared_ptr;
 #define ODFGEN_N_ELEMENTS(m) sizeof(m)/sizeof(m[0])
 
 class DocumentElement;
+class OdfDocumentHandler;
+class OdfFastDocumentHandler;
 
 namespace libodfgen
 {
@@ -67,67 +72,424 @@ namespace libodfgen
 librevenge::RVNGString doubleToString(const double value);
 bool getInchValue(librevenge::RVNGProperty const &prop, double &value);
 
-//! small class used to store a list of shared_ptr DocumentElement
-class DocumentElementVector
+/** small buffer used to write a number without allocation
+
+	The characters are stored in the object itself. The doubles are written
+	like librevenge writes the double properties (with 4 decimals and a
+	point as decimal separator), but without creating a property and a
+	librevenge::RVNGString.
+ */
+class NumberString
+{
+public:
+	//! constructor
+	NumberString() : mSize(0), mBuffer()
+	{
+		mBuffer[0]=0;
+	}
+	//! removes the text
+	NumberString &clear()
+	{
+		mSize=0;
+		mBuffer[0]=0;
+		return *this;
+	}
+	//! writes a double with 4 decimals followed by unit (if it is not null)
+	NumberString &setDouble(double value, char const *unit=0);
+	//! writes the shortest text which is read back as value
+	NumberString &setRoundTripDouble(double value);
+	//! writes an integer, with some leading zeros to have at least minDigits digits
+	NumberString &setInt(int value, int minDigits=1)
+	{
+		mSize=0;
+		return appendInt(value, minDigits);
+	}
+	//! appends an integer, with some leading zeros to have at least minDigits digits
+	NumberString &appendInt(int value, int minDigits=1);
+	//! appends a character
+	NumberString &append(char c)
+	{
+		if (mSize+1<sizeof(mBuffer))
+			mBuffer[mSize++]=c;
+		mBuffer[mSize]=0;
+		return *this;
+	}
+	//! appends a string
+	NumberString &append(char const *str);
+	//! returns the text
+	char const *cstr() const
+	{
+		return mBuffer;
+	}
+	//! returns the text length
+	size_t size() const
+	{
+		return mSize;
+	}
+private:
+	//! writes value with printf format, replacing the locale decimal separator by a point
+	void print(char const *format, int precision, double value);
+
+	//! the text length
+	size_t mSize;
+	//! the text: large enough to write any double with 4 decimals
+	char mBuffer[400];
+};
+
+/** reads a number written with a point as decimal separator whatever the
+	locale, "nan" being read as NaN; returns false if str is not a number */
+bool readDouble(char const *str, double &value);
+
+/** small vector used to store the attributes of an opening tag
+
+	The attributes are encoded one after the other in a byte buffer: the name
+	(as a NameTable atom when possible) followed by the value, sorted by name
+	like the property list entries. The high bit of the stored atom is set
+	when the value is already escaped for XML. The first bytes
+	are stored in the object itself, so a tag with a few short attributes does
+	not need any allocation. The data can be copied as is in a
+	DocumentElementVector; a librevenge::RVNGPropertyList is only created when
+	the attributes are sent to an OdfDocumentHandler.
+ */
+class AttributeVector
 {
 public:
 	//! constructor
-	DocumentElementVector() : mpElements() {}
+	AttributeVector() : mpData(mInlineData), mSize(0), mCapacity(sizeof(mInlineData)), mNumAttributes(0), mInlineData() {}
+	//! copy constructor
+	AttributeVector(const AttributeVector &orig);
+	//! copy operator
+	AttributeVector &operator=(const AttributeVector &orig);
 	//! destructor
-	~DocumentElementVector();
+	~AttributeVector()
+	{
+		if (mpData!=mInlineData)
+			delete [] mpData;
+	}
+	//! removes all attributes
+	void clear()
+	{
+		mSize=0;
+		mNumAttributes=0;
+	}
+	//! returns true if there is no attribute
+	bool empty() const
+	{
+		return mNumAttributes==0;
+	}
+	//! returns the number of attributes
+	unsigned size() const
+	{
+		return mNumAttributes;
+	}
+	/** adds an attribute, or replaces the value of the attribute with the same name;
+		escaped must be set if the value is already escaped for XML */
+	void insert(char const *name, char const *value, size_t valueLength, bool escaped=false);
+	//! adds an attribute, or replaces the value of the attribute with the same name
+	void insert(char const *name, char const *value)
+	{
+		insert(name, value, strlen(value));
+	}
+	//! adds the attributes in a property list
+	void addTo(librevenge::RVNGPropertyList &list) const;
+	//! returns the encoded data
+	char const *data() const
+	{
+		return mpData;
+	}
+	//! returns the encoded data size
+	size_t dataSize() const
+	{
+		return mSize;
+	}
+	//! returns true if the two vectors contain the same attributes
+	bool operator==(const AttributeVector &other) const
+	{
+		return mNumAttributes==other.mNumAttributes && mSize==other.mSize &&
+		       (mSize==0 || memcmp(mpData, other.mpData, mSize)==0);
+	}
 
-	//! delete all document element
+	//! writes a tag or attribute name in buffer (which must have getNameSize bytes) and returns the next position
+	static char *writeName(char *buffer, char const *name, unsigned short atom);
+	//! returns the number of bytes needed to store a name
+	static size_t getNameSize(char const *name, unsigned short atom)
+	{
+		return sizeof(unsigned short)+(atom ? 0 : strlen(name)+1);
+	}
+	//! reads a name stored by writeName and updates pos
+	static char const *readName(char const *&pos);
+	//! returns true if the attribute stored at pos has an escaped value
+	static bool isEscaped(char const *pos)
+	{
+		unsigned short atom;
+		memcpy(&atom, pos, sizeof(unsigned short));
+		return (atom&EscapedBit)!=0;
+	}
+	//! reads numAttributes encoded attributes, adds them in list and updates pos
+	static void readAttributes(char const *&pos, unsigned numAttributes, librevenge::RVNGPropertyList &list);
+
+private:
+	//! the bit set in the stored atom of an attribute whose value is escaped
+	static const unsigned short EscapedBit=0x8000;
+	//! returns a pointer where size bytes can be written
+	char *reserve(size_t size);
+
+	//! the data: mInlineData or an allocated buffer
+	char *mpData;
+	//! the used size
+	size_t mSize;
+	//! the capacity
+	size_t mCapacity;
+	//! the number of attributes
+	unsigned mNumAttributes;
+	//! the inline buffer
+	char mInlineData[112];
+};
+
+/** a pool of immutable strings
+
+	A text stored many times in a DocumentElementVector can be replaced by a
+	reference to a unique copy stored in the pool. The pool must be destroyed
+	after the vectors which use it.
+ */
+class StringPool
+{
+public:
+	//! constructor: by default, no string is stored
+	StringPool() : mStrings(), mMinLength(0)
+	{
+	}
+	//! sets the minimal length of the stored strings, 0 means no string is stored
+	void setMinLength(size_t minLength)
+	{
+		mMinLength=minLength;
+	}
+	/** returns the unique copy of a string of length len or 0 if the
+		string is too short to be stored */
+	char const *find(char const *str, size_t len)
+	{
+		if (!mMinLength || len<mMinLength)
+			return 0;
+		return mStrings.insert(std::string(str, len)).first->c_str();
+	}
+
+private:
+	StringPool(const StringPool &orig);
+	StringPool &operator=(const StringPool &orig);
+
+	//! the strings (the elements of a std::set never move)
+	std::set<std::string> mStrings;
+	//! the minimal length of the stored strings
+	size_t mMinLength;
+};
+
+//! a 128 bits hash of a binary data (MurmurHash3 x86_128)
+struct BinaryHash
+{
+	//! constructor: the hash of an empty data
+	BinaryHash() : mValues()
+	{
+	}
+	//! constructor: computes the hash of size bytes
+	BinaryHash(unsigned char const *data, unsigned long size);
+	//! returns the hash as 32 hexadecimal digits
+	librevenge::RVNGString str() const;
+	//! comparison operator used by std::map
+	bool operator<(BinaryHash const &other) const
+	{
+		for (int i=0; i<4; ++i)
+		{
+			if (mValues[i]!=other.mValues[i])
+				return mValues[i]<other.mValues[i];
+		}
+		return false;
+	}
+	//! the four 32 bits parts
+	unsigned mValues[4];
+};
+
+/** a content-addressed store of binary data
+
+	The data are identified by their hash: when the same image or font is
+	inserted several times, all the copies share the stored data (the
+	RVNGBinaryData copies share their buffer).
+ */
+class BinaryStore
+{
+public:
+	//! constructor
+	BinaryStore() : mDataMap()
+	{
+	}
+	/** returns the stored data equal to data (data is stored if it is new)
+		and sets hash to the hash of data */
+	librevenge::RVNGBinaryData insert(librevenge::RVNGBinaryData const &data, BinaryHash &hash);
+	//! returns the number of stored data
+	size_t size() const
+	{
+		return mDataMap.size();
+	}
+	//! removes all the stored data
 	void clear()
 	{
-		resize(0);
+		mDataMap.clear();
 	}
+
+private:
+	BinaryStore(const BinaryStore &orig);
+	BinaryStore &operator=(const BinaryStore &orig);
+
+	//! hash to data map
+	std::map<BinaryHash, librevenge::RVNGBinaryData> mDataMap;
+};
+
+/** small class used to store a list of DocumentElement
+
+	The elements are not kept as objects: each element is encoded in a compact
+	record (a type, the tag name, the attributes or the text) which is stored in
+	a list of memory chunks owned by the vector. The tag and attribute names
+	which are in NameTable are stored as atoms.
+ */
+class DocumentElementVector
+{
+public:
+	//! constructor
+	DocumentElementVector() : mChunks(), mRecordStart(0), mNumElements(0), mSpillThreshold(0), mbMustSpill(false),
+		mpSpillFile(0), mSpilledChunkSizes(), mpStringPool(0), mElements() {}
+	//! destructor
+	~DocumentElementVector();
+
+	//! delete all document element
+	void clear();
 	//! returns true if the list is empty
 	bool empty() const
 	{
-		return mpElements.empty();
+		return mNumElements==0;
 	}
-	//! returns the vector size
+	//! returns the number of elements
 	size_t size() const
 	{
-		return mpElements.size();
+		return mNumElements;
 	}
-	//! returns the vector size
-	void resize(size_t newSize);
 	//! push_back
-	void push_back(shared_ptr<DocumentElement> elt);
-	//! push_back (given a pointer)
+	void push_back(DocumentElement const &elt);
+	//! push_back (given a pointer): the element is stored and deleted
 	void push_back(DocumentElement *elt);
-	//! append data at the end of res
-	void appendTo(DocumentElementVector &res);
-	//! operator[]
-	shared_ptr<DocumentElement> operator[](size_t index) const
+	//! adds an opening tag, atom is the name's atom in NameTable if it is already known
+	void addOpenElement(const char *name, const AttributeVector &attributes, unsigned short atom=0);
+	//! adds a closing tag, atom is the name's atom in NameTable if it is already known
+	void addCloseElement(const char *name, unsigned short atom=0);
+	//! adds a character data
+	void addCharacters(const librevenge::RVNGString &data)
 	{
-		return mpElements[index];
+		addCharacters(data.cstr(), data.size());
 	}
-	//! operator[]
-	shared_ptr<DocumentElement> &operator[](size_t index)
+	//! adds a character data given as a character array
+	void addCharacters(char const *data, size_t length);
+	/** adds a binary data: the vector keeps a copy of the raw data and
+		sends them encoded in base64 when it is written */
+	void addBinaryData(const librevenge::RVNGBinaryData &data);
+	/** adds an element which is kept as an object: its write function is
+		only called when the vector is written (used for the elements whose
+		content is computed later) */
+	void addElement(shared_ptr<DocumentElement const> const &element);
+	//! append data at the end of res
+	void appendTo(DocumentElementVector &res) const;
+	//! write all elements to a document handler
+	void write(OdfDocumentHandler *pHandler) const;
+	/** moves the stored elements in a temporary file, they are read
+		back when the vector is written or appended. Returns false if
+		the file can not be created or written. */
+	bool spill();
+	//! returns true if some elements are stored in a temporary file
+	bool isSpilled() const
 	{
-		return mpElements[index];
+		return !mSpilledChunkSizes.empty();
 	}
-
-	//! iterator
-	std::vector<shared_ptr<DocumentElement> >::const_iterator begin() const
+	/** returns true if the two vectors contain the same elements (the
+		vectors with spilled elements are never equal) */
+	bool operator==(const DocumentElementVector &other) const;
+	//! exchanges the elements of the two vectors (the spill thresholds and the string pools are not exchanged)
+	void swap(DocumentElementVector &other);
+	/** sets a string pool: when set, the character data which are long
+		enough are stored in the pool and the vector only keeps a reference */
+	void setStringPool(StringPool *pool)
 	{
-		return mpElements.begin();
+		mpStringPool=pool;
 	}
-	std::vector<shared_ptr<DocumentElement> >::const_iterator end() const
+	/** sets a memory size: when set, the stored elements are moved in the
+		temporary file each time their chunks use more than size bytes, so
+		the memory used does not depend on the number of elements. 0 (the
+		default) means that the elements are only spilled by spill. */
+	void setSpillThreshold(size_t size)
 	{
-		return mpElements.end();
+		mSpillThreshold=size;
 	}
 
 private:
 	DocumentElementVector(const DocumentElementVector &orig);
 	DocumentElementVector &operator=(const DocumentElementVector &orig);
-protected:
-	//! the list of elements
-	std::vector<shared_ptr<DocumentElement> > mpElements;
+
+	//! a memory chunk
+	struct Chunk
+	{
+		//! the data
+		char *mpData;
+		//! the used size
+		size_t mSize;
+		//! the capacity
+		size_t mCapacity;
+	};
+	//! starts a new record
+	void startRecord(char type);
+	//! adds a string (with its final 0) in the current record
+	void addString(char const *str, size_t len);
+	//! adds a number in the current record
+	void addNumber(unsigned value);
+	//! adds a tag name in the current record
+	void addName(char const *name, unsigned short atom);
+	//! returns a pointer where size bytes of the current record can be written
+	char *reserve(size_t size);
+	//! appends a chunk of complete records at the end of a DocumentElementVector
+	static void appendChunk(char const *data, size_t size, void *vector);
+	//! calls function(data, size, userData) for each spilled chunk, returns false if a chunk can not be read
+	bool readSpilledChunks(void (*function)(char const *data, size_t size, void *userData), void *userData) const;
+
+	//! the list of chunks
+	std::vector<Chunk> mChunks;
+	//! the position of the current record in the last chunk
+	size_t mRecordStart;
+	//! the number of elements
+	size_t mNumElements;
+	//! the memory size which triggers a spill or 0
+	size_t mSpillThreshold;
+	//! a flag to know if the chunks must be spilled before the next record
+	bool mbMustSpill;
+	//! the temporary file which contains the spilled chunks
+	FILE *mpSpillFile;
+	//! the size of the chunks stored in the temporary file
+	std::vector<size_t> mSpilledChunkSizes;
+	//! the string pool (if set)
+	StringPool *mpStringPool;
+	//! the elements referenced by the records
+	std::vector<shared_ptr<DocumentElement const> > mElements;
 };
 
+/** sends an opening tag to a handler: the numAttributes attributes are encoded
+	as in AttributeVector starting at pos, pos is updated. pFastHandler must be
+	pHandler if it is an OdfFastDocumentHandler or 0 */
+void sendOpenElement(OdfDocumentHandler *pHandler, OdfFastDocumentHandler *pFastHandler,
+                     char const *name, char const *&pos, unsigned numAttributes);
+//! sends a character data to a handler, pFastHandler must be pHandler if it is an OdfFastDocumentHandler or 0
+void sendCharacters(OdfDocumentHandler *pHandler, OdfFastDocumentHandler *pFastHandler, char const *data, size_t length);
+/** sends a binary data encoded in base64 to a handler: the data are
+	encoded by blocks, so the whole encoded string is never created */
+void sendBase64Data(OdfDocumentHandler *pHandler, OdfFastDocumentHandler *pFastHandler, const librevenge::RVNGBinaryData &data);
+/** encodes size bytes in base64 in res (with the final padding) and
+	returns the number of characters written: res must have room for
+	4*((size+2)/3) characters */
+size_t encodeBase64(unsigned char const *data, size_t size, char *res);
+
 void debugPrint(const char *format, ...)  ODFGEN_ATTRIBUTE_PRINTF(1, 2);
 
 } // namespace libodfgen
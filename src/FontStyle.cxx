@@ -50,7 +50,7 @@ void FontStyle::write(OdfDocumentHandler *pHandler) const
 {
 	TagOpenElement styleOpen("style:font-face");
 	styleOpen.addAttribute("style:name", getName());
-	styleOpen.addAttribute("svg:font-family", msFontFamily);
+	styleOpen.addEscapedAttribute("svg:font-family", msFontFamily);
 	styleOpen.write(pHandler);
 	if (bool(m_embeddedInfo))
 		writeEmbedded(pHandler);
@@ -81,7 +81,7 @@ void FontStyle::writeEmbedded(OdfDocumentHandler *const pHandler) const
 	TagOpenElement("office:binary-data").write(pHandler);
 	try
 	{
-		CharDataElement(m_embeddedInfo->m_data.getBase64Data()).write(pHandler);
+		BinaryDataElement(m_embeddedInfo->m_data).write(pHandler);
 	}
 	catch (...)
 	{
@@ -434,7 +434,10 @@ bool getPathBBox(const librevenge::RVNGPropertyListVector &path, double &px, dou
 
 librevenge::RVNGString convertPath(const librevenge::RVNGPropertyListVector &path, double px, double py)
 {
-	librevenge::RVNGString sValue("");
+	// the elements are written in a local buffer, the coordinates are
+	// integers so no printf is needed
+	std::string sValue;
+	NumberString sElement;
 	for (unsigned i = 0; i < path.count(); ++i)
 	{
 		if (!path[i]["librevenge:path-action"])
@@ -444,52 +447,56 @@ librevenge::RVNGString convertPath(const librevenge::RVNGPropertyListVector &pat
 		bool coordOk=path[i]["svg:x"]&&path[i]["svg:y"];
 		bool coord1Ok=coordOk && path[i]["svg:x1"]&&path[i]["svg:y1"];
 		bool coord2Ok=coord1Ok && path[i]["svg:x2"]&&path[i]["svg:y2"];
-		librevenge::RVNGString sElement;
 		// 2540 is 2.54*1000, 2.54 in = 1 inch
 		if (path[i]["svg:x"] && action[0] == 'H')
 		{
-			sElement.sprintf("H%i", (int)((getInchValue(path[i]["svg:x"])-px)*2540));
-			sValue.append(sElement);
+			sElement.clear().append('H').appendInt((int)((getInchValue(path[i]["svg:x"])-px)*2540));
+			sValue.append(sElement.cstr(), sElement.size());
 		}
 		else if (path[i]["svg:y"] && action[0] == 'V')
 		{
-			sElement.sprintf("V%i", (int)((getInchValue(path[i]["svg:y"])-py)*2540));
-			sValue.append(sElement);
+			sElement.clear().append('V').appendInt((int)((getInchValue(path[i]["svg:y"])-py)*2540));
+			sValue.append(sElement.cstr(), sElement.size());
 		}
 		else if (coordOk && (action[0] == 'M' || action[0] == 'L' || action[0] == 'T'))
 		{
-			sElement.sprintf("%c%i %i", action[0], (int)((getInchValue(path[i]["svg:x"])-px)*2540),
-			                 (int)((getInchValue(path[i]["svg:y"])-py)*2540));
-			sValue.append(sElement);
+			sElement.clear().append(action[0]).appendInt((int)((getInchValue(path[i]["svg:x"])-px)*2540))
+			.append(' ').appendInt((int)((getInchValue(path[i]["svg:y"])-py)*2540));
+			sValue.append(sElement.cstr(), sElement.size());
 		}
 		else if (coord1Ok && (action[0] == 'Q' || action[0] == 'S'))
 		{
-			sElement.sprintf("%c%i %i %i %i", action[0], (int)((getInchValue(path[i]["svg:x1"])-px)*2540),
-			                 (int)((getInchValue(path[i]["svg:y1"])-py)*2540), (int)((getInchValue(path[i]["svg:x"])-px)*2540),
-			                 (int)((getInchValue(path[i]["svg:y"])-py)*2540));
-			sValue.append(sElement);
+			sElement.clear().append(action[0]).appendInt((int)((getInchValue(path[i]["svg:x1"])-px)*2540))
+			.append(' ').appendInt((int)((getInchValue(path[i]["svg:y1"])-py)*2540))
+			.append(' ').appendInt((int)((getInchValue(path[i]["svg:x"])-px)*2540))
+			.append(' ').appendInt((int)((getInchValue(path[i]["svg:y"])-py)*2540));
+			sValue.append(sElement.cstr(), sElement.size());
 		}
 		else if (coord2Ok && action[0] == 'C')
 		{
-			sElement.sprintf("C%i %i %i %i %i %i", (int)((getInchValue(path[i]["svg:x1"])-px)*2540),
-			                 (int)((getInchValue(path[i]["svg:y1"])-py)*2540), (int)((getInchValue(path[i]["svg:x2"])-px)*2540),
-			                 (int)((getInchValue(path[i]["svg:y2"])-py)*2540), (int)((getInchValue(path[i]["svg:x"])-px)*2540),
-			                 (int)((getInchValue(path[i]["svg:y"])-py)*2540));
-			sValue.append(sElement);
+			sElement.clear().append('C').appendInt((int)((getInchValue(path[i]["svg:x1"])-px)*2540))
+			.append(' ').appendInt((int)((getInchValue(path[i]["svg:y1"])-py)*2540))
+			.append(' ').appendInt((int)((getInchValue(path[i]["svg:x2"])-px)*2540))
+			.append(' ').appendInt((int)((getInchValue(path[i]["svg:y2"])-py)*2540))
+			.append(' ').appendInt((int)((getInchValue(path[i]["svg:x"])-px)*2540))
+			.append(' ').appendInt((int)((getInchValue(path[i]["svg:y"])-py)*2540));
+			sValue.append(sElement.cstr(), sElement.size());
 		}
 		else if (coordOk && path[i]["svg:rx"] && path[i]["svg:ry"] && action[0] == 'A')
 		{
-			sElement.sprintf("A%i %i %i %i %i %i %i", (int)((getInchValue(path[i]["svg:rx"]))*2540),
-			                 (int)((getInchValue(path[i]["svg:ry"]))*2540), (path[i]["librevenge:rotate"] ? path[i]["librevenge:rotate"]->getInt() : 0),
-			                 (path[i]["librevenge:large-arc"] ? path[i]["librevenge:large-arc"]->getInt() : 1),
-			                 (path[i]["librevenge:sweep"] ? path[i]["librevenge:sweep"]->getInt() : 1),
-			                 (int)((getInchValue(path[i]["svg:x"])-px)*2540), (int)((getInchValue(path[i]["svg:y"])-py)*2540));
-			sValue.append(sElement);
+			sElement.clear().append('A').appendInt((int)((getInchValue(path[i]["svg:rx"]))*2540))
+			.append(' ').appendInt((int)((getInchValue(path[i]["svg:ry"]))*2540))
+			.append(' ').appendInt(path[i]["librevenge:rotate"] ? path[i]["librevenge:rotate"]->getInt() : 0)
+			.append(' ').appendInt(path[i]["librevenge:large-arc"] ? path[i]["librevenge:large-arc"]->getInt() : 1)
+			.append(' ').appendInt(path[i]["librevenge:sweep"] ? path[i]["librevenge:sweep"]->getInt() : 1)
+			.append(' ').appendInt((int)((getInchValue(path[i]["svg:x"])-px)*2540))
+			.append(' ').appendInt((int)((getInchValue(path[i]["svg:y"])-py)*2540));
+			sValue.append(sElement.cstr(), sElement.size());
 		}
 		else if (action[0] == 'Z')
 			sValue.append(" Z");
 	}
-	return sValue;
+	return librevenge::RVNGString(sValue.c_str());
 }
 
 }
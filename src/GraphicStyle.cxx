@@ -95,16 +95,11 @@ void GraphicStyleManager::write(OdfDocumentHandler *pHandler, Style::Zone zone)
 {
 	if (zone==Style::Z_Style)
 	{
-		for (size_t i=0; i < mBitmapStyles.size(); ++i)
-			mBitmapStyles[i]->write(pHandler);
-		for (size_t i=0; i < mGradientStyles.size(); ++i)
-			mGradientStyles[i]->write(pHandler);
-		for (size_t i=0; i < mMarkerStyles.size(); ++i)
-			mMarkerStyles[i]->write(pHandler);
-		for (size_t i=0; i < mOpacityStyles.size(); ++i)
-			mOpacityStyles[i]->write(pHandler);
-		for (size_t i=0; i<mStrokeDashStyles.size(); ++i)
-			mStrokeDashStyles[i]->write(pHandler);
+		mBitmapStyles.write(pHandler);
+		mGradientStyles.write(pHandler);
+		mMarkerStyles.write(pHandler);
+		mOpacityStyles.write(pHandler);
+		mStrokeDashStyles.write(pHandler);
 	}
 	for (size_t i=0; i<mStyles.size(); ++i)
 	{
@@ -115,14 +110,14 @@ void GraphicStyleManager::write(OdfDocumentHandler *pHandler, Style::Zone zone)
 
 librevenge::RVNGString GraphicStyleManager::findOrAdd(librevenge::RVNGPropertyList const &propList, Style::Zone zone)
 {
-	librevenge::RVNGPropertyList pList(propList);
 	if (zone==Style::Z_Unknown)
 		zone=Style::Z_ContentAutomatic;
-	pList.insert("librevenge:zone-style", int(zone));
-
-	librevenge::RVNGString hashKey = pList.getPropString();
-	if (mStyleNameMap.find(hashKey) != mStyleNameMap.end())
-		return mStyleNameMap.find(hashKey)->second;
+	mKey.clear();
+	mKey.append(propList);
+	mKey.append(int(zone));
+	librevenge::RVNGString const *styleName=mStyleNameMap.find(mKey);
+	if (styleName)
+		return *styleName;
 
 	librevenge::RVNGString name;
 	if (zone==Style::Z_StyleAutomatic)
@@ -132,7 +127,7 @@ librevenge::RVNGString GraphicStyleManager::findOrAdd(librevenge::RVNGPropertyLi
 	else
 		name.sprintf("gr_%i", (int) mStyleNameMap.size());
 
-	mStyleNameMap[hashKey]=name;
+	mStyleNameMap.insert(mKey, name);
 	shared_ptr<GraphicStyle> style(new GraphicStyle(propList, name.cstr(), zone));
 	mStyles.push_back(style);
 
@@ -145,20 +140,29 @@ librevenge::RVNGString GraphicStyleManager::getStyleNameForBitmap(librevenge::RV
 {
 	if (bitmap.empty())
 		return "";
-	if (mBitmapNameMap.find(bitmap) != mBitmapNameMap.end())
-		return mBitmapNameMap.find(bitmap)->second;
+	librevenge::RVNGBinaryData data(bitmap);
+	if (data.empty())
+		return "";
+	libodfgen::BinaryHash hash;
+	if (mpBinaryStore)
+		data=mpBinaryStore->insert(data, hash);
+	else
+		hash=libodfgen::BinaryHash(data.getDataBuffer(), data.size());
+	std::map<libodfgen::BinaryHash, librevenge::RVNGString>::const_iterator it=mBitmapNameMap.find(hash);
+	if (it!=mBitmapNameMap.end())
+		return it->second;
 
 	librevenge::RVNGString name;
 	name.sprintf("Bitmap_%i", (int) mBitmapNameMap.size());
-	mBitmapNameMap[bitmap]=name;
+	mBitmapNameMap[hash]=name;
 
 	TagOpenElement *openElement = new TagOpenElement("draw:fill-image");
 	openElement->addAttribute("draw:name", name);
 	mBitmapStyles.push_back(openElement);
-	mBitmapStyles.push_back(new TagOpenElement("office:binary-data"));
-	mBitmapStyles.push_back(new CharDataElement(bitmap));
-	mBitmapStyles.push_back(new TagCloseElement("office:binary-data"));
-	mBitmapStyles.push_back(new TagCloseElement("draw:fill-image"));
+	mBitmapStyles.push_back(TagOpenElement("office:binary-data"));
+	mBitmapStyles.push_back(BinaryDataElement(data));
+	mBitmapStyles.push_back(TagCloseElement("office:binary-data"));
+	mBitmapStyles.push_back(TagCloseElement("draw:fill-image"));
 	return name;
 }
 
@@ -202,13 +206,15 @@ librevenge::RVNGString GraphicStyleManager::getStyleNameForGradient(librevenge::
 		if (style[wh[i]])
 			pList.insert(wh[i], style[wh[i]]->getStr());
 	}
-	librevenge::RVNGString hashKey = pList.getPropString();
-	if (mGradientNameMap.find(hashKey) != mGradientNameMap.end())
-		return mGradientNameMap.find(hashKey)->second;
+	mKey.clear();
+	mKey.append(pList);
+	librevenge::RVNGString const *styleName=mGradientNameMap.find(mKey);
+	if (styleName)
+		return *styleName;
 
 	librevenge::RVNGString name;
 	name.sprintf("Gradient_%i", (int) mGradientNameMap.size());
-	mGradientNameMap[hashKey]=name;
+	mGradientNameMap.insert(mKey, name);
 
 	TagOpenElement *openElement = new TagOpenElement("draw:gradient");
 	openElement->addAttribute("draw:name", name);
@@ -253,7 +259,7 @@ librevenge::RVNGString GraphicStyleManager::getStyleNameForGradient(librevenge::
 	}
 
 	mGradientStyles.push_back(openElement);
-	mGradientStyles.push_back(new TagCloseElement("draw:gradient"));
+	mGradientStyles.push_back(TagCloseElement("draw:gradient"));
 	return name;
 }
 
@@ -276,13 +282,15 @@ librevenge::RVNGString GraphicStyleManager::getStyleNameForMarker(librevenge::RV
 		if (style["draw:marker-end-viewbox"])
 			pList.insert("svg:viewBox", style["draw:marker-end-viewbox"]->getStr());
 	}
-	librevenge::RVNGString hashKey = pList.getPropString();
-	if (mMarkerNameMap.find(hashKey) != mMarkerNameMap.end())
-		return mMarkerNameMap.find(hashKey)->second;
+	mKey.clear();
+	mKey.append(pList);
+	librevenge::RVNGString const *styleName=mMarkerNameMap.find(mKey);
+	if (styleName)
+		return *styleName;
 
 	librevenge::RVNGString name;
 	name.sprintf("Marker_%i", (int) mMarkerNameMap.size());
-	mMarkerNameMap[hashKey]=name;
+	mMarkerNameMap.insert(mKey, name);
 
 	TagOpenElement *openElement = new TagOpenElement("draw:marker");
 	openElement->addAttribute("draw:name", name);
@@ -290,7 +298,7 @@ librevenge::RVNGString GraphicStyleManager::getStyleNameForMarker(librevenge::RV
 		openElement->addAttribute("svg:viewBox", pList["svg:viewBox"]->getStr());
 	openElement->addAttribute("svg:d", pList["svg:d"]->getStr());
 	mMarkerStyles.push_back(openElement);
-	mMarkerStyles.push_back(new TagCloseElement("draw:marker"));
+	mMarkerStyles.push_back(TagCloseElement("draw:marker"));
 	return name;
 }
 
@@ -338,13 +346,15 @@ librevenge::RVNGString GraphicStyleManager::getStyleNameForOpacity(librevenge::R
 			pList.insert(wh[i], style[wh[i]]->getStr());
 	}
 
-	librevenge::RVNGString hashKey = pList.getPropString();
-	if (mOpacityNameMap.find(hashKey) != mOpacityNameMap.end())
-		return mOpacityNameMap.find(hashKey)->second;
+	mKey.clear();
+	mKey.append(pList);
+	librevenge::RVNGString const *styleName=mOpacityNameMap.find(mKey);
+	if (styleName)
+		return *styleName;
 
 	librevenge::RVNGString name;
 	name.sprintf("Transparency_%i", (int) mOpacityNameMap.size());
-	mOpacityNameMap[hashKey]=name;
+	mOpacityNameMap.insert(mKey, name);
 
 	TagOpenElement *openElement = new TagOpenElement("draw:opacity");
 	openElement->addAttribute("draw:name", name);
@@ -361,7 +371,7 @@ librevenge::RVNGString GraphicStyleManager::getStyleNameForOpacity(librevenge::R
 		openElement->addAttribute("draw:end", pList["draw:end"]->getStr());
 
 	mOpacityStyles.push_back(openElement);
-	mOpacityStyles.push_back(new TagCloseElement("draw:opacity"));
+	mOpacityStyles.push_back(TagCloseElement("draw:opacity"));
 	return name;
 }
 
@@ -382,13 +392,15 @@ librevenge::RVNGString GraphicStyleManager::getStyleNameForStrokeDash(librevenge
 		pList.insert("draw:dots2", style["draw:dots2"]->getStr());
 	if (style["draw:dots2-length"])
 		pList.insert("draw:dots2-length", style["draw:dots2-length"]->getStr());
-	librevenge::RVNGString hashKey = pList.getPropString();
-	if (mStrokeDashNameMap.find(hashKey) != mStrokeDashNameMap.end())
-		return mStrokeDashNameMap.find(hashKey)->second;
+	mKey.clear();
+	mKey.append(pList);
+	librevenge::RVNGString const *styleName=mStrokeDashNameMap.find(mKey);
+	if (styleName)
+		return *styleName;
 
 	librevenge::RVNGString name;
 	name.sprintf("Dash_%i", (int) mStrokeDashNameMap.size());
-	mStrokeDashNameMap[hashKey]=name;
+	mStrokeDashNameMap.insert(mKey, name);
 
 	TagOpenElement *openElement = new TagOpenElement("draw:stroke-dash");
 	openElement->addAttribute("draw:name", name);
@@ -404,7 +416,7 @@ librevenge::RVNGString GraphicStyleManager::getStyleNameForStrokeDash(librevenge
 	if (pList["draw:dots2-length"])
 		openElement->addAttribute("draw:dots2-length", pList["draw:dots2-length"]->getStr());
 	mStrokeDashStyles.push_back(openElement);
-	mStrokeDashStyles.push_back(new TagCloseElement("draw:stroke-dash"));
+	mStrokeDashStyles.push_back(TagCloseElement("draw:stroke-dash"));
 	return name;
 }
 
@@ -31,6 +31,7 @@
 #include "FilterInternal.hxx"
 
 #include "Style.hxx"
+#include "StyleHash.hxx"
 
 class OdfDocumentHandler;
 
@@ -54,13 +55,18 @@ class GraphicStyleManager : public StyleManager
 {
 public:
 	GraphicStyleManager() : mBitmapStyles(), mGradientStyles(), mMarkerStyles(), mOpacityStyles(),
-		mStrokeDashStyles(), mStyles(), mBitmapNameMap(), mGradientNameMap(), mMarkerNameMap(),
-		mOpacityNameMap(), mStrokeDashNameMap(), mStyleNameMap() {}
+		mStrokeDashStyles(), mStyles(), mKey(), mBitmapNameMap(), mGradientNameMap(), mMarkerNameMap(),
+		mOpacityNameMap(), mStrokeDashNameMap(), mStyleNameMap(), mpBinaryStore(0) {}
 	virtual ~GraphicStyleManager()
 	{
 		clean();
 	}
 	void clean();
+	//! sets the store used to share the bitmap data with the other images
+	void setBinaryStore(libodfgen::BinaryStore *store)
+	{
+		mpBinaryStore=store;
+	}
 	//! write all
 	void write(OdfDocumentHandler *pHandler) const
 	{
@@ -95,18 +101,26 @@ protected:
 	libodfgen::DocumentElementVector mStrokeDashStyles;
 	std::vector<shared_ptr<GraphicStyle> > mStyles;
 
-	// bitmap content -> style name
-	std::map<librevenge::RVNGString, librevenge::RVNGString> mBitmapNameMap;
+	// the key used to find a style
+	libodfgen::StyleKey mKey;
+	// bitmap hash -> style name
+	std::map<libodfgen::BinaryHash, librevenge::RVNGString> mBitmapNameMap;
 	// gradient hash -> style name
-	std::map<librevenge::RVNGString, librevenge::RVNGString> mGradientNameMap;
+	libodfgen::StyleKeyMap<librevenge::RVNGString> mGradientNameMap;
 	// marker hash -> style name
-	std::map<librevenge::RVNGString, librevenge::RVNGString> mMarkerNameMap;
+	libodfgen::StyleKeyMap<librevenge::RVNGString> mMarkerNameMap;
 	// opacity hash -> style name
-	std::map<librevenge::RVNGString, librevenge::RVNGString> mOpacityNameMap;
+	libodfgen::StyleKeyMap<librevenge::RVNGString> mOpacityNameMap;
 	// stroke dash hash -> style name
-	std::map<librevenge::RVNGString, librevenge::RVNGString> mStrokeDashNameMap;
+	libodfgen::StyleKeyMap<librevenge::RVNGString> mStrokeDashNameMap;
 	// style hash -> style name
-	std::map<librevenge::RVNGString, librevenge::RVNGString> mStyleNameMap;
+	libodfgen::StyleKeyMap<librevenge::RVNGString> mStyleNameMap;
+	// the store of the binary data (if set)
+	libodfgen::BinaryStore *mpBinaryStore;
+
+private:
+	GraphicStyleManager(GraphicStyleManager const &orig);
+	GraphicStyleManager &operator=(GraphicStyleManager const &orig);
 };
 
 
@@ -29,25 +29,42 @@
 
 void InternalHandler::startElement(const char *psName, const librevenge::RVNGPropertyList &xPropList)
 {
-	TagOpenElement *element = new TagOpenElement(psName);
+	TagOpenElement element(psName);
 	librevenge::RVNGPropertyList::Iter i(xPropList);
 	for (i.rewind(); i.next();)
 	{
 		// filter out librevenge elements
 		if (strncmp(i.key(), "librevenge:", 11))
-			element->addAttribute(i.key(), i()->getStr());
+			element.addAttribute(i.key(), i()->getStr());
+	}
+	mpElements->push_back(element);
+}
+
+void InternalHandler::startElement(const char *psName, const OdfAttribute *pAttributes, unsigned long numAttributes)
+{
+	TagOpenElement element(psName);
+	for (unsigned long i=0; i<numAttributes; ++i)
+	{
+		// filter out librevenge elements
+		if (strncmp(pAttributes[i].name, "librevenge:", 11))
+			element.addAttribute(pAttributes[i].name, pAttributes[i].value, pAttributes[i].length, pAttributes[i].escaped);
 	}
 	mpElements->push_back(element);
 }
 
 void InternalHandler::endElement(const char *psName)
 {
-	mpElements->push_back(new TagCloseElement(psName));
+	mpElements->addCloseElement(psName);
 }
 
 void InternalHandler::characters(const librevenge::RVNGString &sCharacters)
 {
-	mpElements->push_back(new CharDataElement(sCharacters.cstr()));
+	mpElements->addCharacters(sCharacters);
+}
+
+void InternalHandler::characters(const char *psCharacters, unsigned long length)
+{
+	mpElements->addCharacters(psCharacters, length);
 }
 
 /* vim:set shiftwidth=4 softtabstop=4 noexpandtab: */
@@ -32,7 +32,9 @@
 
 #include "FilterInternal.hxx"
 
-class InternalHandler : public OdfDocumentHandler
+/** handler which stores the received elements in a DocumentElementVector,
+	it keeps the escaped flags of the attributes sent by a generator */
+class InternalHandler : public OdfFastDocumentHandler
 {
 public:
 	InternalHandler(libodfgen::DocumentElementVector *elements) :mpElements(elements)
@@ -43,8 +45,10 @@ public:
 	void startDocument() {};
 	void endDocument() {};
 	void startElement(const char *psName, const librevenge::RVNGPropertyList &xPropList);
+	void startElement(const char *psName, const OdfAttribute *pAttributes, unsigned long numAttributes);
 	void endElement(const char *psName);
 	void characters(const librevenge::RVNGString &sCharacters);
+	void characters(const char *psCharacters, unsigned long length);
 private:
 	InternalHandler(const InternalHandler &);
 	InternalHandler &operator=(const InternalHandler &);
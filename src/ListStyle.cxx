@@ -43,13 +43,13 @@ void OrderedListLevelStyle::write(OdfDocumentHandler *pHandler, int iLevel) cons
 	{
 		librevenge::RVNGString sEscapedString;
 		sEscapedString.appendEscapedXML(mPropList["style:num-prefix"]->getStr());
-		listLevelStyleOpen.addAttribute("style:num-prefix", sEscapedString);
+		listLevelStyleOpen.addEscapedAttribute("style:num-prefix", sEscapedString);
 	}
 	if (mPropList["style:num-suffix"])
 	{
 		librevenge::RVNGString sEscapedString;
 		sEscapedString.appendEscapedXML(mPropList["style:num-suffix"]->getStr());
-		listLevelStyleOpen.addAttribute("style:num-suffix", sEscapedString);
+		listLevelStyleOpen.addEscapedAttribute("style:num-suffix", sEscapedString);
 	}
 	if (mPropList["style:num-format"])
 		listLevelStyleOpen.addAttribute("style:num-format", mPropList["style:num-format"]->getStr());
@@ -102,7 +102,7 @@ void UnorderedListLevelStyle::write(OdfDocumentHandler *pHandler, int iLevel) co
 			sEscapedString.appendEscapedXML(i());
 		else
 			sEscapedString.append('.');
-		listLevelStyleOpen.addAttribute("text:bullet-char", sEscapedString);
+		listLevelStyleOpen.addEscapedAttribute("text:bullet-char", sEscapedString);
 
 	}
 	else
@@ -0,0 +1,184 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* libodfgen
+ * Version: MPL 2.0 / LGPLv2.1+
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU Lesser General Public License Version 2.1 or later
+ * (LGPLv2.1+), in which case the provisions of the LGPLv2.1+ are
+ * applicable instead of those above.
+ *
+ * For further information visit http://libwpd.sourceforge.net
+ */
+
+#include <string.h>
+
+#include "FilterInternal.hxx"
+
+#include "NameTable.hxx"
+
+namespace libodfgen
+{
+namespace
+{
+//! the list of names, must be sorted (strcmp order)
+static char const *const s_names[]=
+{
+	"calcext:value-type", "chart:attached-axis", "chart:auto-position", "chart:auto-size",
+	"chart:axis", "chart:axis-position", "chart:categories", "chart:chart", "chart:class",
+	"chart:column-mapping", "chart:data-point", "chart:data-source-has-labels", "chart:dimension",
+	"chart:display-label", "chart:domain", "chart:error-indicator", "chart:floor", "chart:grid",
+	"chart:include-hidden-cells", "chart:label-cell-address", "chart:legend", "chart:legend-align",
+	"chart:legend-position", "chart:logarithmic", "chart:mean-value", "chart:name",
+	"chart:plot-area", "chart:repeated", "chart:reverse-direction", "chart:right-angled-axes",
+	"chart:row-mapping", "chart:series", "chart:style-name", "chart:title",
+	"chart:treat-empty-cells", "chart:values-cell-range-address", "chart:wall",
+	"config:config-item", "config:config-item-set", "config:name", "config:type",
+	"dr3d:ambient-color", "dr3d:distance", "dr3d:focal-length", "dr3d:lighting-mode",
+	"dr3d:projection", "dr3d:shade-mode", "dr3d:shadow-slant", "dr3d:transform", "dr3d:vpn",
+	"dr3d:vrp", "dr3d:vup", "draw:angle", "draw:blue", "draw:border", "draw:chain-next-name",
+	"draw:color-mode", "draw:contrast", "draw:corner-radius", "draw:cx", "draw:cy",
+	"draw:distance", "draw:dots1", "draw:dots1-length", "draw:dots2", "draw:dots2-length",
+	"draw:ellipse", "draw:end", "draw:end-color", "draw:end-intensity", "draw:fill",
+	"draw:fill-color", "draw:fill-gradient-name", "draw:fill-image", "draw:fill-image-height",
+	"draw:fill-image-name", "draw:fill-image-ref-point", "draw:fill-image-ref-point-x",
+	"draw:fill-image-ref-point-y", "draw:fill-image-width", "draw:frame", "draw:g", "draw:gamma",
+	"draw:gradient", "draw:green", "draw:image", "draw:layer", "draw:layer-set", "draw:line",
+	"draw:luminance", "draw:marker", "draw:marker-end", "draw:marker-end-center",
+	"draw:marker-end-path", "draw:marker-end-viewbox", "draw:marker-end-width",
+	"draw:marker-start", "draw:marker-start-center", "draw:marker-start-path",
+	"draw:marker-start-viewbox", "draw:marker-start-width", "draw:master-page-name",
+	"draw:measure", "draw:mirror-horizontal", "draw:mirror-vertical", "draw:name", "draw:object",
+	"draw:object-ole", "draw:ole-draw-aspect", "draw:opacity", "draw:opacity-name", "draw:page",
+	"draw:page-number", "draw:page-thumbnail", "draw:path", "draw:rect", "draw:red", "draw:shadow",
+	"draw:shadow-color", "draw:shadow-offset-x", "draw:shadow-offset-y", "draw:shadow-opacity",
+	"draw:show-unit", "draw:start", "draw:start-color", "draw:start-intensity", "draw:stroke",
+	"draw:stroke-dash", "draw:stroke-linejoin", "draw:style", "draw:style-name", "draw:text-box",
+	"draw:textarea-horizontal-align", "draw:textarea-vertical-align", "draw:transform",
+	"draw:z-index", "fo:background-color", "fo:border", "fo:border-bottom", "fo:border-left",
+	"fo:border-right", "fo:border-top", "fo:break-before", "fo:clip", "fo:color",
+	"fo:column-count", "fo:column-gap", "fo:country", "fo:font-family", "fo:font-size",
+	"fo:font-style", "fo:font-variant", "fo:font-weight", "fo:hyphenate", "fo:keep-together",
+	"fo:language", "fo:letter-spacing", "fo:margin-bottom", "fo:margin-left", "fo:margin-right",
+	"fo:margin-top", "fo:max-height", "fo:max-width", "fo:min-height", "fo:min-width",
+	"fo:padding", "fo:padding-bottom", "fo:padding-left", "fo:padding-right", "fo:padding-top",
+	"fo:page-height", "fo:page-width", "fo:script", "fo:text-align", "fo:text-indent",
+	"fo:text-shadow", "fo:text-transform", "manifest:file-entry", "manifest:full-path",
+	"manifest:manifest", "manifest:media-type", "manifest:version", "meta:generator", "meta:name",
+	"meta:template", "meta:user-defined", "number:automatic-order", "number:boolean",
+	"number:boolean-style", "number:country", "number:currency-style", "number:currency-symbol",
+	"number:decimal-places", "number:grouping", "number:language", "number:min-denominator-digits",
+	"number:min-exponent-digits", "number:min-integer-digits", "number:min-numerator-digits",
+	"number:number", "number:number-style", "number:style", "number:text", "number:textual",
+	"office:annotation", "office:automatic-styles", "office:binary-data", "office:body",
+	"office:boolean-value", "office:chart", "office:date-value", "office:document",
+	"office:document-content", "office:document-meta", "office:document-settings",
+	"office:document-styles", "office:drawing", "office:font-face-decls", "office:master-styles",
+	"office:meta", "office:mimetype", "office:presentation", "office:settings",
+	"office:spreadsheet", "office:string-value", "office:styles", "office:text",
+	"office:time-value", "office:value", "office:value-type", "office:version",
+	"officeooo:annotation", "ooo:view-settings", "presentation:class",
+	"presentation:display-date-time", "presentation:display-footer", "presentation:display-header",
+	"presentation:display-page-number", "presentation:notes", "presentation:style-name",
+	"style:adjustment", "style:apply-style-name", "style:background-transparency",
+	"style:border-line-width", "style:border-line-width-bottom", "style:border-line-width-left",
+	"style:border-line-width-right", "style:border-line-width-top", "style:cell-protect",
+	"style:chart-properties", "style:class", "style:color", "style:column", "style:column-sep",
+	"style:column-width", "style:columns", "style:condition", "style:country-asian",
+	"style:country-complex", "style:data-style-name", "style:default-outline-level",
+	"style:default-style", "style:direction", "style:display-name", "style:distance-after-sep",
+	"style:distance-before-sep", "style:drawing-page-properties", "style:family",
+	"style:font-charset", "style:font-face", "style:font-family-generic", "style:font-name",
+	"style:font-name-asian", "style:font-name-complex", "style:font-pitch", "style:font-relief",
+	"style:font-size-asian", "style:font-size-complex", "style:font-style-asian",
+	"style:font-style-complex", "style:font-weight-asian", "style:font-weight-complex",
+	"style:footer", "style:footer-first", "style:footer-last", "style:footer-left",
+	"style:footnote-max-height", "style:footnote-sep", "style:graphic-properties", "style:header",
+	"style:header-first", "style:header-last", "style:header-left", "style:height",
+	"style:horizontal-pos", "style:horizontal-rel", "style:justify-single-word",
+	"style:language-asian", "style:language-complex", "style:legend-expansion",
+	"style:legend-expansion-aspect-ratio", "style:letter-kerning", "style:line-break",
+	"style:list-level-properties", "style:list-style-name", "style:map", "style:master-page",
+	"style:master-page-name", "style:min-row-height", "style:mirror", "style:name",
+	"style:num-format", "style:num-prefix", "style:num-suffix", "style:page-layout",
+	"style:page-layout-name", "style:page-layout-properties", "style:paragraph-properties",
+	"style:parent-style-name", "style:position", "style:print-orientation",
+	"style:punctuation-wrap", "style:rel-height", "style:rel-width", "style:repeat",
+	"style:rfc-language-tag", "style:rotation-angle", "style:row-height", "style:run-through",
+	"style:script-type", "style:section-properties", "style:style", "style:tab-stop",
+	"style:tab-stop-distance", "style:tab-stops", "style:table-cell-properties",
+	"style:table-column-properties", "style:table-properties", "style:table-row-properties",
+	"style:text-align-source", "style:text-autospace", "style:text-blinking",
+	"style:text-emphasize", "style:text-line-through-style", "style:text-line-through-type",
+	"style:text-outline", "style:text-position", "style:text-properties",
+	"style:text-rotation-angle", "style:text-scale", "style:text-underline-color",
+	"style:text-underline-style", "style:text-underline-type", "style:text-underline-width",
+	"style:use-window-font-color", "style:vertical-align", "style:vertical-pos",
+	"style:vertical-rel", "style:width", "style:wrap", "style:writing-mode", "svg:cx", "svg:cy",
+	"svg:d", "svg:fill-rule", "svg:font-face-format", "svg:font-face-src", "svg:font-face-uri",
+	"svg:font-family", "svg:height", "svg:id", "svg:linearGradient", "svg:points",
+	"svg:radialGradient", "svg:rx", "svg:ry", "svg:stop-color", "svg:stop-opacity", "svg:string",
+	"svg:stroke-color", "svg:stroke-linecap", "svg:stroke-linejoin", "svg:stroke-opacity",
+	"svg:stroke-width", "svg:viewBox", "svg:width", "svg:x", "svg:x1", "svg:x2", "svg:y", "svg:y1",
+	"svg:y2", "table:align", "table:border-model", "table:cell-range", "table:cell-range-address",
+	"table:covered-table-cell", "table:display", "table:formula", "table:name",
+	"table:number-columns-repeated", "table:number-columns-spanned", "table:number-rows-repeated",
+	"table:number-rows-spanned", "table:shapes", "table:style-name", "table:table",
+	"table:table-cell", "table:table-column", "table:table-header-rows", "table:table-row",
+	"table:value-type", "text:a", "text:anchor-page-number", "text:anchor-type",
+	"text:bullet-char", "text:citation-body-style-name", "text:citation-style-name",
+	"text:continue-numbering", "text:display", "text:display-levels", "text:footnotes-position",
+	"text:h", "text:id", "text:increment", "text:label", "text:level", "text:line-break",
+	"text:linenumbering-configuration", "text:list", "text:list-item",
+	"text:list-level-style-bullet", "text:list-level-style-number", "text:list-style",
+	"text:master-page-name", "text:min-label-distance", "text:min-label-width", "text:name",
+	"text:note", "text:note-body", "text:note-citation", "text:note-class",
+	"text:notes-configuration", "text:number-lines", "text:number-position", "text:offset",
+	"text:outline-level", "text:p", "text:page-number", "text:s", "text:section",
+	"text:select-page", "text:space-before", "text:span", "text:start-numbering-at",
+	"text:start-value", "text:style-name", "text:tab", "xlink:actuate", "xlink:href", "xlink:show",
+	"xlink:title", "xlink:type", "xml:id", "xmlns:calcext", "xmlns:chart", "xmlns:config",
+	"xmlns:dc", "xmlns:dr3d", "xmlns:draw", "xmlns:fo", "xmlns:form", "xmlns:manifest",
+	"xmlns:math", "xmlns:meta", "xmlns:number", "xmlns:of", "xmlns:office", "xmlns:officeooo",
+	"xmlns:ooo", "xmlns:presentation", "xmlns:script", "xmlns:style", "xmlns:svg", "xmlns:table",
+	"xmlns:tableooo", "xmlns:text", "xmlns:xlink",
+};
+}
+
+unsigned short NameTable::size()
+{
+	return (unsigned short) ODFGEN_N_ELEMENTS(s_names);
+}
+
+unsigned short NameTable::getAtom(char const *name)
+{
+	if (!name) return 0;
+	size_t low=0, high=ODFGEN_N_ELEMENTS(s_names);
+	while (low<high)
+	{
+		size_t const mid=(low+high)/2;
+		int const cmp=strcmp(name, s_names[mid]);
+		if (cmp==0)
+			return (unsigned short)(mid+1);
+		if (cmp<0)
+			high=mid;
+		else
+			low=mid+1;
+	}
+	return 0;
+}
+
+char const *NameTable::getName(unsigned short atom)
+{
+	if (atom==0 || atom>ODFGEN_N_ELEMENTS(s_names))
+		return 0;
+	return s_names[atom-1];
+}
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 noexpandtab: */
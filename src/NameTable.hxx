@@ -0,0 +1,43 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* libodfgen
+ * Version: MPL 2.0 / LGPLv2.1+
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU Lesser General Public License Version 2.1 or later
+ * (LGPLv2.1+), in which case the provisions of the LGPLv2.1+ are
+ * applicable instead of those above.
+ *
+ * For further information visit http://libwpd.sourceforge.net
+ */
+
+#ifndef _NAMETABLE_HXX_
+#define _NAMETABLE_HXX_
+
+namespace libodfgen
+{
+/** the table of the ODF tag and attribute names created by the generators
+
+	Each name of the table is identified by a small integer (its atom); 0 means
+	that the name is not in the table. The table is constant, so it can be
+	shared by all the generators without any lock.
+ */
+class NameTable
+{
+public:
+	//! returns the atom corresponding to a name or 0 if the name is not in the table
+	static unsigned short getAtom(char const *name);
+	//! returns the name corresponding to an atom or 0 if the atom is not valid
+	static char const *getName(unsigned short atom);
+	//! returns the number of names in the table
+	static unsigned short size();
+};
+}
+
+#endif
+/* vim:set shiftwidth=4 softtabstop=4 noexpandtab: */
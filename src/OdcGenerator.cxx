@@ -74,6 +74,11 @@ public:
 	~OdcGeneratorPrivate();
 
 	bool writeTargetDocument(OdfDocumentHandler *pHandler, OdfStreamType streamType);
+	//! returns the document mime type
+	char const *getDocumentMimeType() const
+	{
+		return "application/vnd.oasis.opendocument.chart";
+	}
 	void _writeStyles(OdfDocumentHandler *pHandler);
 	void _writeAutomaticStyles(OdfDocumentHandler *pHandler, OdfStreamType streamType);
 
@@ -336,11 +341,11 @@ bool OdcGeneratorPrivate::writeTargetDocument(OdfDocumentHandler *pHandler, OdfS
 		pHandler->startDocument();
 		TagOpenElement manifestElement("manifest:manifest");
 		manifestElement.addAttribute("xmlns:manifest", "urn:oasis:names:tc:opendocument:xmlns:manifest:1.0");
-		manifestElement.addAttribute("manifest:version", "1.2", true);
+		manifestElement.addAttribute("manifest:version", "1.2");
 		manifestElement.write(pHandler);
 
 		TagOpenElement mainFile("manifest:file-entry");
-		mainFile.addAttribute("manifest:media-type", "application/vnd.oasis.opendocument.chart");
+		mainFile.addAttribute("manifest:media-type", getDocumentMimeType());
 		mainFile.addAttribute("manifest:full-path", "/");
 		mainFile.write(pHandler);
 		TagCloseElement("manifest:file-entry").write(pHandler);
@@ -378,7 +383,7 @@ bool OdcGeneratorPrivate::writeTargetDocument(OdfDocumentHandler *pHandler, OdfS
 	docContentPropList.insert("xmlns:style", "urn:oasis:names:tc:opendocument:xmlns:style:1.0");
 	docContentPropList.insert("office:version", librevenge::RVNGPropertyFactory::newStringProp("1.2"));
 	if (streamType == ODF_FLAT_XML)
-		docContentPropList.insert("office:mimetype", "application/vnd.oasis.opendocument.chart");
+		docContentPropList.insert("office:mimetype", getDocumentMimeType());
 	pHandler->startElement(documentType.c_str(), docContentPropList);
 
 	// write out the metadata
@@ -587,7 +592,7 @@ void OdcGenerator::closeChart()
 	if (!mpImpl->mChartDocumentStates.top().mbChartOpened)
 		return;
 	mpImpl->mChartDocumentStates.pop();
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("chart:chart"));
+	mpImpl->getCurrentStorage()->push_back(TagCloseElement("chart:chart"));
 }
 
 void OdcGenerator::openChartTextObject(const librevenge::RVNGPropertyList &propList)
@@ -658,7 +663,7 @@ void OdcGenerator::closeChartTextObject()
 		return;
 	std::string wh = mpImpl->mChartDocumentStates.top().mCharTextObjectType;
 	mpImpl->mChartDocumentStates.pop();
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement(wh.c_str()));
+	mpImpl->getCurrentStorage()->push_back(TagCloseElement(wh.c_str()));
 }
 
 void OdcGenerator::openChartPlotArea(const librevenge::RVNGPropertyList &propList)
@@ -712,7 +717,7 @@ void OdcGenerator::openChartPlotArea(const librevenge::RVNGPropertyList &propLis
 			if (child["librevenge:chart-id"])
 				childElement->addAttribute("chart:style-name",mpImpl->getChartStyleName(child["librevenge:chart-id"]->getInt()));
 			mpImpl->getCurrentStorage()->push_back(childElement);
-			mpImpl->getCurrentStorage()->push_back(new TagCloseElement("chart:categories"));
+			mpImpl->getCurrentStorage()->push_back(TagCloseElement("chart:categories"));
 		}
 		else if (type=="floor" || type=="wall")
 		{
@@ -723,7 +728,7 @@ void OdcGenerator::openChartPlotArea(const librevenge::RVNGPropertyList &propLis
 			if (child["librevenge:chart-id"])
 				childElement->addAttribute("chart:style-name",mpImpl->getChartStyleName(child["librevenge:chart-id"]->getInt()));
 			mpImpl->getCurrentStorage()->push_back(childElement);
-			mpImpl->getCurrentStorage()->push_back(new TagCloseElement(what.c_str()));
+			mpImpl->getCurrentStorage()->push_back(TagCloseElement(what.c_str()));
 		}
 		else
 		{
@@ -737,7 +742,7 @@ void OdcGenerator::closeChartPlotArea()
 	if (!mpImpl->mChartDocumentStates.top().mbChartPlotAreaOpened)
 		return;
 	mpImpl->mChartDocumentStates.pop();
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("chart:plot-area"));
+	mpImpl->getCurrentStorage()->push_back(TagCloseElement("chart:plot-area"));
 }
 
 void OdcGenerator::insertChartAxis(const librevenge::RVNGPropertyList &propList)
@@ -779,7 +784,7 @@ void OdcGenerator::insertChartAxis(const librevenge::RVNGPropertyList &propList)
 					childElement->addAttribute("table:cell-range", range);
 			}
 			mpImpl->getCurrentStorage()->push_back(childElement);
-			mpImpl->getCurrentStorage()->push_back(new TagCloseElement("chart:categories"));
+			mpImpl->getCurrentStorage()->push_back(TagCloseElement("chart:categories"));
 		}
 		else if (type=="grid")
 		{
@@ -789,7 +794,7 @@ void OdcGenerator::insertChartAxis(const librevenge::RVNGPropertyList &propList)
 			if (child["librevenge:chart-id"])
 				childElement->addAttribute("chart:style-name",mpImpl->getChartStyleName(child["librevenge:chart-id"]->getInt()));
 			mpImpl->getCurrentStorage()->push_back(childElement);
-			mpImpl->getCurrentStorage()->push_back(new TagCloseElement("chart:grid"));
+			mpImpl->getCurrentStorage()->push_back(TagCloseElement("chart:grid"));
 		}
 		else if (type=="title")
 		{
@@ -806,14 +811,14 @@ void OdcGenerator::insertChartAxis(const librevenge::RVNGPropertyList &propList)
 			if (child["librevenge:chart-id"])
 				childElement->addAttribute("chart:style-name",mpImpl->getChartStyleName(child["librevenge:chart-id"]->getInt()));
 			mpImpl->getCurrentStorage()->push_back(childElement);
-			mpImpl->getCurrentStorage()->push_back(new TagCloseElement("chart:title"));
+			mpImpl->getCurrentStorage()->push_back(TagCloseElement("chart:title"));
 		}
 		else
 		{
 			ODFGEN_DEBUG_MSG(("OdcGenerator::insertChartAxis: can not find type of child %d\n", int(c)));
 		}
 	}
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("chart:axis"));
+	mpImpl->getCurrentStorage()->push_back(TagCloseElement("chart:axis"));
 }
 
 void OdcGenerator::openChartSerie(const librevenge::RVNGPropertyList &propList)
@@ -874,7 +879,7 @@ void OdcGenerator::openChartSerie(const librevenge::RVNGPropertyList &propList)
 			if (child["librevenge:chart-id"])
 				childElement->addAttribute("chart:style-name",mpImpl->getChartStyleName(child["librevenge:chart-id"]->getInt()));
 			mpImpl->getCurrentStorage()->push_back(childElement);
-			mpImpl->getCurrentStorage()->push_back(new TagCloseElement("chart:data-point"));
+			mpImpl->getCurrentStorage()->push_back(TagCloseElement("chart:data-point"));
 		}
 		else if (type=="domain")
 		{
@@ -887,7 +892,7 @@ void OdcGenerator::openChartSerie(const librevenge::RVNGPropertyList &propList)
 					childElement->addAttribute("table:cell-range", range);
 			}
 			mpImpl->getCurrentStorage()->push_back(childElement);
-			mpImpl->getCurrentStorage()->push_back(new TagCloseElement("chart:domain"));
+			mpImpl->getCurrentStorage()->push_back(TagCloseElement("chart:domain"));
 		}
 		else if (type=="error-indicator")
 		{
@@ -897,7 +902,7 @@ void OdcGenerator::openChartSerie(const librevenge::RVNGPropertyList &propList)
 			if (child["librevenge:chart-id"])
 				childElement->addAttribute("chart:style-name",mpImpl->getChartStyleName(child["librevenge:chart-id"]->getInt()));
 			mpImpl->getCurrentStorage()->push_back(childElement);
-			mpImpl->getCurrentStorage()->push_back(new TagCloseElement("chart:error-indicator"));
+			mpImpl->getCurrentStorage()->push_back(TagCloseElement("chart:error-indicator"));
 		}
 		else if (type=="mean-value")
 		{
@@ -905,7 +910,7 @@ void OdcGenerator::openChartSerie(const librevenge::RVNGPropertyList &propList)
 			if (child["librevenge:chart-id"])
 				childElement->addAttribute("chart:style-name",mpImpl->getChartStyleName(child["librevenge:chart-id"]->getInt()));
 			mpImpl->getCurrentStorage()->push_back(childElement);
-			mpImpl->getCurrentStorage()->push_back(new TagCloseElement("chart:mean-value"));
+			mpImpl->getCurrentStorage()->push_back(TagCloseElement("chart:mean-value"));
 		}
 		else
 		{
@@ -920,7 +925,7 @@ void OdcGenerator::closeChartSerie()
 	if (!state.mbChartSerieOpened)
 		return;
 	state.mbChartSerieOpened=false;
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("chart:series"));
+	mpImpl->getCurrentStorage()->push_back(TagCloseElement("chart:series"));
 }
 
 // -------------------------------
@@ -0,0 +1,49 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* libodfgen
+ * Version: MPL 2.0 / LGPLv2.1+
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU Lesser General Public License Version 2.1 or later
+ * (LGPLv2.1+), in which case the provisions of the LGPLv2.1+ are
+ * applicable instead of those above.
+ *
+ * For further information visit http://libwpd.sourceforge.net
+ */
+
+#include <vector>
+
+#include <libodfgen/libodfgen.hxx>
+
+void OdfFastDocumentHandler::startElement(const char *psName, const librevenge::RVNGPropertyList &xPropList)
+{
+	std::vector<librevenge::RVNGString> names, values;
+	librevenge::RVNGPropertyList::Iter i(xPropList);
+	for (i.rewind(); i.next();)
+	{
+		if (!i()) continue;
+		names.push_back(i.key());
+		values.push_back(i()->getStr());
+	}
+	std::vector<OdfAttribute> attributes(names.size());
+	for (size_t a=0; a<names.size(); ++a)
+	{
+		attributes[a].name=names[a].cstr();
+		attributes[a].value=values[a].cstr();
+		attributes[a].length=values[a].size();
+		attributes[a].escaped=false;
+	}
+	startElement(psName, attributes.empty() ? 0 : &attributes[0], (unsigned long) attributes.size());
+}
+
+void OdfFastDocumentHandler::characters(const librevenge::RVNGString &sCharacters)
+{
+	characters(sCharacters.cstr(), sCharacters.size());
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 noexpandtab: */
@@ -32,14 +32,18 @@
 
 #include <limits>
 #include <string>
+#include <vector>
 
 #include <librevenge/librevenge.h>
 
+#include "libodfgen/OdfXMLWriter.hxx"
+
 #include "DocumentElement.hxx"
 #include "GraphicFunctions.hxx"
 #include "InternalHandler.hxx"
 #include "ListStyle.hxx"
 #include "TableStyle.hxx"
+#include "TaskRunner.hxx"
 
 #include "OdfGenerator.hxx"
 
@@ -50,7 +54,7 @@
 using namespace libodfgen;
 
 OdfGenerator::OdfGenerator() :
-	mpCurrentStorage(&mBodyStorage), mStorageStack(), mMetaDataStorage(), mBodyStorage(),
+	mStringPool(), mBinaryStore(), mpCurrentStorage(&mBodyStorage), mStorageStack(), mMetaDataStorage(), mBodyStorage(),
 	mPageSpanManager(), mFontManager(), mGraphicManager(), mSpanManager(),
 	mParagraphManager(), mListManager(), mTableManager(),
 	mbInHeaderFooter(false), mbInMasterPage(false),
@@ -60,11 +64,13 @@ OdfGenerator::OdfGenerator() :
 	mLayerNameStack(), mLayerNameSet(), mLayerNameMap(),
 	mGraphicStyle(),
 	mIdChartMap(), mIdChartNameMap(),
-	mDocumentStreamHandlers(),
-	miObjectNumber(1), mNameObjectMap(),
-	mImageHandlers(), mObjectHandlers(),
+	mDocumentStreamHandlers(), mbContentStreaming(false),
+	mpPackageWriter(0), mbParallelWriting(false),
+	miObjectNumber(1), mNameObjectMap(), mbExternalPictures(false), mNamePictureMap(),
+	mbAsyncImageConversion(false), mImageConversions(), mImageHandlers(), mObjectHandlers(), mConvertedObjectCache(16),
 	mCurrentParaIsHeading(false)
 {
+	mGraphicManager.setBinaryStore(&mBinaryStore);
 }
 
 OdfGenerator::~OdfGenerator()
@@ -114,9 +120,9 @@ void OdfGenerator::setDocumentMetaData(const librevenge::RVNGPropertyList &propL
 		{
 			if (strncmp(i.key(), "meta:generator", 14))
 			{
-				mMetaDataStorage.push_back(new TagOpenElement(i.key()));
-				mMetaDataStorage.push_back(new CharDataElement(i()->getStr().cstr()));
-				mMetaDataStorage.push_back(new TagCloseElement(i.key()));
+				mMetaDataStorage.push_back(TagOpenElement(i.key()));
+				mMetaDataStorage.push_back(CharDataElement(i()->getStr().cstr()));
+				mMetaDataStorage.push_back(TagCloseElement(i.key()));
 			}
 			else
 			{
@@ -132,7 +138,7 @@ void OdfGenerator::setDocumentMetaData(const librevenge::RVNGPropertyList &propL
 			element->addAttribute("xlink:title", i()->getStr().cstr());
 			element->addAttribute("xlink:href", "");
 			mMetaDataStorage.push_back(element);
-			mMetaDataStorage.push_back(new TagCloseElement(elementName));
+			mMetaDataStorage.push_back(TagCloseElement(elementName));
 		}
 		else if (strncmp(i.key(), "librevenge:", 11) == 0)
 		{
@@ -145,8 +151,8 @@ void OdfGenerator::setDocumentMetaData(const librevenge::RVNGPropertyList &propL
 				user_defined = user_defined.substr(found+1);
 			element->addAttribute("meta:name", user_defined.c_str());
 			mMetaDataStorage.push_back(element);
-			mMetaDataStorage.push_back(new CharDataElement(i()->getStr().cstr()));
-			mMetaDataStorage.push_back(new TagCloseElement(elementName));
+			mMetaDataStorage.push_back(CharDataElement(i()->getStr().cstr()));
+			mMetaDataStorage.push_back(TagCloseElement(elementName));
 		}
 	}
 
@@ -166,9 +172,9 @@ void OdfGenerator::setDocumentMetaData(const librevenge::RVNGPropertyList &propL
 		generator += ")";
 	}
 
-	mMetaDataStorage.push_back(new TagOpenElement("meta:generator"));
-	mMetaDataStorage.push_back(new CharDataElement(generator.c_str()));
-	mMetaDataStorage.push_back(new TagCloseElement("meta:generator"));
+	mMetaDataStorage.push_back(TagOpenElement("meta:generator"));
+	mMetaDataStorage.push_back(CharDataElement(generator.c_str()));
+	mMetaDataStorage.push_back(TagCloseElement("meta:generator"));
 }
 
 void OdfGenerator::writeDocumentMetaData(OdfDocumentHandler *pHandler)
@@ -181,11 +187,25 @@ void OdfGenerator::writeDocumentMetaData(OdfDocumentHandler *pHandler)
 
 void OdfGenerator::appendFilesInManifest(OdfDocumentHandler *pHandler)
 {
-	std::map<OdfStreamType, OdfDocumentHandler *>::const_iterator iter = mDocumentStreamHandlers.begin();
-	for (; iter != mDocumentStreamHandlers.end(); ++iter)
+	std::vector<OdfStreamType> streamTypes;
+	if (mpPackageWriter)
+	{
+		// a package contains all the files
+		streamTypes.push_back(ODF_CONTENT_XML);
+		streamTypes.push_back(ODF_STYLES_XML);
+		streamTypes.push_back(ODF_META_XML);
+		streamTypes.push_back(ODF_SETTINGS_XML);
+	}
+	else
+	{
+		std::map<OdfStreamType, OdfDocumentHandler *>::const_iterator iter = mDocumentStreamHandlers.begin();
+		for (; iter != mDocumentStreamHandlers.end(); ++iter)
+			streamTypes.push_back(iter->first);
+	}
+	for (size_t i=0; i<streamTypes.size(); ++i)
 	{
 		std::string name("");
-		switch (iter->first)
+		switch (streamTypes[i])
 		{
 		case ODF_CONTENT_XML:
 			name="content.xml";
@@ -224,6 +244,15 @@ void OdfGenerator::appendFilesInManifest(OdfDocumentHandler *pHandler)
 		file.write(pHandler);
 		TagCloseElement("manifest:file-entry").write(pHandler);
 	}
+	std::map<librevenge::RVNGString, PictureContainer>::const_iterator pIt;
+	for (pIt=mNamePictureMap.begin(); pIt!=mNamePictureMap.end(); ++pIt)
+	{
+		TagOpenElement file("manifest:file-entry");
+		file.addAttribute("manifest:media-type",pIt->second.mType);
+		file.addAttribute("manifest:full-path", pIt->first);
+		file.write(pHandler);
+		TagCloseElement("manifest:file-entry").write(pHandler);
+	}
 
 }
 
@@ -273,13 +302,112 @@ bool OdfGenerator::getObjectContent(librevenge::RVNGString const &objectName, Od
 		return false;
 	}
 	pHandler->startDocument();
-	ObjectContainer &object=*(it->second);
-	for (size_t i=0; i<object.mStorage.size(); ++i)
+	it->second->mStorage.write(pHandler);
+	pHandler->endDocument();
+	return true;
+}
+
+namespace
+{
+//! returns the extension of the picture files of a mime type
+char const *getPictureExtension(librevenge::RVNGString const &mimeType)
+{
+	static char const *const extensions[][2]=
+	{
+		{ "image/bmp", "bmp" }, { "image/gif", "gif" }, { "image/jpeg", "jpg" },
+		{ "image/jpg", "jpg" }, { "image/png", "png" }, { "image/svg+xml", "svg" },
+		{ "image/tiff", "tif" }, { "image/x-emf", "emf" }, { "image/emf", "emf" },
+		{ "image/x-wmf", "wmf" }, { "image/wmf", "wmf" }
+	};
+	for (size_t i=0; i<ODFGEN_N_ELEMENTS(extensions); ++i)
 	{
-		if (!object.mStorage[i]) continue;
-		object.mStorage[i]->write(pHandler);
+		if (mimeType==extensions[i][0])
+			return extensions[i][1];
 	}
-	pHandler->endDocument();
+	return "bin";
+}
+
+//! returns true if the data of a mime type are already compressed
+bool isCompressedPicture(librevenge::RVNGString const &mimeType)
+{
+	return mimeType=="image/gif" || mimeType=="image/jpeg" || mimeType=="image/jpg" || mimeType=="image/png";
+}
+}
+
+void OdfGenerator::ConvertedObjectCache::setMaxSize(size_t maxSize)
+{
+	mMaxSize=maxSize;
+	reduce(maxSize);
+}
+
+bool OdfGenerator::ConvertedObjectCache::find(Key const &key, shared_ptr<libodfgen::DocumentElementVector const> &storage)
+{
+	std::map<Key, std::pair<shared_ptr<libodfgen::DocumentElementVector const>, unsigned long> >::iterator it=mObjects.find(key);
+	if (it==mObjects.end())
+	{
+		++mMisses;
+		return false;
+	}
+	++mHits;
+	storage=it->second.first;
+	// the object becomes the most recently used
+	mUsages.erase(it->second.second);
+	it->second.second=++mClock;
+	mUsages[it->second.second]=key;
+	return true;
+}
+
+void OdfGenerator::ConvertedObjectCache::insert(Key const &key, shared_ptr<libodfgen::DocumentElementVector const> const &storage)
+{
+	if (!mMaxSize || mObjects.find(key)!=mObjects.end())
+		return;
+	reduce(mMaxSize-1);
+	unsigned long const usage=++mClock;
+	mObjects[key]=std::make_pair(storage, usage);
+	mUsages[usage]=key;
+}
+
+void OdfGenerator::ConvertedObjectCache::reduce(size_t maxSize)
+{
+	while (mObjects.size()>maxSize && !mUsages.empty())
+	{
+		mObjects.erase(mUsages.begin()->second);
+		mUsages.erase(mUsages.begin());
+	}
+}
+
+librevenge::RVNGString OdfGenerator::addPicture(librevenge::RVNGBinaryData const &data, librevenge::RVNGString const &mimeType)
+{
+	libodfgen::BinaryHash hash;
+	librevenge::RVNGBinaryData const stored=mBinaryStore.insert(data, hash);
+	librevenge::RVNGString name("Pictures/");
+	name.append(hash.str());
+	name.append(".");
+	name.append(getPictureExtension(mimeType));
+	if (mNamePictureMap.find(name)==mNamePictureMap.end())
+		mNamePictureMap.insert(std::make_pair(name, PictureContainer(mimeType, stored)));
+	return name;
+}
+
+librevenge::RVNGStringVector OdfGenerator::getPictureNames() const
+{
+	librevenge::RVNGStringVector res;
+	std::map<librevenge::RVNGString, PictureContainer>::const_iterator it;
+	for (it=mNamePictureMap.begin(); it!=mNamePictureMap.end(); ++it)
+		res.append(it->first);
+	return res;
+}
+
+bool OdfGenerator::getPictureContent(librevenge::RVNGString const &name, librevenge::RVNGBinaryData &data, librevenge::RVNGString &mimeType) const
+{
+	std::map<librevenge::RVNGString, PictureContainer>::const_iterator it=mNamePictureMap.find(name);
+	if (it==mNamePictureMap.end())
+	{
+		ODFGEN_DEBUG_MSG(("OdfGenerator::getPictureContent: can not find picture %s\n", name.cstr()));
+		return false;
+	}
+	data=it->second.mData;
+	mimeType=it->second.mType;
 	return true;
 }
 
@@ -293,10 +421,7 @@ void OdfGenerator::sendStorage(libodfgen::DocumentElementVector const *storage,
 		ODFGEN_DEBUG_MSG(("OdfGenerator::sendStorage: called without storage\n"));
 		return;
 	}
-	for (size_t i=0; i<storage->size(); ++i)
-	{
-		if ((*storage)[i])(*storage)[i]->write(pHandler);
-	}
+	storage->write(pHandler);
 }
 
 void OdfGenerator::pushStorage(libodfgen::DocumentElementVector *newStorage)
@@ -335,13 +460,179 @@ void OdfGenerator::addDocumentHandler(OdfDocumentHandler *pHandler, const OdfStr
 	mDocumentStreamHandlers[streamType] = pHandler;
 }
 
+namespace
+{
+//! a task which writes a document stream in its handler
+class StreamWriterTask : public Task
+{
+public:
+	StreamWriterTask(OdfGenerator &generator, OdfDocumentHandler *pHandler, OdfStreamType streamType)
+		: Task(), mGenerator(generator), mpHandler(pHandler), mStreamType(streamType)
+	{
+	}
+	void run()
+	{
+		mGenerator.writeTargetDocument(mpHandler, mStreamType);
+	}
+private:
+	StreamWriterTask(StreamWriterTask const &);
+	StreamWriterTask &operator=(StreamWriterTask const &);
+	OdfGenerator &mGenerator;
+	OdfDocumentHandler *mpHandler;
+	OdfStreamType mStreamType;
+};
+
+//! a task which writes a XML file of a package in memory
+class PackageFileTask : public Task
+{
+public:
+	//! constructor to write a document stream
+	PackageFileTask(OdfGenerator &generator, char const *name, OdfStreamType streamType)
+		: Task(), mGenerator(generator), mName(name), mStreamType(streamType), mpObject(0), mWriter()
+	{
+	}
+	//! constructor to write an embedded object
+	PackageFileTask(OdfGenerator &generator, char const *name, OdfGenerator::ObjectContainer const *object)
+		: Task(), mGenerator(generator), mName(name), mStreamType(ODF_FLAT_XML), mpObject(object), mWriter()
+	{
+	}
+	void run()
+	{
+		write(&mWriter);
+	}
+	//! writes the file in a handler
+	void write(OdfDocumentHandler *pHandler)
+	{
+		if (!mpObject)
+		{
+			mGenerator.writeTargetDocument(pHandler, mStreamType);
+			return;
+		}
+		pHandler->startDocument();
+		mpObject->mStorage.write(pHandler);
+		pHandler->endDocument();
+	}
+	//! the generator
+	OdfGenerator &mGenerator;
+	//! the file name
+	std::string mName;
+	//! the stream type
+	OdfStreamType mStreamType;
+	//! the embedded object (if the file is an embedded object)
+	OdfGenerator::ObjectContainer const *mpObject;
+	//! the writer used to store the file in memory
+	OdfXMLWriter mWriter;
+private:
+	PackageFileTask(PackageFileTask const &);
+	PackageFileTask &operator=(PackageFileTask const &);
+};
+}
+
 void  OdfGenerator::writeTargetDocuments()
 {
+	runImageConversions();
+	if (mpPackageWriter)
+	{
+		writePackage();
+		return;
+	}
 	std::map<OdfStreamType, OdfDocumentHandler *>::const_iterator iter = mDocumentStreamHandlers.begin();
+	// the spilled body can only be read by one thread
+	if (mbParallelWriting && !mBodyStorage.isSpilled())
+	{
+		// each handler must only be used by one thread
+		std::set<OdfDocumentHandler *> handlers;
+		for (; iter != mDocumentStreamHandlers.end(); ++iter)
+			handlers.insert(iter->second);
+		if (handlers.size()==mDocumentStreamHandlers.size())
+		{
+			std::vector<shared_ptr<StreamWriterTask> > writers;
+			std::vector<Task *> tasks;
+			for (iter = mDocumentStreamHandlers.begin(); iter != mDocumentStreamHandlers.end(); ++iter)
+			{
+				writers.push_back(shared_ptr<StreamWriterTask>(new StreamWriterTask(*this, iter->second, iter->first)));
+				tasks.push_back(writers.back().get());
+			}
+			runTasks(tasks, true);
+			return;
+		}
+		iter = mDocumentStreamHandlers.begin();
+	}
 	for (; iter != mDocumentStreamHandlers.end(); ++iter)
 		writeTargetDocument(iter->second, iter->first);
 }
 
+void OdfGenerator::startContentStreaming()
+{
+	/* the automatic styles are only known at the end of the document and
+	   they must be written before the body in content.xml, so the body
+	   is kept in a temporary file until then */
+	if (mbContentStreaming)
+		mBodyStorage.setSpillThreshold(1<<20);
+}
+
+void OdfGenerator::writePackage()
+{
+	std::vector<shared_ptr<PackageFileTask> > files;
+	writePackageMimeType();
+	files.push_back(shared_ptr<PackageFileTask>(new PackageFileTask(*this, "content.xml", ODF_CONTENT_XML)));
+	files.push_back(shared_ptr<PackageFileTask>(new PackageFileTask(*this, "styles.xml", ODF_STYLES_XML)));
+	// the pictures are added directly, the compressed formats are stored
+	std::map<librevenge::RVNGString, PictureContainer>::const_iterator pIt;
+	for (pIt=mNamePictureMap.begin(); pIt!=mNamePictureMap.end(); ++pIt)
+	{
+		if (!mpPackageWriter->addFile(pIt->first.cstr(), pIt->second.mData.getDataBuffer(), pIt->second.mData.size(),
+		                              !isCompressedPicture(pIt->second.mType)))
+		{
+			ODFGEN_DEBUG_MSG(("OdfGenerator::writePackage: can not add the picture %s\n", pIt->first.cstr()));
+		}
+	}
+	files.push_back(shared_ptr<PackageFileTask>(new PackageFileTask(*this, "meta.xml", ODF_META_XML)));
+	files.push_back(shared_ptr<PackageFileTask>(new PackageFileTask(*this, "settings.xml", ODF_SETTINGS_XML)));
+	std::map<librevenge::RVNGString, ObjectContainer *>::const_iterator it;
+	for (it=mNameObjectMap.begin(); it!=mNameObjectMap.end(); ++it)
+	{
+		if (!it->second || it->second->mIsDir) continue;
+		files.push_back(shared_ptr<PackageFileTask>(new PackageFileTask(*this, it->first.cstr(), it->second)));
+	}
+	files.push_back(shared_ptr<PackageFileTask>(new PackageFileTask(*this, "META-INF/manifest.xml", ODF_MANIFEST_XML)));
+
+	if (mbParallelWriting)
+	{
+		// create the XML files in memory in parallel, then add them in the package
+		std::vector<Task *> tasks;
+		for (size_t i=0; i<files.size(); ++i)
+			tasks.push_back(files[i].get());
+		runTasks(tasks, true);
+		for (size_t i=0; i<files.size(); ++i)
+		{
+			OdfXMLWriter const &writer=files[i]->mWriter;
+			mpPackageWriter->addFile(files[i]->mName.c_str(), reinterpret_cast<unsigned char const *>(writer.getData()), writer.getDataSize());
+		}
+	}
+	else
+	{
+		for (size_t i=0; i<files.size(); ++i)
+		{
+			OdfDocumentHandler *pHandler=mpPackageWriter->startXMLFile(files[i]->mName.c_str());
+			if (!pHandler) continue;
+			files[i]->write(pHandler);
+			mpPackageWriter->endXMLFile();
+		}
+	}
+	if (!mpPackageWriter->close())
+	{
+		ODFGEN_DEBUG_MSG(("OdfGenerator::writePackage: can not write the package\n"));
+	}
+}
+
+void OdfGenerator::writePackageMimeType()
+{
+	// the mimetype must be the first file and it must not be compressed
+	std::string const mimeType(getDocumentMimeType());
+	mpPackageWriter->addFile("mimetype", reinterpret_cast<unsigned char const *>(mimeType.c_str()), (unsigned long) mimeType.size(), false);
+}
+
 ////////////////////////////////////////////////////////////
 // embedded
 ////////////////////////////////////////////////////////////
@@ -473,7 +764,7 @@ void OdfGenerator::openFrame(const librevenge::RVNGPropertyList &propList)
 
 void OdfGenerator::closeFrame()
 {
-	mpCurrentStorage->push_back(new TagCloseElement("draw:frame"));
+	mpCurrentStorage->push_back(TagCloseElement("draw:frame"));
 }
 
 void OdfGenerator::addFrameProperties(const librevenge::RVNGPropertyList &propList, TagOpenElement &element) const
@@ -499,7 +790,7 @@ void OdfGenerator::addFrameProperties(const librevenge::RVNGPropertyList &propLi
 		element.addAttribute("svg:height", propList["svg:height"]->getStr());
 	else if (propList["fo:min-height"]) // fixme: must be an attribute of draw:text-box
 		element.addAttribute("fo:min-height", propList["fo:min-height"]->getStr());
-	element.addAttribute("draw:layer", getLayerName(propList));
+	element.addEscapedAttribute("draw:layer", getLayerName(propList));
 }
 
 unsigned OdfGenerator::getFrameId(librevenge::RVNGString val)
@@ -522,7 +813,7 @@ void OdfGenerator::openGroup(const librevenge::RVNGPropertyList &propList)
 
 void OdfGenerator::closeGroup()
 {
-	mpCurrentStorage->push_back(new TagCloseElement("draw:g"));
+	mpCurrentStorage->push_back(TagCloseElement("draw:g"));
 }
 
 librevenge::RVNGString OdfGenerator::getLayerName(const librevenge::RVNGPropertyList &propList) const
@@ -624,7 +915,7 @@ void OdfGenerator::appendLayersMasterStyles(OdfDocumentHandler *pHandler)
 	}
 	for (std::set<librevenge::RVNGString>::const_iterator it=mLayerNameSet.begin(); it!=mLayerNameSet.end(); ++it)
 	{
-		layer.addAttribute("draw:name", *it);
+		layer.addEscapedAttribute("draw:name", *it);
 		layer.write(pHandler);
 		TagCloseElement("draw:layer").write(pHandler);
 	}
@@ -636,36 +927,36 @@ void OdfGenerator::appendLayersMasterStyles(OdfDocumentHandler *pHandler)
 ////////////////////////////////////////////////////////////
 void OdfGenerator::insertTab()
 {
-	mpCurrentStorage->push_back(new TagOpenElement("text:tab"));
-	mpCurrentStorage->push_back(new TagCloseElement("text:tab"));
+	mpCurrentStorage->push_back(TagOpenElement("text:tab"));
+	mpCurrentStorage->push_back(TagCloseElement("text:tab"));
 }
 
 void OdfGenerator::insertSpace()
 {
-	mpCurrentStorage->push_back(new TagOpenElement("text:s"));
-	mpCurrentStorage->push_back(new TagCloseElement("text:s"));
+	mpCurrentStorage->push_back(TagOpenElement("text:s"));
+	mpCurrentStorage->push_back(TagCloseElement("text:s"));
 }
 
 void OdfGenerator::insertLineBreak(bool forceParaClose)
 {
 	if (!forceParaClose)
 	{
-		mpCurrentStorage->push_back(new TagOpenElement("text:line-break"));
-		mpCurrentStorage->push_back(new TagCloseElement("text:line-break"));
+		mpCurrentStorage->push_back(TagOpenElement("text:line-break"));
+		mpCurrentStorage->push_back(TagCloseElement("text:line-break"));
 		return;
 	}
 	closeSpan();
 	closeParagraph();
 
-	TagOpenElement *pParagraphOpenElement = new TagOpenElement("text:p");
+	TagOpenElement paragraphOpenElement("text:p");
 	if (!mLastParagraphName.empty())
-		pParagraphOpenElement->addAttribute("text:style-name", mLastParagraphName.cstr());
-	mpCurrentStorage->push_back(pParagraphOpenElement);
+		paragraphOpenElement.addAttribute("text:style-name", mLastParagraphName.cstr());
+	mpCurrentStorage->push_back(paragraphOpenElement);
 
-	TagOpenElement *pSpanOpenElement = new TagOpenElement("text:span");
+	TagOpenElement spanOpenElement("text:span");
 	if (!mLastSpanName.empty())
-		pSpanOpenElement->addAttribute("text:style-name", mLastSpanName.cstr());
-	mpCurrentStorage->push_back(pSpanOpenElement);
+		spanOpenElement.addAttribute("text:style-name", mLastSpanName.cstr());
+	mpCurrentStorage->push_back(spanOpenElement);
 
 }
 
@@ -676,21 +967,21 @@ void OdfGenerator::insertField(const librevenge::RVNGPropertyList &propList)
 
 	const librevenge::RVNGString &type = propList["librevenge:field-type"]->getStr();
 
-	TagOpenElement *openElement = new TagOpenElement(type);
+	TagOpenElement openElement(type);
 	if (type == "text:page-number")
-		openElement->addAttribute("text:select-page", "current");
+		openElement.addAttribute("text:select-page", "current");
 
 	if (propList["style:num-format"])
-		openElement->addAttribute("style:num-format", propList["style:num-format"]->getStr());
+		openElement.addAttribute("style:num-format", propList["style:num-format"]->getStr());
 
 	mpCurrentStorage->push_back(openElement);
-	mpCurrentStorage->push_back(new TagCloseElement(type));
+	mpCurrentStorage->push_back(TagCloseElement(type));
 }
 
 void OdfGenerator::insertText(const librevenge::RVNGString &text)
 {
 	if (!text.empty())
-		mpCurrentStorage->push_back(new TextElement(text));
+		mpCurrentStorage->push_back(TextElement(text));
 }
 
 void OdfGenerator::defineCharacterStyle(const librevenge::RVNGPropertyList &propList)
@@ -729,15 +1020,15 @@ void OdfGenerator::openSpan(const librevenge::RVNGPropertyList &propList)
 		if (pList["librevenge:span-id"])
 			mIdSpanNameMap[pList["librevenge:span-id"]->getInt()]=sName;
 	}
-	TagOpenElement *pSpanOpenElement = new TagOpenElement("text:span");
-	pSpanOpenElement->addAttribute("text:style-name", sName.cstr());
-	mpCurrentStorage->push_back(pSpanOpenElement);
+	TagOpenElement spanOpenElement("text:span");
+	spanOpenElement.addAttribute("text:style-name", sName.cstr());
+	mpCurrentStorage->push_back(spanOpenElement);
 	mLastSpanName=sName;
 }
 
 void OdfGenerator::closeSpan()
 {
-	mpCurrentStorage->push_back(new TagCloseElement("text:span"));
+	mpCurrentStorage->push_back(TagCloseElement("text:span"));
 }
 
 void OdfGenerator::openLink(const librevenge::RVNGPropertyList &propList)
@@ -746,21 +1037,21 @@ void OdfGenerator::openLink(const librevenge::RVNGPropertyList &propList)
 	{
 		ODFGEN_DEBUG_MSG(("OdfGenerator::openLink: linked type is not defined, assume link\n"));
 	}
-	TagOpenElement *pLinkOpenElement = new TagOpenElement("text:a");
+	TagOpenElement linkOpenElement("text:a");
 	librevenge::RVNGPropertyList::Iter i(propList);
 	for (i.rewind(); i.next();)
 	{
 		if (!i.child()) // write out simple properties only
 			// The string we get here might be url decoded, so
 			// sscape characters that might mess up the resulting xml
-			pLinkOpenElement->addAttribute(i.key(), librevenge::RVNGString::escapeXML(i()->getStr()));
+			linkOpenElement.addEscapedAttribute(i.key(), librevenge::RVNGString::escapeXML(i()->getStr()));
 	}
-	mpCurrentStorage->push_back(pLinkOpenElement);
+	mpCurrentStorage->push_back(linkOpenElement);
 }
 
 void OdfGenerator::closeLink()
 {
-	mpCurrentStorage->push_back(new TagCloseElement("text:a"));
+	mpCurrentStorage->push_back(TagCloseElement("text:a"));
 }
 
 void OdfGenerator::defineParagraphStyle(const librevenge::RVNGPropertyList &propList)
@@ -807,26 +1098,21 @@ void OdfGenerator::openParagraph(const librevenge::RVNGPropertyList &propList)
 	}
 
 	// create a document element corresponding to the paragraph, and append it to our list of document elements
-	TagOpenElement *pParagraphOpenElement = 0;
+	TagOpenElement paragraphOpenElement(propList["text:outline-level"] ? "text:h" : "text:p");
 
 	if (propList["text:outline-level"])
 	{
 		mCurrentParaIsHeading = true;
-		pParagraphOpenElement = new TagOpenElement("text:h");
-		pParagraphOpenElement->addAttribute("text:outline-level", propList["text:outline-level"]->getStr());
+		paragraphOpenElement.addAttribute("text:outline-level", propList["text:outline-level"]->getStr());
 	}
-	else
-	{
-		pParagraphOpenElement = new TagOpenElement("text:p");
-	}
-	pParagraphOpenElement->addAttribute("text:style-name", paragraphName);
-	mpCurrentStorage->push_back(pParagraphOpenElement);
+	paragraphOpenElement.addAttribute("text:style-name", paragraphName);
+	mpCurrentStorage->push_back(paragraphOpenElement);
 	mLastParagraphName=paragraphName;
 }
 
 void OdfGenerator::closeParagraph()
 {
-	mpCurrentStorage->push_back(mCurrentParaIsHeading ? new TagCloseElement("text:h") : new TagCloseElement("text:p"));
+	mpCurrentStorage->push_back(TagCloseElement(mCurrentParaIsHeading ? "text:h" : "text:p"));
 	mCurrentParaIsHeading = false;
 }
 
@@ -856,10 +1142,10 @@ void OdfGenerator::openListLevel(const librevenge::RVNGPropertyList &propList, b
 		pList.insert("librevenge:level", int(state.mbListElementOpened.size())+1);
 	mListManager.defineLevel(pList, ordered, useStyleAutomaticZone() ? Style::Z_StyleAutomatic : Style::Z_Unknown);
 
-	TagOpenElement *pListLevelOpenElement = new TagOpenElement("text:list");
+	TagOpenElement listLevelOpenElement("text:list");
 	if (!state.mbListElementOpened.empty() && !state.mbListElementOpened.top())
 	{
-		mpCurrentStorage->push_back(new TagOpenElement("text:list-item"));
+		mpCurrentStorage->push_back(TagOpenElement("text:list-item"));
 		state.mbListElementOpened.top() = true;
 	}
 
@@ -868,12 +1154,12 @@ void OdfGenerator::openListLevel(const librevenge::RVNGPropertyList &propList, b
 	{
 		// add a sanity check ( to avoid a crash if mpCurrentListStyle is NULL)
 		if (state.mpCurrentListStyle)
-			pListLevelOpenElement->addAttribute("text:style-name", state.mpCurrentListStyle->getName());
+			listLevelOpenElement.addAttribute("text:style-name", state.mpCurrentListStyle->getName());
 	}
 
 	if (ordered && state.mbListContinueNumbering)
-		pListLevelOpenElement->addAttribute("text:continue-numbering", "true");
-	mpCurrentStorage->push_back(pListLevelOpenElement);
+		listLevelOpenElement.addAttribute("text:continue-numbering", "true");
+	mpCurrentStorage->push_back(listLevelOpenElement);
 }
 
 void OdfGenerator::closeListLevel()
@@ -887,11 +1173,11 @@ void OdfGenerator::closeListLevel()
 	}
 	if (state.mbListElementOpened.top())
 	{
-		mpCurrentStorage->push_back(new TagCloseElement("text:list-item"));
+		mpCurrentStorage->push_back(TagCloseElement("text:list-item"));
 		state.mbListElementOpened.top() = false;
 	}
 
-	mpCurrentStorage->push_back(new TagCloseElement("text:list"));
+	mpCurrentStorage->push_back(TagCloseElement("text:list"));
 	state.mbListElementOpened.pop();
 }
 
@@ -904,7 +1190,7 @@ void OdfGenerator::openListElement(const librevenge::RVNGPropertyList &propList)
 
 	if (state.mbListElementOpened.top())
 	{
-		mpCurrentStorage->push_back(new TagCloseElement("text:list-item"));
+		mpCurrentStorage->push_back(TagCloseElement("text:list-item"));
 		state.mbListElementOpened.top() = false;
 	}
 
@@ -917,14 +1203,14 @@ void OdfGenerator::openListElement(const librevenge::RVNGPropertyList &propList)
 	finalPropList.insert("style:parent-style-name", "Standard");
 	librevenge::RVNGString paragName =mParagraphManager.findOrAdd(finalPropList, useStyleAutomaticZone() ? Style::Z_StyleAutomatic : Style::Z_Unknown);
 
-	TagOpenElement *pOpenListItem = new TagOpenElement("text:list-item");
+	TagOpenElement openListItem("text:list-item");
 	if (propList["text:start-value"] && propList["text:start-value"]->getInt() > 0)
-		pOpenListItem->addAttribute("text:start-value", propList["text:start-value"]->getStr());
-	mpCurrentStorage->push_back(pOpenListItem);
+		openListItem.addAttribute("text:start-value", propList["text:start-value"]->getStr());
+	mpCurrentStorage->push_back(openListItem);
 
-	TagOpenElement *pOpenListElementParagraph = new TagOpenElement("text:p");
-	pOpenListElementParagraph->addAttribute("text:style-name", paragName);
-	mpCurrentStorage->push_back(pOpenListElementParagraph);
+	TagOpenElement openListElementParagraph("text:p");
+	openListElementParagraph.addAttribute("text:style-name", paragName);
+	mpCurrentStorage->push_back(openListElementParagraph);
 
 	state.mbListElementOpened.top() = true;
 	state.mbListElementParagraphOpened = true;
@@ -959,21 +1245,21 @@ void OdfGenerator::openTable(const librevenge::RVNGPropertyList &propList)
 	}
 	librevenge::RVNGString tableName=table->getName();
 
-	TagOpenElement *pTableOpenElement = new TagOpenElement("table:table");
-	pTableOpenElement->addAttribute("table:name", tableName.cstr());
-	pTableOpenElement->addAttribute("table:style-name", tableName.cstr());
-	mpCurrentStorage->push_back(pTableOpenElement);
+	TagOpenElement tableOpenElement("table:table");
+	tableOpenElement.addAttribute("table:name", tableName.cstr());
+	tableOpenElement.addAttribute("table:style-name", tableName.cstr());
+	mpCurrentStorage->push_back(tableOpenElement);
 
 	for (int i=0; i<table->getNumColumns(); ++i)
 	{
-		TagOpenElement *pTableColumnOpenElement = new TagOpenElement("table:table-column");
+		TagOpenElement tableColumnOpenElement("table:table-column");
 		librevenge::RVNGString sColumnStyleName;
 		sColumnStyleName.sprintf("%s.Column%i", tableName.cstr(), (i+1));
-		pTableColumnOpenElement->addAttribute("table:style-name", sColumnStyleName.cstr());
-		mpCurrentStorage->push_back(pTableColumnOpenElement);
+		tableColumnOpenElement.addAttribute("table:style-name", sColumnStyleName.cstr());
+		mpCurrentStorage->push_back(tableColumnOpenElement);
 
-		TagCloseElement *pTableColumnCloseElement = new TagCloseElement("table:table-column");
-		mpCurrentStorage->push_back(pTableColumnCloseElement);
+		TagCloseElement tableColumnCloseElement("table:table-column");
+		mpCurrentStorage->push_back(tableColumnCloseElement);
 	}
 }
 
@@ -982,7 +1268,7 @@ void OdfGenerator::closeTable()
 	if (!mTableManager.getActualTable())
 		return;
 	mTableManager.closeTable();
-	mpCurrentStorage->push_back(new TagCloseElement("table:table"));
+	mpCurrentStorage->push_back(TagCloseElement("table:table"));
 }
 
 bool OdfGenerator::openTableRow(const librevenge::RVNGPropertyList &propList)
@@ -998,11 +1284,11 @@ bool OdfGenerator::openTableRow(const librevenge::RVNGPropertyList &propList)
 		return false;
 	bool inHeader=false;
 	if (table->isRowOpened(inHeader) && inHeader)
-		mpCurrentStorage->push_back(new TagOpenElement("table:table-header-rows"));
+		mpCurrentStorage->push_back(TagOpenElement("table:table-header-rows"));
 
-	TagOpenElement *pTableRowOpenElement = new TagOpenElement("table:table-row");
-	pTableRowOpenElement->addAttribute("table:style-name", rowName);
-	mpCurrentStorage->push_back(pTableRowOpenElement);
+	TagOpenElement tableRowOpenElement("table:table-row");
+	tableRowOpenElement.addAttribute("table:style-name", rowName);
+	mpCurrentStorage->push_back(tableRowOpenElement);
 	return true;
 }
 
@@ -1012,9 +1298,9 @@ void OdfGenerator::closeTableRow()
 	if (!table) return;
 	bool inHeader=false;
 	if (!table->isRowOpened(inHeader) || !table->closeRow()) return;
-	mpCurrentStorage->push_back(new TagCloseElement("table:table-row"));
+	mpCurrentStorage->push_back(TagCloseElement("table:table-row"));
 	if (inHeader)
-		mpCurrentStorage->push_back(new TagCloseElement("table:table-header-rows"));
+		mpCurrentStorage->push_back(TagCloseElement("table:table-header-rows"));
 }
 
 bool OdfGenerator::isInTableRow(bool &inHeaderRow) const
@@ -1037,16 +1323,16 @@ bool OdfGenerator::openTableCell(const librevenge::RVNGPropertyList &propList)
 	if (cellName.empty())
 		return false;
 
-	TagOpenElement *pTableCellOpenElement = new TagOpenElement("table:table-cell");
-	pTableCellOpenElement->addAttribute("table:style-name", cellName);
+	TagOpenElement tableCellOpenElement("table:table-cell");
+	tableCellOpenElement.addAttribute("table:style-name", cellName);
 	if (propList["table:number-columns-spanned"])
-		pTableCellOpenElement->addAttribute("table:number-columns-spanned",
-		                                    propList["table:number-columns-spanned"]->getStr().cstr());
+		tableCellOpenElement.addAttribute("table:number-columns-spanned",
+		                                  propList["table:number-columns-spanned"]->getStr().cstr());
 	if (propList["table:number-rows-spanned"])
-		pTableCellOpenElement->addAttribute("table:number-rows-spanned",
-		                                    propList["table:number-rows-spanned"]->getStr().cstr());
-	// pTableCellOpenElement->addAttribute("table:value-type", "string");
-	mpCurrentStorage->push_back(pTableCellOpenElement);
+		tableCellOpenElement.addAttribute("table:number-rows-spanned",
+		                                  propList["table:number-rows-spanned"]->getStr().cstr());
+	// tableCellOpenElement.addAttribute("table:value-type", "string");
+	mpCurrentStorage->push_back(tableCellOpenElement);
 	return true;
 }
 
@@ -1055,7 +1341,7 @@ void OdfGenerator::closeTableCell()
 	if (!mTableManager.getActualTable() || !mTableManager.getActualTable()->closeCell())
 		return;
 
-	mpCurrentStorage->push_back(new TagCloseElement("table:table-cell"));
+	mpCurrentStorage->push_back(TagCloseElement("table:table-cell"));
 }
 
 void OdfGenerator::insertCoveredTableCell(const librevenge::RVNGPropertyList &propList)
@@ -1064,13 +1350,116 @@ void OdfGenerator::insertCoveredTableCell(const librevenge::RVNGPropertyList &pr
 	        !mTableManager.getActualTable()->insertCoveredCell(propList))
 		return;
 
-	mpCurrentStorage->push_back(new TagOpenElement("table:covered-table-cell"));
-	mpCurrentStorage->push_back(new TagCloseElement("table:covered-table-cell"));
+	mpCurrentStorage->push_back(TagOpenElement("table:covered-table-cell"));
+	mpCurrentStorage->push_back(TagCloseElement("table:covered-table-cell"));
 }
 
 ////////////////////////////////////////////////////////////
 // image/embedded
 ////////////////////////////////////////////////////////////
+/** an image converted by an embedded image handler: the conversion can
+	be run as a task, otherwise it is done when the element is written */
+class OdfGenerator::ImageConversion : public DocumentElement, public libodfgen::Task
+{
+public:
+	//! constructor
+	ImageConversion(OdfEmbeddedImage handler, librevenge::RVNGBinaryData const &data)
+		: DocumentElement(), Task(), mHandler(handler), mData(data), mOutput(), mbDone(false), mbConverted(false)
+	{
+	}
+	//! does the conversion
+	void run()
+	{
+		convert();
+	}
+	//! returns the converted data (or an empty data if the conversion failed)
+	librevenge::RVNGBinaryData const &getOutput() const
+	{
+		convert();
+		return mOutput;
+	}
+	//! replaces the converted data by an identical data
+	void setOutput(librevenge::RVNGBinaryData const &output)
+	{
+		mOutput=output;
+	}
+	//! writes the draw:image element if the conversion succeeds
+	void write(OdfDocumentHandler *pHandler) const
+	{
+		if (getOutput().empty())
+			return;
+		TagOpenElement("draw:image").write(pHandler);
+		TagOpenElement("office:binary-data").write(pHandler);
+		BinaryDataElement(mOutput).write(pHandler);
+		TagCloseElement("office:binary-data").write(pHandler);
+		TagCloseElement("draw:image").write(pHandler);
+	}
+	//! stores the draw:image element in a storage, the conversion is done now
+	void appendTo(libodfgen::DocumentElementVector &storage) const
+	{
+		if (getOutput().empty())
+			return;
+		storage.push_back(TagOpenElement("draw:image"));
+		storage.push_back(TagOpenElement("office:binary-data"));
+		storage.push_back(BinaryDataElement(mOutput));
+		storage.push_back(TagCloseElement("office:binary-data"));
+		storage.push_back(TagCloseElement("draw:image"));
+	}
+private:
+	//! converts the data if this is not already done
+	void convert() const
+	{
+		if (mbDone)
+			return;
+		mbDone=true;
+		try
+		{
+			mbConverted=mHandler(mData, mOutput);
+		}
+		catch (...)
+		{
+			ODFGEN_DEBUG_MSG(("OdfGenerator::ImageConversion::convert: ARGHH, catch an exception when converting data!!!\n"));
+			mbConverted=false;
+		}
+		if (!mbConverted)
+			mOutput=librevenge::RVNGBinaryData();
+		// the original data are no longer needed
+		mData=librevenge::RVNGBinaryData();
+	}
+
+	//! the image handler
+	OdfEmbeddedImage mHandler;
+	//! the original data
+	mutable librevenge::RVNGBinaryData mData;
+	//! the converted data
+	mutable librevenge::RVNGBinaryData mOutput;
+	//! a flag to know if the conversion is done
+	mutable bool mbDone;
+	//! a flag to know if the conversion succeeds
+	mutable bool mbConverted;
+};
+
+void OdfGenerator::runImageConversions()
+{
+	if (mImageConversions.empty())
+		return;
+	std::vector<libodfgen::Task *> tasks;
+	for (size_t i=0; i<mImageConversions.size(); ++i)
+		tasks.push_back(mImageConversions[i].get());
+	// the handlers are called from the worker threads
+	runTasks(tasks, true);
+	for (size_t i=0; i<mImageConversions.size(); ++i)
+	{
+		ImageConversion &conversion=*mImageConversions[i];
+		if (conversion.getOutput().empty())
+			continue;
+		libodfgen::BinaryHash hash;
+		conversion.setOutput(mBinaryStore.insert(conversion.getOutput(), hash));
+	}
+	// the storages keep the elements
+	mImageConversions.clear();
+}
+
 void OdfGenerator::insertBinaryObject(const librevenge::RVNGPropertyList &propList)
 {
 	if (!propList["office:binary-data"] || !propList["librevenge:mime-type"])
@@ -1089,32 +1478,45 @@ void OdfGenerator::insertBinaryObject(const librevenge::RVNGPropertyList &propLi
 			librevenge::RVNGBinaryData data(propList["office:binary-data"]->getStr());
 			if (tmpObjectHandler)
 			{
-				DocumentElementVector tmpContentElements;
-				InternalHandler tmpHandler(&tmpContentElements);
-
-
-				if (tmpObjectHandler(data, &tmpHandler, ODF_FLAT_XML) && !tmpContentElements.empty())
+				ConvertedObjectCache::Key const key(propList["librevenge:mime-type"]->getStr(),
+				                                    libodfgen::BinaryHash(data.getDataBuffer(), data.size()));
+				shared_ptr<DocumentElementVector const> contentElements;
+				if (!mConvertedObjectCache.find(key, contentElements))
 				{
-					mpCurrentStorage->push_back(new TagOpenElement("draw:object"));
-					tmpContentElements.appendTo(*mpCurrentStorage);
-					mpCurrentStorage->push_back(new TagCloseElement("draw:object"));
+					shared_ptr<DocumentElementVector> tmpContentElements(new DocumentElementVector);
+					InternalHandler tmpHandler(tmpContentElements.get());
+					if (tmpObjectHandler(data, &tmpHandler, ODF_FLAT_XML) && !tmpContentElements->empty())
+						contentElements=tmpContentElements;
+					mConvertedObjectCache.insert(key, contentElements);
 				}
+				if (contentElements)
+				{
+					// the converted object is shared by all its occurrences
+					mpCurrentStorage->push_back(TagOpenElement("draw:object"));
+					mpCurrentStorage->addElement(shared_ptr<DocumentElement const>(new SharedStorageElement(contentElements)));
+					mpCurrentStorage->push_back(TagCloseElement("draw:object"));
+				}
+			}
+			if (tmpImageHandler && mbAsyncImageConversion)
+			{
+				// the conversion is done later, only the result is written
+				shared_ptr<ImageConversion> conversion(new ImageConversion(tmpImageHandler, data));
+				mImageConversions.push_back(conversion);
+				mpCurrentStorage->addElement(conversion);
 			}
-			if (tmpImageHandler)
+			else if (tmpImageHandler)
 			{
 				librevenge::RVNGBinaryData output;
 				if (tmpImageHandler(data, output))
 				{
-					mpCurrentStorage->push_back(new TagOpenElement("draw:image"));
-
-					mpCurrentStorage->push_back(new TagOpenElement("office:binary-data"));
-					librevenge::RVNGString binaryBase64Data = output.getBase64Data();
-
-					mpCurrentStorage->push_back(new CharDataElement(binaryBase64Data.cstr()));
+					mpCurrentStorage->push_back(TagOpenElement("draw:image"));
 
-					mpCurrentStorage->push_back(new TagCloseElement("office:binary-data"));
+					mpCurrentStorage->push_back(TagOpenElement("office:binary-data"));
+					libodfgen::BinaryHash hash;
+					mpCurrentStorage->push_back(BinaryDataElement(mBinaryStore.insert(output, hash)));
+					mpCurrentStorage->push_back(TagCloseElement("office:binary-data"));
 
-					mpCurrentStorage->push_back(new TagCloseElement("draw:image"));
+					mpCurrentStorage->push_back(TagCloseElement("draw:image"));
 				}
 			}
 		}
@@ -1126,26 +1528,48 @@ void OdfGenerator::insertBinaryObject(const librevenge::RVNGPropertyList &propLi
 	else
 		// assuming we have a binary image or a object_ole that we can just insert as it is
 	{
+		if (mbExternalPictures && propList["librevenge:mime-type"]->getStr() != "object/ole" &&
+		        mDocumentStreamHandlers.find(ODF_FLAT_XML)==mDocumentStreamHandlers.end())
+		{
+			try
+			{
+				librevenge::RVNGBinaryData const data(propList["office:binary-data"]->getStr());
+				TagOpenElement *image=new TagOpenElement("draw:image");
+				image->addAttribute("xlink:href", addPicture(data, propList["librevenge:mime-type"]->getStr()));
+				image->addAttribute("xlink:type", "simple");
+				image->addAttribute("xlink:show", "embed");
+				image->addAttribute("xlink:actuate", "onLoad");
+				mpCurrentStorage->push_back(image);
+				mpCurrentStorage->push_back(TagCloseElement("draw:image"));
+			}
+			catch (...)
+			{
+				ODFGEN_DEBUG_MSG(("OdfGenerator::insertBinaryObject: ARGHH, catch an exception when decoding picture!!!\n"));
+			}
+			return;
+		}
 		if (propList["librevenge:mime-type"]->getStr() == "object/ole")
-			mpCurrentStorage->push_back(new TagOpenElement("draw:object-ole"));
+			mpCurrentStorage->push_back(TagOpenElement("draw:object-ole"));
 		else
-			mpCurrentStorage->push_back(new TagOpenElement("draw:image"));
+			mpCurrentStorage->push_back(TagOpenElement("draw:image"));
 
-		mpCurrentStorage->push_back(new TagOpenElement("office:binary-data"));
+		mpCurrentStorage->push_back(TagOpenElement("office:binary-data"));
 		try
 		{
-			mpCurrentStorage->push_back(new CharDataElement(propList["office:binary-data"]->getStr().cstr()));
+			// only the raw data are kept, they are encoded again when the storage is written
+			libodfgen::BinaryHash hash;
+			mpCurrentStorage->push_back(BinaryDataElement(mBinaryStore.insert(librevenge::RVNGBinaryData(propList["office:binary-data"]->getStr()), hash)));
 		}
 		catch (...)
 		{
 			ODFGEN_DEBUG_MSG(("OdfGenerator::insertBinaryObject: ARGHH, catch an exception when decoding picture!!!\n"));
 		}
-		mpCurrentStorage->push_back(new TagCloseElement("office:binary-data"));
+		mpCurrentStorage->push_back(TagCloseElement("office:binary-data"));
 
 		if (propList["librevenge:mime-type"]->getStr() == "object/ole")
-			mpCurrentStorage->push_back(new TagCloseElement("draw:object-ole"));
+			mpCurrentStorage->push_back(TagCloseElement("draw:object-ole"));
 		else
-			mpCurrentStorage->push_back(new TagCloseElement("draw:image"));
+			mpCurrentStorage->push_back(TagCloseElement("draw:image"));
 	}
 }
 
@@ -1190,12 +1614,9 @@ void OdfGenerator::drawEllipse(const librevenge::RVNGPropertyList &propList)
 	TagOpenElement *pDrawEllipseElement = new TagOpenElement("draw:ellipse");
 	pDrawEllipseElement->addAttribute("draw:style-name", sValue);
 	addFrameProperties(propList, *pDrawEllipseElement);
-	sValue = doubleToString(2 * rx);
-	sValue.append("in");
-	pDrawEllipseElement->addAttribute("svg:width", sValue);
-	sValue = doubleToString(2 * ry);
-	sValue.append("in");
-	pDrawEllipseElement->addAttribute("svg:height", sValue);
+	libodfgen::NumberString number;
+	pDrawEllipseElement->addAttribute("svg:width", number.setDouble(2 * rx, "in").cstr());
+	pDrawEllipseElement->addAttribute("svg:height", number.setDouble(2 * ry, "in").cstr());
 	if (propList["librevenge:rotate"] &&
 	        (propList["librevenge:rotate"]->getDouble() < 0 || propList["librevenge:rotate"]->getDouble() > 0))
 	{
@@ -1208,26 +1629,20 @@ void OdfGenerator::drawEllipse(const librevenge::RVNGPropertyList &propList)
 		double deltax = sqrt(pow(rx, 2.0) + pow(ry, 2.0))*cos(atan(ry/rx)-radrotation) - rx;
 		double deltay = sqrt(pow(rx, 2.0) + pow(ry, 2.0))*sin(atan(ry/rx)- radrotation) - ry;
 		sValue = "rotate(";
-		sValue.append(doubleToString(radrotation));
+		sValue.append(number.setDouble(radrotation).cstr());
 		sValue.append(") ");
 		sValue.append("translate(");
-		sValue.append(doubleToString(cx - rx - deltax));
-		sValue.append("in, ");
-		sValue.append(doubleToString(cy - ry - deltay));
-		sValue.append("in)");
+		sValue.append(number.setDouble(cx - rx - deltax, "in, ").cstr());
+		sValue.append(number.setDouble(cy - ry - deltay, "in)").cstr());
 		pDrawEllipseElement->addAttribute("draw:transform", sValue);
 	}
 	else
 	{
-		sValue = doubleToString(cx-rx);
-		sValue.append("in");
-		pDrawEllipseElement->addAttribute("svg:x", sValue);
-		sValue = doubleToString(cy-ry);
-		sValue.append("in");
-		pDrawEllipseElement->addAttribute("svg:y", sValue);
+		pDrawEllipseElement->addAttribute("svg:x", number.setDouble(cx-rx, "in").cstr());
+		pDrawEllipseElement->addAttribute("svg:y", number.setDouble(cy-ry, "in").cstr());
 	}
 	mpCurrentStorage->push_back(pDrawEllipseElement);
-	mpCurrentStorage->push_back(new TagCloseElement("draw:ellipse"));
+	mpCurrentStorage->push_back(TagCloseElement("draw:ellipse"));
 }
 
 void OdfGenerator::drawPath(const librevenge::RVNGPropertyList &propList)
@@ -1250,24 +1665,17 @@ void OdfGenerator::drawPath(const librevenge::RVNGPropertyListVector &path, cons
 	TagOpenElement *pDrawPathElement = new TagOpenElement("draw:path");
 	pDrawPathElement->addAttribute("draw:style-name", sValue);
 	addFrameProperties(propList, *pDrawPathElement);
-	sValue = doubleToString(px);
-	sValue.append("in");
-	pDrawPathElement->addAttribute("svg:x", sValue);
-	sValue = doubleToString(py);
-	sValue.append("in");
-	pDrawPathElement->addAttribute("svg:y", sValue);
-	sValue = doubleToString((qx - px));
-	sValue.append("in");
-	pDrawPathElement->addAttribute("svg:width", sValue);
-	sValue = doubleToString((qy - py));
-	sValue.append("in");
-	pDrawPathElement->addAttribute("svg:height", sValue);
-	sValue.sprintf("%i %i %i %i", 0, 0, (unsigned)(2540*(qx - px)), (unsigned)(2540*(qy - py)));
-	pDrawPathElement->addAttribute("svg:viewBox", sValue);
+	libodfgen::NumberString number;
+	pDrawPathElement->addAttribute("svg:x", number.setDouble(px, "in").cstr());
+	pDrawPathElement->addAttribute("svg:y", number.setDouble(py, "in").cstr());
+	pDrawPathElement->addAttribute("svg:width", number.setDouble(qx - px, "in").cstr());
+	pDrawPathElement->addAttribute("svg:height", number.setDouble(qy - py, "in").cstr());
+	number.setInt(0).append(" 0 ").appendInt(int((unsigned)(2540*(qx - px)))).append(' ').appendInt(int((unsigned)(2540*(qy - py))));
+	pDrawPathElement->addAttribute("svg:viewBox", number.cstr());
 
 	pDrawPathElement->addAttribute("svg:d", libodfgen::convertPath(path, px, py));
 	mpCurrentStorage->push_back(pDrawPathElement);
-	mpCurrentStorage->push_back(new TagCloseElement("draw:path"));
+	mpCurrentStorage->push_back(TagCloseElement("draw:path"));
 }
 
 void OdfGenerator::drawPolySomething(const librevenge::RVNGPropertyList &propList, bool isClosed)
@@ -1295,7 +1703,7 @@ void OdfGenerator::drawPolySomething(const librevenge::RVNGPropertyList &propLis
 		pDrawLineElement->addAttribute("svg:x2", (*vertices)[1]["svg:x"]->getStr());
 		pDrawLineElement->addAttribute("svg:y2", (*vertices)[1]["svg:y"]->getStr());
 		mpCurrentStorage->push_back(pDrawLineElement);
-		mpCurrentStorage->push_back(new TagCloseElement(what));
+		mpCurrentStorage->push_back(TagCloseElement(what));
 	}
 	else
 	{
@@ -1346,7 +1754,7 @@ void OdfGenerator::drawRectangle(const librevenge::RVNGPropertyList &propList)
 	else
 		pDrawRectElement->addAttribute("draw:corner-radius", "0.0000in");
 	mpCurrentStorage->push_back(pDrawRectElement);
-	mpCurrentStorage->push_back(new TagCloseElement("draw:rect"));
+	mpCurrentStorage->push_back(TagCloseElement("draw:rect"));
 }
 
 void OdfGenerator::drawConnector(const librevenge::RVNGPropertyList &propList)
@@ -1397,17 +1805,18 @@ void OdfGenerator::defineEmbeddedFont(const librevenge::RVNGPropertyList &propLi
 		const librevenge::RVNGString name(propList["librevenge:name"]->getStr());
 		const librevenge::RVNGString mimeType(propList["librevenge:mime-type"]->getStr());
 		const librevenge::RVNGBinaryData data(propList["office:binary-data"]->getStr());
+		libodfgen::BinaryHash hash;
 
 		OdfEmbeddedImage imageHandler = findEmbeddedImageHandler(mimeType);
 		if (imageHandler)
 		{
 			librevenge::RVNGBinaryData output;
 			if (imageHandler(data, output))
-				mFontManager.setEmbedded(name, "application/x-font-ttf", output);
+				mFontManager.setEmbedded(name, "application/x-font-ttf", mBinaryStore.insert(output, hash));
 		}
 		else
 		{
-			mFontManager.setEmbedded(name, mimeType, data);
+			mFontManager.setEmbedded(name, mimeType, mBinaryStore.insert(data, hash));
 		}
 	}
 	catch (...)
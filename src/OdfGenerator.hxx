@@ -35,6 +35,7 @@
 #include <librevenge/librevenge.h>
 
 #include "libodfgen/OdfDocumentHandler.hxx"
+#include "libodfgen/OdfPackageWriter.hxx"
 
 #include "FilterInternal.hxx"
 #include "FontStyle.hxx"
@@ -93,6 +94,86 @@ public:
 		ObjectContainer(ObjectContainer const &orig);
 		ObjectContainer &operator=(ObjectContainer const &orig);
 	};
+	//! a picture stored in a separate file of not flat odf files
+	struct PictureContainer
+	{
+		//! constructor
+		PictureContainer(librevenge::RVNGString const &type, librevenge::RVNGBinaryData const &data)
+			: mType(type), mData(data)
+		{
+		}
+		//! the mime type
+		librevenge::RVNGString mType;
+		//! the picture data
+		librevenge::RVNGBinaryData mData;
+	};
+	/** a bounded cache of the embedded objects converted by the object
+		handlers: the key is the mime type and the hash of the data, the value
+		is the converted storage (or an empty pointer if the conversion fails).
+		When the cache is full, the least recently used object is removed. */
+	class ConvertedObjectCache
+	{
+	public:
+		//! the key
+		typedef std::pair<librevenge::RVNGString, libodfgen::BinaryHash> Key;
+		//! constructor
+		explicit ConvertedObjectCache(size_t maxSize)
+			: mMaxSize(maxSize), mObjects(), mUsages(), mClock(0), mHits(0), mMisses(0)
+		{
+		}
+		//! sets the maximal number of objects, 0 means no object is stored
+		void setMaxSize(size_t maxSize);
+		/** looks for a converted object: returns true and sets storage if it
+			is found, updates the statistics */
+		bool find(Key const &key, shared_ptr<libodfgen::DocumentElementVector const> &storage);
+		//! stores a converted object
+		void insert(Key const &key, shared_ptr<libodfgen::DocumentElementVector const> const &storage);
+		//! returns the number of objects found in the cache
+		unsigned long getHits() const
+		{
+			return mHits;
+		}
+		//! returns the number of objects not found in the cache
+		unsigned long getMisses() const
+		{
+			return mMisses;
+		}
+	private:
+		//! removes the least recently used objects to keep at most maxSize objects
+		void reduce(size_t maxSize);
+		//! the maximal number of objects
+		size_t mMaxSize;
+		//! key to (storage, last usage) map
+		std::map<Key, std::pair<shared_ptr<libodfgen::DocumentElementVector const>, unsigned long> > mObjects;
+		//! last usage to key map
+		std::map<unsigned long, Key> mUsages;
+		//! the counter used to date the usages
+		unsigned long mClock;
+		//! the number of hits
+		unsigned long mHits;
+		//! the number of misses
+		unsigned long mMisses;
+	};
+	/** sets the maximal number of converted embedded objects kept to be
+		reused when the same object is inserted again, 0 disables the cache */
+	void setEmbeddedObjectCacheSize(unsigned size)
+	{
+		mConvertedObjectCache.setMaxSize(size);
+	}
+	//! returns the number of embedded objects found and not found in the cache
+	void getEmbeddedObjectCacheStatistics(unsigned long &hits, unsigned long &misses) const
+	{
+		hits=mConvertedObjectCache.getHits();
+		misses=mConvertedObjectCache.getMisses();
+	}
+	//! returns the number of paragraph, span, table row and cell styles found and not found in the style caches
+	void getStyleCacheStatistics(unsigned long &hits, unsigned long &misses) const
+	{
+		hits=misses=0;
+		mParagraphManager.addCacheStatistics(hits, misses);
+		mSpanManager.addCacheStatistics(hits, misses);
+		mTableManager.addCacheStatistics(hits, misses);
+	}
 	/** creates a new object */
 	ObjectContainer &createObjectFile(librevenge::RVNGString const &objectName,
 	                                  librevenge::RVNGString const &objectType,
@@ -101,15 +182,65 @@ public:
 	librevenge::RVNGStringVector getObjectNames() const;
 	/** retrieve an embedded object content via a document handler */
 	bool getObjectContent(librevenge::RVNGString const &objectName, OdfDocumentHandler *pHandler);
+	/** sets if the images must be stored in separate files (Pictures/...)
+		when the output is not a flat odf file, must be called before startDocument */
+	void setExternalPictures(bool external)
+	{
+		mbExternalPictures=external;
+	}
+	/** stores a picture in a separate file and returns the file name; if
+		the same picture is already stored, its file name is returned */
+	librevenge::RVNGString addPicture(librevenge::RVNGBinaryData const &data, librevenge::RVNGString const &mimeType);
+	/** returns the list of pictures stored in separate files */
+	librevenge::RVNGStringVector getPictureNames() const;
+	/** retrieve the content and the mime type of a picture stored in a separate file */
+	bool getPictureContent(librevenge::RVNGString const &name, librevenge::RVNGBinaryData &data, librevenge::RVNGString &mimeType) const;
 
 	//! add a document handler
 	void addDocumentHandler(OdfDocumentHandler *pHandler, const OdfStreamType streamType);
 	//! calls writeTargetDocument on each document handler
 	void writeTargetDocuments();
+	/** sets if we must keep the body in memory or spool it in a temporary file,
+		must be called before startDocument */
+	void setContentStreaming(bool stream)
+	{
+		mbContentStreaming=stream;
+	}
+	/** if content streaming is requested, asks the body storage to move its
+		elements in a temporary file each time they use more than 1 MiB. */
+	void startContentStreaming();
+	//! writes all the files of the document in the package writer
+	void writePackage();
+	//! writes the mimetype file in the package writer
+	void writePackageMimeType();
+	/** sets the package writer: if set, writeTargetDocuments writes all the
+		files of the document in this package instead of calling the handlers */
+	void setPackageWriter(OdfPackageWriter *pWriter)
+	{
+		mpPackageWriter=pWriter;
+	}
+	/** sets if writeTargetDocuments can write the different files of the
+		document in parallel, each handler being used by only one thread */
+	void setParallelWriting(bool parallel)
+	{
+		mbParallelWriting=parallel;
+	}
+	//! an image conversion which can be run later, see setAsynchronousImageConversion
+	class ImageConversion;
+	/** sets if the conversions done by the embedded image handlers are delayed
+		until the document is written, where they are run in parallel */
+	void setAsynchronousImageConversion(bool async)
+	{
+		mbAsyncImageConversion=async;
+	}
+	//! runs the delayed image conversions
+	void runImageConversions();
 	//! appends local files in the manifest
 	void appendFilesInManifest(OdfDocumentHandler *pHandler);
 	//! a virtual function used to write final data
 	virtual bool writeTargetDocument(OdfDocumentHandler *pHandler, OdfStreamType streamType) = 0;
+	//! returns the document mime type
+	virtual char const *getDocumentMimeType() const = 0;
 
 	//
 	// embedded image/object handler
@@ -151,6 +282,11 @@ public:
 	{
 		return mMetaDataStorage;
 	}
+	//! returns the pool used to share the texts of the storages
+	libodfgen::StringPool &getStringPool()
+	{
+		return mStringPool;
+	}
 	//! write the storage data to a document handler
 	static void sendStorage(libodfgen::DocumentElementVector const *storage, OdfDocumentHandler *pHandler);
 
@@ -341,6 +477,10 @@ protected:
 	//! returns the current graphic style name ( MODIFYME)
 	librevenge::RVNGString getCurrentGraphicStyleName();
 
+	// the pool of the texts shared by the storages: it must be destroyed after them
+	libodfgen::StringPool mStringPool;
+	// the store of the images and fonts data, used to share the identical data
+	libodfgen::BinaryStore mBinaryStore;
 	// the current set of elements that we're writing to
 	libodfgen::DocumentElementVector *mpCurrentStorage;
 	// the stack of all storage
@@ -411,16 +551,32 @@ protected:
 
 	// the document handlers
 	std::map<OdfStreamType, OdfDocumentHandler *> mDocumentStreamHandlers;
+	// a flag to know if the content streaming is requested
+	bool mbContentStreaming;
+	// the package writer (if set)
+	OdfPackageWriter *mpPackageWriter;
+	// a flag to know if the files can be written in parallel
+	bool mbParallelWriting;
 
 	// the number of created object
 	int miObjectNumber;
 	// name to object map
 	std::map<librevenge::RVNGString, ObjectContainer *> mNameObjectMap;
-
+	// a flag to know if the images must be stored in separate files
+	bool mbExternalPictures;
+	// name to picture map
+	std::map<librevenge::RVNGString, PictureContainer> mNamePictureMap;
+
+	// a flag to know if the image conversions are delayed
+	bool mbAsyncImageConversion;
+	// the delayed image conversions
+	std::vector<shared_ptr<ImageConversion> > mImageConversions;
 	// embedded image handlers
 	std::map<librevenge::RVNGString, OdfEmbeddedImage > mImageHandlers;
 	// embedded object handlers
 	std::map<librevenge::RVNGString, OdfEmbeddedObject > mObjectHandlers;
+	// the cache of the converted embedded objects
+	ConvertedObjectCache mConvertedObjectCache;
 
 	bool mCurrentParaIsHeading;
 
@@ -0,0 +1,345 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* libodfgen
+ * Version: MPL 2.0 / LGPLv2.1+
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU Lesser General Public License Version 2.1 or later
+ * (LGPLv2.1+), in which case the provisions of the LGPLv2.1+ are
+ * applicable instead of those above.
+ *
+ * For further information visit http://libwpd.sourceforge.net
+ */
+
+#include <string>
+#include <vector>
+
+#include <libodfgen/OdfPackageWriter.hxx>
+
+#include "DataSink.hxx"
+#include "Deflater.hxx"
+#include "FilterInternal.hxx"
+
+namespace
+{
+//! the data of a file stored in the zip directory
+struct ZipEntry
+{
+	//! constructor
+	explicit ZipEntry(const char *name) : mName(name), mFlags(0), mMethod(0), mCRC(0), mCompressedSize(0), mSize(0), mOffset(0)
+	{
+		// bit 11: the name is encoded in UTF-8
+		for (size_t i=0; i<mName.size(); ++i)
+		{
+			if ((unsigned char) mName[i]>=0x80)
+				mFlags|=0x800;
+		}
+	}
+	//! the file name
+	std::string mName;
+	//! the general purpose flags
+	unsigned mFlags;
+	//! the compression method: 0 (stored) or 8 (deflated)
+	unsigned mMethod;
+	//! the CRC-32
+	unsigned long mCRC;
+	//! the compressed size
+	unsigned long mCompressedSize;
+	//! the uncompressed size
+	unsigned long mSize;
+	//! the position of the local header
+	unsigned long mOffset;
+};
+
+//! the DOS date of the files: 1980-01-01
+unsigned const s_zipDate=(1<<5) | 1;
+//! the maximal value of the sizes and the offsets without the zip64 extensions
+unsigned long const s_zipMaxValue=0xffffffffUL;
+//! the maximal number of files without the zip64 extensions
+size_t const s_zipMaxEntries=0xffff;
+
+void writeUInt16(libodfgen::DataSink &sink, unsigned long value)
+{
+	char const data[2]= { char(value & 0xff), char((value>>8) & 0xff) };
+	sink.append(data, 2);
+}
+
+void writeUInt32(libodfgen::DataSink &sink, unsigned long value)
+{
+	char const data[4]= { char(value & 0xff), char((value>>8) & 0xff), char((value>>16) & 0xff), char((value>>24) & 0xff) };
+	sink.append(data, 4);
+}
+}
+
+//! the internal data of an OdfPackageWriter
+class OdfPackageWriterPrivate
+{
+public:
+	//! constructor
+	OdfPackageWriterPrivate() : mSink(), mEntries(), mpDeflater(), mpXMLWriter(), mbClosed(false), mbTooBig(false)
+	{
+	}
+	//! constructor
+	explicit OdfPackageWriterPrivate(FILE *file) : mSink(file), mEntries(), mpDeflater(), mpXMLWriter(), mbClosed(false), mbTooBig(false)
+	{
+	}
+	//! constructor
+	explicit OdfPackageWriterPrivate(int fd) : mSink(fd), mEntries(), mpDeflater(), mpXMLWriter(), mbClosed(false), mbTooBig(false)
+	{
+	}
+	//! constructor
+	OdfPackageWriterPrivate(OdfXMLWriterCallback callback, void *userData) : mSink(callback, userData), mEntries(), mpDeflater(), mpXMLWriter(), mbClosed(false), mbTooBig(false)
+	{
+	}
+
+	/** returns true if position+length can be stored in a zip field,
+		otherwise sets the error state: nothing more must be written */
+	bool checkZipLimit(unsigned long position, unsigned long length);
+	//! writes the local header of the last entry
+	void writeLocalHeader();
+	//! writes the data descriptor of the last entry
+	void writeDataDescriptor();
+	//! the callback used by the XML writer: compresses the data
+	static bool receiveXMLData(const char *data, unsigned long size, void *userData);
+
+	//! the output
+	libodfgen::DataSink mSink;
+	//! the files
+	std::vector<ZipEntry> mEntries;
+	//! the compressor of the current XML file
+	shared_ptr<libodfgen::Deflater> mpDeflater;
+	//! the writer of the current XML file
+	shared_ptr<OdfXMLWriter> mpXMLWriter;
+	//! true if the directory is written
+	bool mbClosed;
+	//! true if the package exceeds the zip limits
+	bool mbTooBig;
+
+private:
+	OdfPackageWriterPrivate(OdfPackageWriterPrivate const &);
+	OdfPackageWriterPrivate &operator=(OdfPackageWriterPrivate const &);
+};
+
+bool OdfPackageWriterPrivate::checkZipLimit(unsigned long position, unsigned long length)
+{
+	if (!mbTooBig && position<=s_zipMaxValue && length<=s_zipMaxValue-position)
+		return true;
+	ODFGEN_DEBUG_MSG(("OdfPackageWriterPrivate::checkZipLimit: the package is too big\n"));
+	mbTooBig=true;
+	return false;
+}
+
+void OdfPackageWriterPrivate::writeLocalHeader()
+{
+	ZipEntry const &entry=mEntries.back();
+	bool const hasDescriptor=(entry.mFlags & 8)!=0;
+	writeUInt32(mSink, 0x04034b50);
+	writeUInt16(mSink, 20);
+	writeUInt16(mSink, entry.mFlags);
+	writeUInt16(mSink, entry.mMethod);
+	writeUInt16(mSink, 0);
+	writeUInt16(mSink, s_zipDate);
+	writeUInt32(mSink, hasDescriptor ? 0 : entry.mCRC);
+	writeUInt32(mSink, hasDescriptor ? 0 : entry.mCompressedSize);
+	writeUInt32(mSink, hasDescriptor ? 0 : entry.mSize);
+	writeUInt16(mSink, (unsigned long) entry.mName.size());
+	writeUInt16(mSink, 0);
+	mSink.append(entry.mName.c_str(), entry.mName.size());
+}
+
+void OdfPackageWriterPrivate::writeDataDescriptor()
+{
+	ZipEntry const &entry=mEntries.back();
+	writeUInt32(mSink, 0x08074b50);
+	writeUInt32(mSink, entry.mCRC);
+	writeUInt32(mSink, entry.mCompressedSize);
+	writeUInt32(mSink, entry.mSize);
+}
+
+bool OdfPackageWriterPrivate::receiveXMLData(const char *data, unsigned long size, void *userData)
+{
+	OdfPackageWriterPrivate *writer=static_cast<OdfPackageWriterPrivate *>(userData);
+	if (!writer || !writer->mpDeflater || writer->mEntries.empty())
+		return false;
+	ZipEntry &entry=writer->mEntries.back();
+	if (!writer->checkZipLimit(entry.mSize, size))
+		return false;
+	unsigned char const *buffer=reinterpret_cast<unsigned char const *>(data);
+	entry.mCRC=libodfgen::updateCRC32(entry.mCRC, buffer, size);
+	entry.mSize+=size;
+	writer->mpDeflater->write(buffer, size);
+	return true;
+}
+
+OdfPackageWriter::OdfPackageWriter() : mpImpl(new OdfPackageWriterPrivate)
+{
+}
+
+OdfPackageWriter::OdfPackageWriter(FILE *file) : mpImpl(new OdfPackageWriterPrivate(file))
+{
+}
+
+OdfPackageWriter::OdfPackageWriter(int fd) : mpImpl(new OdfPackageWriterPrivate(fd))
+{
+}
+
+OdfPackageWriter::OdfPackageWriter(OdfXMLWriterCallback callback, void *userData) : mpImpl(new OdfPackageWriterPrivate(callback, userData))
+{
+}
+
+OdfPackageWriter::~OdfPackageWriter()
+{
+	delete mpImpl;
+}
+
+bool OdfPackageWriter::addFile(const char *name, const unsigned char *data, unsigned long size, bool compress)
+{
+	if (!name || mpImpl->mbClosed || mpImpl->mbTooBig)
+	{
+		ODFGEN_DEBUG_MSG(("OdfPackageWriter::addFile: can not add a file\n"));
+		return false;
+	}
+	endXMLFile();
+	// the offset and the sizes are stored on 32 bits, they must be checked before writing anything
+	unsigned long const offset=mpImpl->mSink.getPosition();
+	if (!mpImpl->checkZipLimit(offset, 0) || !mpImpl->checkZipLimit(size, 0))
+		return false;
+	mpImpl->mEntries.push_back(ZipEntry(name));
+	ZipEntry &entry=mpImpl->mEntries.back();
+	entry.mOffset=offset;
+	entry.mCRC=libodfgen::updateCRC32(0, data, size);
+	entry.mSize=size;
+	if (!compress || !size)
+	{
+		entry.mCompressedSize=size;
+		mpImpl->writeLocalHeader();
+		mpImpl->mSink.append(reinterpret_cast<const char *>(data), size);
+		return !mpImpl->mSink.hasError();
+	}
+	// the compressed size is only known at the end, it is stored in a data descriptor
+	entry.mFlags|=8;
+	entry.mMethod=8;
+	mpImpl->writeLocalHeader();
+	libodfgen::Deflater deflater(mpImpl->mSink);
+	deflater.write(data, size);
+	deflater.finish();
+	mpImpl->mEntries.back().mCompressedSize=deflater.getCompressedSize();
+	if (!mpImpl->checkZipLimit(mpImpl->mEntries.back().mCompressedSize, 0))
+		return false;
+	mpImpl->writeDataDescriptor();
+	return !mpImpl->mSink.hasError();
+}
+
+OdfDocumentHandler *OdfPackageWriter::startXMLFile(const char *name)
+{
+	if (!name || mpImpl->mbClosed || mpImpl->mbTooBig)
+	{
+		ODFGEN_DEBUG_MSG(("OdfPackageWriter::startXMLFile: can not add a file\n"));
+		return 0;
+	}
+	endXMLFile();
+	unsigned long const offset=mpImpl->mSink.getPosition();
+	if (!mpImpl->checkZipLimit(offset, 0))
+		return 0;
+	mpImpl->mEntries.push_back(ZipEntry(name));
+	ZipEntry &entry=mpImpl->mEntries.back();
+	entry.mOffset=offset;
+	entry.mFlags|=8;
+	entry.mMethod=8;
+	mpImpl->writeLocalHeader();
+	mpImpl->mpDeflater.reset(new libodfgen::Deflater(mpImpl->mSink));
+	mpImpl->mpXMLWriter.reset(new OdfXMLWriter(OdfPackageWriterPrivate::receiveXMLData, mpImpl));
+	return mpImpl->mpXMLWriter.get();
+}
+
+bool OdfPackageWriter::endXMLFile()
+{
+	if (!mpImpl->mpXMLWriter)
+		return false;
+	// destroying the XML writer sends its remaining data
+	mpImpl->mpXMLWriter.reset();
+	mpImpl->mpDeflater->finish();
+	mpImpl->mEntries.back().mCompressedSize=mpImpl->mpDeflater->getCompressedSize();
+	mpImpl->mpDeflater.reset();
+	if (!mpImpl->checkZipLimit(mpImpl->mEntries.back().mCompressedSize, 0))
+		return false;
+	mpImpl->writeDataDescriptor();
+	return !mpImpl->mSink.hasError();
+}
+
+bool OdfPackageWriter::close()
+{
+	if (mpImpl->mbClosed)
+		return false;
+	endXMLFile();
+	mpImpl->mbClosed=true;
+	libodfgen::DataSink &sink=mpImpl->mSink;
+	unsigned long const directoryOffset=sink.getPosition();
+	// check the zip limits before writing anything: the directory and its end record must fit
+	if (mpImpl->mbTooBig || mpImpl->mEntries.size()>s_zipMaxEntries)
+	{
+		ODFGEN_DEBUG_MSG(("OdfPackageWriter::close: the package is too big\n"));
+		mpImpl->mbTooBig=true;
+		return false;
+	}
+	unsigned long totalSize=22;
+	for (size_t i=0; i<mpImpl->mEntries.size(); ++i)
+		totalSize+=46+(unsigned long) mpImpl->mEntries[i].mName.size();
+	if (!mpImpl->checkZipLimit(directoryOffset, totalSize))
+		return false;
+	for (size_t i=0; i<mpImpl->mEntries.size(); ++i)
+	{
+		ZipEntry const &entry=mpImpl->mEntries[i];
+		writeUInt32(sink, 0x02014b50);
+		writeUInt16(sink, 20);
+		writeUInt16(sink, 20);
+		writeUInt16(sink, entry.mFlags);
+		writeUInt16(sink, entry.mMethod);
+		writeUInt16(sink, 0);
+		writeUInt16(sink, s_zipDate);
+		writeUInt32(sink, entry.mCRC);
+		writeUInt32(sink, entry.mCompressedSize);
+		writeUInt32(sink, entry.mSize);
+		writeUInt16(sink, (unsigned long) entry.mName.size());
+		writeUInt16(sink, 0);
+		writeUInt16(sink, 0);
+		writeUInt16(sink, 0);
+		writeUInt16(sink, 0);
+		writeUInt32(sink, 0);
+		writeUInt32(sink, entry.mOffset);
+		sink.append(entry.mName.c_str(), entry.mName.size());
+	}
+	unsigned long const directorySize=sink.getPosition()-directoryOffset;
+	writeUInt32(sink, 0x06054b50);
+	writeUInt16(sink, 0);
+	writeUInt16(sink, 0);
+	writeUInt16(sink, (unsigned long) mpImpl->mEntries.size());
+	writeUInt16(sink, (unsigned long) mpImpl->mEntries.size());
+	writeUInt32(sink, directorySize);
+	writeUInt32(sink, directoryOffset);
+	writeUInt16(sink, 0);
+	sink.flush();
+	return !sink.hasError();
+}
+
+const char *OdfPackageWriter::getData() const
+{
+	return mpImpl->mSink.getData();
+}
+
+unsigned long OdfPackageWriter::getDataSize() const
+{
+	return (unsigned long) mpImpl->mSink.getDataSize();
+}
+
+bool OdfPackageWriter::hasError() const
+{
+	return mpImpl->mSink.hasError() || mpImpl->mbTooBig;
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 noexpandtab: */
@@ -0,0 +1,241 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* libodfgen
+ * Version: MPL 2.0 / LGPLv2.1+
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU Lesser General Public License Version 2.1 or later
+ * (LGPLv2.1+), in which case the provisions of the LGPLv2.1+ are
+ * applicable instead of those above.
+ *
+ * For further information visit http://libwpd.sourceforge.net
+ */
+
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ODFGEN_XML_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#include <libodfgen/OdfXMLWriter.hxx>
+
+#include "DataSink.hxx"
+
+namespace
+{
+//! returns true if a character must be escaped
+inline bool isSpecialCharacter(char c)
+{
+	return c=='&' || c=='<' || c=='>' || c=='"' || c=='\'';
+}
+
+//! returns the length of the beginning of data which does not need to be escaped
+size_t getUnescapedLength(const char *data, size_t length)
+{
+	size_t pos=0;
+#ifdef ODFGEN_XML_SSE2
+	// check 16 characters at once
+	__m128i const amp=_mm_set1_epi8('&');
+	__m128i const lt=_mm_set1_epi8('<');
+	__m128i const gt=_mm_set1_epi8('>');
+	__m128i const quot=_mm_set1_epi8('"');
+	__m128i const apos=_mm_set1_epi8('\'');
+	for (; pos+16<=length; pos+=16)
+	{
+		__m128i const block=_mm_loadu_si128(reinterpret_cast<__m128i const *>(data+pos));
+		__m128i special=_mm_or_si128(_mm_cmpeq_epi8(block, amp), _mm_cmpeq_epi8(block, lt));
+		special=_mm_or_si128(special, _mm_cmpeq_epi8(block, gt));
+		special=_mm_or_si128(special, _mm_cmpeq_epi8(block, quot));
+		special=_mm_or_si128(special, _mm_cmpeq_epi8(block, apos));
+		int const mask=_mm_movemask_epi8(special);
+		if (!mask)
+			continue;
+		for (int bit=0; bit<16; ++bit)
+		{
+			if (mask & (1<<bit))
+				return pos+size_t(bit);
+		}
+	}
+#endif
+	for (; pos<length; ++pos)
+	{
+		if (isSpecialCharacter(data[pos]))
+			break;
+	}
+	return pos;
+}
+
+//! returns the entity corresponding to a special character
+char const *getEntity(char c)
+{
+	switch (c)
+	{
+	case '&':
+		return "&amp;";
+	case '<':
+		return "&lt;";
+	case '>':
+		return "&gt;";
+	case '"':
+		return "&quot;";
+	case '\'':
+	default:
+		break;
+	}
+	return "&apos;";
+}
+}
+
+//! the internal data of an OdfXMLWriter
+class OdfXMLWriterPrivate
+{
+public:
+	//! constructor
+	OdfXMLWriterPrivate() : mSink(), mbTagOpened(false)
+	{
+	}
+	//! constructor
+	explicit OdfXMLWriterPrivate(FILE *file) : mSink(file), mbTagOpened(false)
+	{
+	}
+	//! constructor
+	explicit OdfXMLWriterPrivate(int fd) : mSink(fd), mbTagOpened(false)
+	{
+	}
+	//! constructor
+	OdfXMLWriterPrivate(OdfXMLWriterCallback callback, void *userData) : mSink(callback, userData), mbTagOpened(false)
+	{
+	}
+
+	//! adds data in the sink, escaping the special characters
+	void appendEscaped(const char *data, size_t length);
+	//! closes the current start tag if needed
+	void closeStartTag()
+	{
+		if (!mbTagOpened)
+			return;
+		mSink.append(">", 1);
+		mbTagOpened=false;
+	}
+
+	//! the output
+	libodfgen::DataSink mSink;
+	//! true if the last start tag is not closed
+	bool mbTagOpened;
+
+private:
+	OdfXMLWriterPrivate(OdfXMLWriterPrivate const &);
+	OdfXMLWriterPrivate &operator=(OdfXMLWriterPrivate const &);
+};
+
+void OdfXMLWriterPrivate::appendEscaped(const char *data, size_t length)
+{
+	while (length)
+	{
+		size_t const unescaped=getUnescapedLength(data, length);
+		mSink.append(data, unescaped);
+		if (unescaped==length)
+			break;
+		mSink.append(getEntity(data[unescaped]));
+		data+=unescaped+1;
+		length-=unescaped+1;
+	}
+}
+
+OdfXMLWriter::OdfXMLWriter() : mpImpl(new OdfXMLWriterPrivate)
+{
+}
+
+OdfXMLWriter::OdfXMLWriter(FILE *file) : mpImpl(new OdfXMLWriterPrivate(file))
+{
+}
+
+OdfXMLWriter::OdfXMLWriter(int fd) : mpImpl(new OdfXMLWriterPrivate(fd))
+{
+}
+
+OdfXMLWriter::OdfXMLWriter(OdfXMLWriterCallback callback, void *userData) : mpImpl(new OdfXMLWriterPrivate(callback, userData))
+{
+}
+
+OdfXMLWriter::~OdfXMLWriter()
+{
+	delete mpImpl;
+}
+
+const char *OdfXMLWriter::getData() const
+{
+	return mpImpl->mSink.getData();
+}
+
+unsigned long OdfXMLWriter::getDataSize() const
+{
+	return (unsigned long) mpImpl->mSink.getDataSize();
+}
+
+bool OdfXMLWriter::hasError() const
+{
+	return mpImpl->mSink.hasError();
+}
+
+void OdfXMLWriter::startDocument()
+{
+	mpImpl->mbTagOpened=false;
+	mpImpl->mSink.append("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+}
+
+void OdfXMLWriter::endDocument()
+{
+	mpImpl->closeStartTag();
+	mpImpl->mSink.flush();
+}
+
+void OdfXMLWriter::startElement(const char *psName, const OdfAttribute *pAttributes, unsigned long numAttributes)
+{
+	mpImpl->closeStartTag();
+	mpImpl->mSink.append("<", 1);
+	mpImpl->mSink.append(psName);
+	for (unsigned long i=0; i<numAttributes; ++i)
+	{
+		OdfAttribute const &attribute=pAttributes[i];
+		// filter out librevenge elements
+		if (!strncmp(attribute.name, "librevenge:", 11))
+			continue;
+		mpImpl->mSink.append(" ", 1);
+		mpImpl->mSink.append(attribute.name);
+		mpImpl->mSink.append("=\"", 2);
+		if (attribute.escaped)
+			mpImpl->mSink.append(attribute.value, attribute.length);
+		else
+			mpImpl->appendEscaped(attribute.value, attribute.length);
+		mpImpl->mSink.append("\"", 1);
+	}
+	mpImpl->mbTagOpened=true;
+}
+
+void OdfXMLWriter::endElement(const char *psName)
+{
+	if (mpImpl->mbTagOpened)
+	{
+		mpImpl->mSink.append("/>", 2);
+		mpImpl->mbTagOpened=false;
+		return;
+	}
+	mpImpl->mSink.append("</", 2);
+	mpImpl->mSink.append(psName);
+	mpImpl->mSink.append(">", 1);
+}
+
+void OdfXMLWriter::characters(const char *psCharacters, unsigned long length)
+{
+	mpImpl->closeStartTag();
+	mpImpl->appendEscaped(psCharacters, length);
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 noexpandtab: */
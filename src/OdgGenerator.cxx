@@ -68,6 +68,11 @@ public:
 	void updatePageSpanPropertiesToCreatePage(librevenge::RVNGPropertyList &propList);
 
 	bool writeTargetDocument(OdfDocumentHandler *pHandler, OdfStreamType streamType);
+	//! returns the document mime type
+	char const *getDocumentMimeType() const
+	{
+		return "application/vnd.oasis.opendocument.graphics";
+	}
 	void _writeSettings(OdfDocumentHandler *pHandler);
 	void _writeStyles(OdfDocumentHandler *pHandler);
 	void _writeAutomaticStyles(OdfDocumentHandler *pHandler, OdfStreamType streamType);
@@ -265,7 +270,7 @@ bool OdgGeneratorPrivate::writeTargetDocument(OdfDocumentHandler *pHandler, OdfS
 		manifestElement.addAttribute("xmlns:manifest", "urn:oasis:names:tc:opendocument:xmlns:manifest:1.0");
 		manifestElement.write(pHandler);
 		TagOpenElement mainFile("manifest:file-entry");
-		mainFile.addAttribute("manifest:media-type", "application/vnd.oasis.opendocument.graphics");
+		mainFile.addAttribute("manifest:media-type", getDocumentMimeType());
 		mainFile.addAttribute("manifest:full-path", "/");
 		mainFile.write(pHandler);
 		TagCloseElement("manifest:file-entry").write(pHandler);
@@ -291,9 +296,9 @@ bool OdgGeneratorPrivate::writeTargetDocument(OdfDocumentHandler *pHandler, OdfS
 	docContentPropList.addAttribute("xmlns:fo", "urn:oasis:names:tc:opendocument:xmlns:xsl-fo-compatible:1.0");
 	docContentPropList.addAttribute("xmlns:config", "urn:oasis:names:tc:opendocument:xmlns:config:1.0");
 	docContentPropList.addAttribute("xmlns:ooo", "http://openoffice.org/2004/office");
-	docContentPropList.addAttribute("office:version", "1.0", true);
+	docContentPropList.addAttribute("office:version", "1.0");
 	if (streamType == ODF_FLAT_XML)
-		docContentPropList.addAttribute("office:mimetype", "application/vnd.oasis.opendocument.graphics");
+		docContentPropList.addAttribute("office:mimetype", getDocumentMimeType());
 	docContentPropList.write(pHandler);
 
 	if (streamType == ODF_FLAT_XML || streamType == ODF_META_XML)
@@ -365,8 +370,73 @@ bool OdgGenerator::getObjectContent(librevenge::RVNGString const &objectName, Od
 	return mpImpl->getObjectContent(objectName, pHandler);
 }
 
+void OdgGenerator::setContentStreaming(bool stream)
+{
+	if (mpImpl)
+		mpImpl->setContentStreaming(stream);
+}
+
+void OdgGenerator::setPackageWriter(OdfPackageWriter *pWriter)
+{
+	if (mpImpl)
+		mpImpl->setPackageWriter(pWriter);
+}
+
+void OdgGenerator::setParallelWriting(bool parallel)
+{
+	if (mpImpl)
+		mpImpl->setParallelWriting(parallel);
+}
+
+void OdgGenerator::setExternalPictures(bool external)
+{
+	if (mpImpl)
+		mpImpl->setExternalPictures(external);
+}
+
+void OdgGenerator::setAsynchronousImageConversion(bool async)
+{
+	if (mpImpl)
+		mpImpl->setAsynchronousImageConversion(async);
+}
+
+void OdgGenerator::setEmbeddedObjectCacheSize(unsigned size)
+{
+	if (mpImpl)
+		mpImpl->setEmbeddedObjectCacheSize(size);
+}
+
+void OdgGenerator::getEmbeddedObjectCacheStatistics(unsigned long &hits, unsigned long &misses) const
+{
+	hits=misses=0;
+	if (mpImpl)
+		mpImpl->getEmbeddedObjectCacheStatistics(hits, misses);
+}
+
+void OdgGenerator::getStyleCacheStatistics(unsigned long &hits, unsigned long &misses) const
+{
+	hits=misses=0;
+	if (mpImpl)
+		mpImpl->getStyleCacheStatistics(hits, misses);
+}
+
+librevenge::RVNGStringVector OdgGenerator::getPictureNames() const
+{
+	if (mpImpl)
+		return mpImpl->getPictureNames();
+	return librevenge::RVNGStringVector();
+}
+
+bool OdgGenerator::getPictureContent(librevenge::RVNGString const &name, librevenge::RVNGBinaryData &data, librevenge::RVNGString &mimeType) const
+{
+	if (!mpImpl)
+		return false;
+	return mpImpl->getPictureContent(name, data, mimeType);
+}
+
 void OdgGenerator::startDocument(const librevenge::RVNGPropertyList &)
 {
+	mpImpl->startContentStreaming();
 }
 
 void OdgGenerator::endDocument()
@@ -413,7 +483,7 @@ void OdgGenerator::startPage(const ::librevenge::RVNGPropertyList &propList)
 	else
 		pageName.sprintf("page%i", mpImpl->miPageIndex);
 	TagOpenElement *pDrawPageOpenElement = new TagOpenElement("draw:page");
-	pDrawPageOpenElement->addAttribute("draw:name", pageName);
+	pDrawPageOpenElement->addEscapedAttribute("draw:name", pageName);
 	pDrawPageOpenElement->addAttribute("draw:style-name", mpImpl->mpCurrentPageSpan->getDrawingName());
 	pDrawPageOpenElement->addAttribute("draw:master-page-name", mpImpl->mpCurrentPageSpan->getMasterName());
 	mpImpl->getCurrentStorage()->push_back(pDrawPageOpenElement);
@@ -421,7 +491,7 @@ void OdgGenerator::startPage(const ::librevenge::RVNGPropertyList &propList)
 
 void OdgGenerator::endPage()
 {
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("draw:page"));
+	mpImpl->getCurrentStorage()->push_back(TagCloseElement("draw:page"));
 }
 
 void OdgGenerator::startMasterPage(const ::librevenge::RVNGPropertyList &propList)
@@ -488,7 +558,7 @@ void OdgGenerator::startLayer(const ::librevenge::RVNGPropertyList &propList)
 	else
 	{
 		mpImpl->getState().mbInFalseLayerGroup=true;
-		mpImpl->getCurrentStorage()->push_back(new TagOpenElement("draw:g"));
+		mpImpl->getCurrentStorage()->push_back(TagOpenElement("draw:g"));
 	}
 }
 
@@ -498,7 +568,7 @@ void OdgGenerator::endLayer()
 		return;
 
 	if (mpImpl->getState().mbInFalseLayerGroup)
-		mpImpl->getCurrentStorage()->push_back(new TagCloseElement("draw:g"));
+		mpImpl->getCurrentStorage()->push_back(TagCloseElement("draw:g"));
 	else
 		mpImpl->closeLayer();
 	mpImpl->popState();
@@ -506,12 +576,12 @@ void OdgGenerator::endLayer()
 
 void OdgGenerator::openGroup(const ::librevenge::RVNGPropertyList & /* propList */)
 {
-	mpImpl->getCurrentStorage()->push_back(new TagOpenElement("draw:g"));
+	mpImpl->getCurrentStorage()->push_back(TagOpenElement("draw:g"));
 }
 
 void OdgGenerator::closeGroup()
 {
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("draw:g"));
+	mpImpl->getCurrentStorage()->push_back(TagCloseElement("draw:g"));
 }
 
 void OdgGenerator::drawRectangle(const ::librevenge::RVNGPropertyList &propList)
@@ -609,7 +679,7 @@ void OdgGenerator::drawGraphicObject(const ::librevenge::RVNGPropertyList &propL
 	pDrawFrameElement->addAttribute("draw:style-name",
 	                                mpImpl->getGraphicManager().findOrAdd
 	                                (finalStyle, mpImpl->useStyleAutomaticZone() ? Style::Z_StyleAutomatic : Style::Z_ContentAutomatic));
-	pDrawFrameElement->addAttribute("draw:layer", mpImpl->getLayerName(propList));
+	pDrawFrameElement->addEscapedAttribute("draw:layer", mpImpl->getLayerName(propList));
 
 	pDrawFrameElement->addAttribute("svg:height", framePropList["svg:height"]->getStr());
 	pDrawFrameElement->addAttribute("svg:width", framePropList["svg:width"]->getStr());
@@ -633,7 +703,7 @@ void OdgGenerator::drawGraphicObject(const ::librevenge::RVNGPropertyList &propL
 
 	mpImpl->insertBinaryObject(propList);
 
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("draw:frame"));
+	mpImpl->getCurrentStorage()->push_back(TagCloseElement("draw:frame"));
 }
 
 void OdgGenerator::drawConnector(const ::librevenge::RVNGPropertyList &propList)
@@ -670,7 +740,7 @@ void OdgGenerator::startTextObject(const librevenge::RVNGPropertyList &propList)
 
 	TagOpenElement *pDrawFrameOpenElement = new TagOpenElement("draw:frame");
 	pDrawFrameOpenElement->addAttribute("draw:style-name", sValue);
-	pDrawFrameOpenElement->addAttribute("draw:layer", mpImpl->getLayerName(propList));
+	pDrawFrameOpenElement->addEscapedAttribute("draw:layer", mpImpl->getLayerName(propList));
 
 	if (!propList["svg:width"] && !propList["svg:height"])
 	{
@@ -745,7 +815,7 @@ void OdgGenerator::startTextObject(const librevenge::RVNGPropertyList &propList)
 			pDrawFrameOpenElement->addAttribute("svg:y", svg_y->getStr());
 	}
 	mpImpl->getCurrentStorage()->push_back(pDrawFrameOpenElement);
-	mpImpl->getCurrentStorage()->push_back(new TagOpenElement("draw:text-box"));
+	mpImpl->getCurrentStorage()->push_back(TagOpenElement("draw:text-box"));
 
 	// push the different states
 	mpImpl->pushState();
@@ -767,8 +837,8 @@ void OdgGenerator::endTextObject()
 	mpImpl->popListState();
 	mpImpl->popState();
 
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("draw:text-box"));
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("draw:frame"));
+	mpImpl->getCurrentStorage()->push_back(TagCloseElement("draw:text-box"));
+	mpImpl->getCurrentStorage()->push_back(TagCloseElement("draw:frame"));
 }
 
 void OdgGenerator::startTableObject(const ::librevenge::RVNGPropertyList &propList)
@@ -777,7 +847,7 @@ void OdgGenerator::startTableObject(const ::librevenge::RVNGPropertyList &propLi
 	TagOpenElement *pFrameOpenElement = new TagOpenElement("draw:frame");
 
 	pFrameOpenElement->addAttribute("draw:style-name", "standard");
-	pFrameOpenElement->addAttribute("draw:layer", mpImpl->getLayerName(propList));
+	pFrameOpenElement->addEscapedAttribute("draw:layer", mpImpl->getLayerName(propList));
 
 	if (propList["svg:x"])
 		pFrameOpenElement->addAttribute("svg:x", propList["svg:x"]->getStr());
@@ -801,7 +871,7 @@ void OdgGenerator::endTableObject()
 	mpImpl->popListState();
 
 	mpImpl->closeTable();
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("draw:frame"));
+	mpImpl->getCurrentStorage()->push_back(TagCloseElement("draw:frame"));
 }
 
 void OdgGenerator::openTableRow(const ::librevenge::RVNGPropertyList &propList)
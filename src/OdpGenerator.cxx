@@ -103,6 +103,11 @@ public:
 
 	//! returns the document type
 	bool writeTargetDocument(OdfDocumentHandler *pHandler, OdfStreamType streamType);
+	//! returns the document mime type
+	char const *getDocumentMimeType() const
+	{
+		return "application/vnd.oasis.opendocument.presentation";
+	}
 	void _writeSettings(OdfDocumentHandler *pHandler);
 	void _writeStyles(OdfDocumentHandler *pHandler);
 	void _writeAutomaticStyles(OdfDocumentHandler *pHandler, OdfStreamType streamType);
@@ -256,7 +261,7 @@ void OdpGeneratorPrivate::openTextBoxFrame(const ::librevenge::RVNGPropertyList
 
 void OdpGeneratorPrivate::closeTextBoxFrame()
 {
-	getCurrentStorage()->push_back(new TagCloseElement("draw:frame"));
+	getCurrentStorage()->push_back(TagCloseElement("draw:frame"));
 }
 
 void OdpGeneratorPrivate::writeNotesStyles(OdfDocumentHandler *pHandler)
@@ -418,7 +423,7 @@ bool OdpGeneratorPrivate::writeTargetDocument(OdfDocumentHandler *pHandler, OdfS
 		manifestElement.write(pHandler);
 
 		TagOpenElement mainFile("manifest:file-entry");
-		mainFile.addAttribute("manifest:media-type", "application/vnd.oasis.opendocument.presentation");
+		mainFile.addAttribute("manifest:media-type", getDocumentMimeType());
 		mainFile.addAttribute("manifest:full-path", "/");
 		mainFile.write(pHandler);
 		TagCloseElement("manifest:file-entry").write(pHandler);
@@ -448,9 +453,9 @@ bool OdpGeneratorPrivate::writeTargetDocument(OdfDocumentHandler *pHandler, OdfS
 	// WARNING: this is not ODF!
 	docContentPropList.addAttribute("xmlns:ooo", "http://openoffice.org/2004/office");
 	docContentPropList.addAttribute("xmlns:officeooo", "http://openoffice.org/2009/office");
-	docContentPropList.addAttribute("office:version", "1.0", true);
+	docContentPropList.addAttribute("office:version", "1.0");
 	if (streamType == ODF_FLAT_XML)
-		docContentPropList.addAttribute("office:mimetype", "application/vnd.oasis.opendocument.presentation");
+		docContentPropList.addAttribute("office:mimetype", getDocumentMimeType());
 	docContentPropList.write(pHandler);
 
 	if ((streamType == ODF_FLAT_XML) || (streamType == ODF_META_XML))
@@ -524,8 +529,73 @@ bool OdpGenerator::getObjectContent(librevenge::RVNGString const &objectName, Od
 	return mpImpl->getObjectContent(objectName, pHandler);
 }
 
+void OdpGenerator::setContentStreaming(bool stream)
+{
+	if (mpImpl)
+		mpImpl->setContentStreaming(stream);
+}
+
+void OdpGenerator::setPackageWriter(OdfPackageWriter *pWriter)
+{
+	if (mpImpl)
+		mpImpl->setPackageWriter(pWriter);
+}
+
+void OdpGenerator::setParallelWriting(bool parallel)
+{
+	if (mpImpl)
+		mpImpl->setParallelWriting(parallel);
+}
+
+void OdpGenerator::setExternalPictures(bool external)
+{
+	if (mpImpl)
+		mpImpl->setExternalPictures(external);
+}
+
+void OdpGenerator::setAsynchronousImageConversion(bool async)
+{
+	if (mpImpl)
+		mpImpl->setAsynchronousImageConversion(async);
+}
+
+void OdpGenerator::setEmbeddedObjectCacheSize(unsigned size)
+{
+	if (mpImpl)
+		mpImpl->setEmbeddedObjectCacheSize(size);
+}
+
+void OdpGenerator::getEmbeddedObjectCacheStatistics(unsigned long &hits, unsigned long &misses) const
+{
+	hits=misses=0;
+	if (mpImpl)
+		mpImpl->getEmbeddedObjectCacheStatistics(hits, misses);
+}
+
+void OdpGenerator::getStyleCacheStatistics(unsigned long &hits, unsigned long &misses) const
+{
+	hits=misses=0;
+	if (mpImpl)
+		mpImpl->getStyleCacheStatistics(hits, misses);
+}
+
+librevenge::RVNGStringVector OdpGenerator::getPictureNames() const
+{
+	if (mpImpl)
+		return mpImpl->getPictureNames();
+	return librevenge::RVNGStringVector();
+}
+
+bool OdpGenerator::getPictureContent(librevenge::RVNGString const &name, librevenge::RVNGBinaryData &data, librevenge::RVNGString &mimeType) const
+{
+	if (!mpImpl)
+		return false;
+	return mpImpl->getPictureContent(name, data, mimeType);
+}
+
 void OdpGenerator::startDocument(const ::librevenge::RVNGPropertyList &/*propList*/)
 {
+	mpImpl->startContentStreaming();
 }
 
 void OdpGenerator::endDocument()
@@ -572,7 +642,7 @@ void OdpGenerator::startSlide(const ::librevenge::RVNGPropertyList &propList)
 	else
 		pageName.sprintf("page%i", mpImpl->miPageIndex);
 	TagOpenElement *pDrawPageOpenElement = new TagOpenElement("draw:page");
-	pDrawPageOpenElement->addAttribute("draw:name", pageName);
+	pDrawPageOpenElement->addEscapedAttribute("draw:name", pageName);
 	pDrawPageOpenElement->addAttribute("draw:style-name", mpImpl->mpCurrentPageSpan->getDrawingName());
 	pDrawPageOpenElement->addAttribute("draw:master-page-name", mpImpl->mpCurrentPageSpan->getMasterName());
 	mpImpl->getCurrentStorage()->push_back(pDrawPageOpenElement);
@@ -580,7 +650,7 @@ void OdpGenerator::startSlide(const ::librevenge::RVNGPropertyList &propList)
 
 void OdpGenerator::endSlide()
 {
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("draw:page"));
+	mpImpl->getCurrentStorage()->push_back(TagCloseElement("draw:page"));
 }
 
 void OdpGenerator::startMasterSlide(const ::librevenge::RVNGPropertyList &propList)
@@ -762,7 +832,7 @@ void OdpGenerator::drawGraphicObject(const ::librevenge::RVNGPropertyList &propL
 
 	mpImpl->insertBinaryObject(propList);
 
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("draw:frame"));
+	mpImpl->getCurrentStorage()->push_back(TagCloseElement("draw:frame"));
 }
 
 void OdpGenerator::drawConnector(const ::librevenge::RVNGPropertyList &propList)
@@ -791,7 +861,7 @@ void OdpGenerator::closeGroup()
 void OdpGenerator::startTextObject(const librevenge::RVNGPropertyList &propList)
 {
 	mpImpl->openTextBoxFrame(propList);
-	mpImpl->getCurrentStorage()->push_back(new TagOpenElement("draw:text-box"));
+	mpImpl->getCurrentStorage()->push_back(TagOpenElement("draw:text-box"));
 	mpImpl->mState.mbIsTextBox = true;
 	mpImpl->pushListState();
 }
@@ -803,7 +873,7 @@ void OdpGenerator::endTextObject()
 
 	mpImpl->popListState();
 	mpImpl->mState.mbIsTextBox = false;
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("draw:text-box"));
+	mpImpl->getCurrentStorage()->push_back(TagCloseElement("draw:text-box"));
 	mpImpl->closeTextBoxFrame();
 }
 
@@ -930,7 +1000,7 @@ void OdpGenerator::endTableObject()
 	if (mpImpl->mState.mInComment)
 		return;
 	mpImpl->closeTable();
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("draw:frame"));
+	mpImpl->getCurrentStorage()->push_back(TagCloseElement("draw:frame"));
 	mpImpl->popListState();
 }
 
@@ -1032,7 +1102,7 @@ void OdpGenerator::endComment()
 	}
 	mpImpl->popListState();
 	mpImpl->mState.mInComment = false;
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("officeooo:annotation"));
+	mpImpl->getCurrentStorage()->push_back(TagCloseElement("officeooo:annotation"));
 }
 
 void OdpGenerator::startNotes(const ::librevenge::RVNGPropertyList &/*propList*/)
@@ -1063,7 +1133,7 @@ void OdpGenerator::startNotes(const ::librevenge::RVNGPropertyList &/*propList*/
 	thumbnailElement->addAttribute("draw:page-number", pageNumber);
 
 	mpImpl->getCurrentStorage()->push_back(thumbnailElement);
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("draw:page-thumbnail"));
+	mpImpl->getCurrentStorage()->push_back(TagCloseElement("draw:page-thumbnail"));
 
 	TagOpenElement *const frameElement = new TagOpenElement("draw:frame");
 	frameElement->addAttribute("presentation:style-name", "PresentationNotesFrame");
@@ -1076,7 +1146,7 @@ void OdpGenerator::startNotes(const ::librevenge::RVNGPropertyList &/*propList*/
 
 	mpImpl->getCurrentStorage()->push_back(frameElement);
 
-	mpImpl->getCurrentStorage()->push_back(new TagOpenElement("draw:text-box"));
+	mpImpl->getCurrentStorage()->push_back(TagOpenElement("draw:text-box"));
 
 	mpImpl->mState.mInNotes = true;
 }
@@ -1091,9 +1161,9 @@ void OdpGenerator::endNotes()
 	mpImpl->popListState();
 	mpImpl->mState.mInNotes = false;
 
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("draw:text-box"));
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("draw:frame"));
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("presentation:notes"));
+	mpImpl->getCurrentStorage()->push_back(TagCloseElement("draw:text-box"));
+	mpImpl->getCurrentStorage()->push_back(TagCloseElement("draw:frame"));
+	mpImpl->getCurrentStorage()->push_back(TagCloseElement("presentation:notes"));
 }
 
 void OdpGenerator::defineChartStyle(const ::librevenge::RVNGPropertyList &)
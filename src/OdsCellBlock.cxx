@@ -0,0 +1,166 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* libodfgen
+ * Version: MPL 2.0 / LGPLv2.1+
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU Lesser General Public License Version 2.1 or later
+ * (LGPLv2.1+), in which case the provisions of the LGPLv2.1+ are
+ * applicable instead of those above.
+ *
+ * For further information visit http://libwpd.sourceforge.net
+ */
+
+#include <vector>
+
+#include <libodfgen/OdsCellBlock.hxx>
+
+#include "FilterInternal.hxx"
+
+class OdsCellBlockPrivate
+{
+public:
+	//! a column of the block
+	struct Column
+	{
+		//! constructor
+		Column(OdsCellBlock::ValueType type) : mType(type), mpFloats(0), mpStrings(0), mpBooleans(0)
+		{
+		}
+		//! the value type
+		OdsCellBlock::ValueType mType;
+		//! the values of a Float column
+		const double *mpFloats;
+		//! the values of a String or a Date column
+		const char *const *mpStrings;
+		//! the values of a Boolean column
+		const bool *mpBooleans;
+	};
+
+	explicit OdsCellBlockPrivate(unsigned numRows) : mNumRows(numRows), mColumns()
+	{
+	}
+	//! returns a column or 0
+	Column const *getColumn(unsigned column) const
+	{
+		if (column>=mColumns.size())
+		{
+			ODFGEN_DEBUG_MSG(("OdsCellBlockPrivate::getColumn: bad column %u\n", column));
+			return 0;
+		}
+		return &mColumns[column];
+	}
+
+	//! the number of rows
+	unsigned mNumRows;
+	//! the columns
+	std::vector<Column> mColumns;
+};
+
+OdsCellBlock::OdsCellBlock(unsigned numRows) : mpImpl(new OdsCellBlockPrivate(numRows))
+{
+}
+
+OdsCellBlock::~OdsCellBlock()
+{
+	delete mpImpl;
+}
+
+unsigned OdsCellBlock::getNumRows() const
+{
+	return mpImpl->mNumRows;
+}
+
+unsigned OdsCellBlock::getNumColumns() const
+{
+	return unsigned(mpImpl->mColumns.size());
+}
+
+void OdsCellBlock::clear()
+{
+	mpImpl->mColumns.clear();
+}
+
+void OdsCellBlock::addEmptyColumn()
+{
+	mpImpl->mColumns.push_back(OdsCellBlockPrivate::Column(Empty));
+}
+
+void OdsCellBlock::addFloatColumn(const double *values)
+{
+	if (!values && mpImpl->mNumRows)
+	{
+		ODFGEN_DEBUG_MSG(("OdsCellBlock::addFloatColumn: called without values\n"));
+		return addEmptyColumn();
+	}
+	OdsCellBlockPrivate::Column column(Float);
+	column.mpFloats=values;
+	mpImpl->mColumns.push_back(column);
+}
+
+void OdsCellBlock::addStringColumn(const char *const *values)
+{
+	if (!values && mpImpl->mNumRows)
+	{
+		ODFGEN_DEBUG_MSG(("OdsCellBlock::addStringColumn: called without values\n"));
+		return addEmptyColumn();
+	}
+	OdsCellBlockPrivate::Column column(String);
+	column.mpStrings=values;
+	mpImpl->mColumns.push_back(column);
+}
+
+void OdsCellBlock::addBooleanColumn(const bool *values)
+{
+	if (!values && mpImpl->mNumRows)
+	{
+		ODFGEN_DEBUG_MSG(("OdsCellBlock::addBooleanColumn: called without values\n"));
+		return addEmptyColumn();
+	}
+	OdsCellBlockPrivate::Column column(Boolean);
+	column.mpBooleans=values;
+	mpImpl->mColumns.push_back(column);
+}
+
+void OdsCellBlock::addDateColumn(const char *const *values)
+{
+	if (!values && mpImpl->mNumRows)
+	{
+		ODFGEN_DEBUG_MSG(("OdsCellBlock::addDateColumn: called without values\n"));
+		return addEmptyColumn();
+	}
+	OdsCellBlockPrivate::Column column(Date);
+	column.mpStrings=values;
+	mpImpl->mColumns.push_back(column);
+}
+
+OdsCellBlock::ValueType OdsCellBlock::getColumnType(unsigned column) const
+{
+	OdsCellBlockPrivate::Column const *col=mpImpl->getColumn(column);
+	return col ? col->mType : Empty;
+}
+
+const double *OdsCellBlock::getFloatValues(unsigned column) const
+{
+	OdsCellBlockPrivate::Column const *col=mpImpl->getColumn(column);
+	return col ? col->mpFloats : 0;
+}
+
+const char *const *OdsCellBlock::getStringValues(unsigned column) const
+{
+	OdsCellBlockPrivate::Column const *col=mpImpl->getColumn(column);
+	return col ? col->mpStrings : 0;
+}
+
+const bool *OdsCellBlock::getBooleanValues(unsigned column) const
+{
+	OdsCellBlockPrivate::Column const *col=mpImpl->getColumn(column);
+	return col ? col->mpBooleans : 0;
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 noexpandtab: */
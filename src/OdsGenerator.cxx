@@ -46,6 +46,77 @@
 #include "OdcGenerator.hxx"
 #include "OdfGenerator.hxx"
 
+namespace
+{
+/** a sparse index of the cells of a sheet, used to accept the rows and the
+	cells in any order: the rows are sorted by row and each row stores its
+	cells sorted by column */
+struct SheetCellIndex
+{
+	//! a stored cell
+	struct Cell
+	{
+		//! constructor
+		Cell() : miColumn(0), mpOpenElement(), mpContent(), mbCanBeRepeated(false)
+		{
+		}
+		//! the cell column
+		int miColumn;
+		//! the cell opening tag
+		shared_ptr<TagOpenElement> mpOpenElement;
+		//! the cell content (if the cell is not empty)
+		shared_ptr<libodfgen::DocumentElementVector> mpContent;
+		//! a flag to know if the cell can be merged with the following cells
+		bool mbCanBeRepeated;
+	};
+	//! a stored row
+	struct Row
+	{
+		//! constructor
+		Row() : msStyleName(), mbCanBeRepeated(true), mCells()
+		{
+		}
+		//! adds a cell, replacing the cell previously stored in the same column
+		void insert(Cell const &cell)
+		{
+			// the cells are usually sent in order, so check the last cell first
+			if (mCells.empty() || mCells.back().miColumn < cell.miColumn)
+			{
+				mCells.push_back(cell);
+				return;
+			}
+			std::vector<Cell>::iterator it=mCells.begin();
+			size_t minPos=0, maxPos=mCells.size()-1;
+			while (minPos<maxPos)
+			{
+				size_t const pos=(minPos+maxPos)/2;
+				if (mCells[pos].miColumn < cell.miColumn)
+					minPos=pos+1;
+				else
+					maxPos=pos;
+			}
+			it+=std::ptrdiff_t(minPos);
+			if (it->miColumn==cell.miColumn)
+				*it=cell;
+			else
+				mCells.insert(it, cell);
+		}
+		//! the row style name
+		librevenge::RVNGString msStyleName;
+		//! a flag to know if the row can be merged with the following rows
+		bool mbCanBeRepeated;
+		//! the cells sorted by column
+		std::vector<Cell> mCells;
+	};
+	//! constructor
+	SheetCellIndex() : mRows()
+	{
+	}
+	//! the rows sorted by row
+	std::map<int, Row> mRows;
+};
+}
+
 class OdsGeneratorPrivate : public OdfGenerator
 {
 public:
@@ -210,7 +281,8 @@ public:
 		}
 		if (add && !state.mbInSheetShapes)
 		{
-			getCurrentStorage()->push_back(new TagOpenElement("table:shapes"));
+			flushPendingRows();
+			getCurrentStorage()->push_back(TagOpenElement("table:shapes"));
 			state.mbInSheetShapes=true;
 		}
 		return true;
@@ -275,8 +347,8 @@ public:
 		}
 		getCurrentStorage()->push_back(object);
 		mAuxiliarOdcState->mContentElements.appendTo(*getCurrentStorage());
-		mAuxiliarOdcState->mContentElements.resize(0);
-		getCurrentStorage()->push_back(new TagCloseElement("draw:object"));
+		mAuxiliarOdcState->mContentElements.clear();
+		getCurrentStorage()->push_back(TagCloseElement("draw:object"));
 		return true;
 	}
 	void resetAuxiliarOdcGenerator()
@@ -324,10 +396,10 @@ public:
 			ODFGEN_DEBUG_MSG(("OdsGeneratorPrivate::sendAuxiliarOdtGenerator: data seems bad\n"));
 			return false;
 		}
-		getCurrentStorage()->push_back(new TagOpenElement("draw:object"));
+		getCurrentStorage()->push_back(TagOpenElement("draw:object"));
 		mAuxiliarOdtState->mContentElements.appendTo(*getCurrentStorage());
-		mAuxiliarOdtState->mContentElements.resize(0);
-		getCurrentStorage()->push_back(new TagCloseElement("draw:object"));
+		mAuxiliarOdtState->mContentElements.clear();
+		getCurrentStorage()->push_back(TagCloseElement("draw:object"));
 		return true;
 	}
 	void resetAuxiliarOdtGenerator()
@@ -343,10 +415,41 @@ public:
 	}
 
 	bool writeTargetDocument(OdfDocumentHandler *pHandler, OdfStreamType streamType);
+	//! returns the document mime type
+	char const *getDocumentMimeType() const
+	{
+		return "application/vnd.oasis.opendocument.spreadsheet";
+	}
 	void _writeStyles(OdfDocumentHandler *pHandler);
 	void _writeAutomaticStyles(OdfDocumentHandler *pHandler, OdfStreamType streamType);
 	void initPageManager();
 
+	//
+	// sheet row and cell compression
+	//
+
+	//! closes the current cell: stores it as a pending cell if it can be repeated or sends it
+	void closeCurrentCell();
+	//! sends the pending cells with a table:number-columns-repeated attribute if needed
+	void flushPendingCells();
+	//! closes the current row: stores it as a pending row if it can be repeated or sends it
+	void closeCurrentRow();
+	//! sends the pending rows with a table:number-rows-repeated attribute if needed
+	void flushPendingRows();
+	//! sends numRows empty rows
+	void insertEmptyRows(SheetStyle &style, int numRows);
+	//! sends numCells empty cells in the current row
+	void insertEmptyCells(int numCells);
+	//! stores the current cell in the sheet index
+	void storeCurrentCell();
+	//! sends the cells stored in the sheet index, sorted and merged
+	void sendSheetIndex(SheetStyle &style);
+
+	//! the cell value types
+	enum CellValueType { V_Unknown=0, V_Float, V_Percentage, V_Currency, V_String, V_Boolean, V_Date, V_Time };
+	//! returns the value type corresponding to a librevenge:value-type
+	static CellValueType getCellValueType(char const *type);
+
 	std::stack<Command> mCommandStack;
 	std::stack<State> mStateStack;
 
@@ -360,6 +463,41 @@ public:
 
 	// page manager
 	PageSpan *mpCurrentPageSpan;
+	// a flag to know if the closed sheets must be moved in a temporary file
+	bool mbSheetSpilling;
+	// a flag to know if the rows and cells can be sent in any order
+	bool mbSheetRandomOrder;
+	// a flag to know if the cells of the current sheet are stored in mSheetIndex
+	bool mbInIndexedSheet;
+	// the cells of the current sheet when they can be sent in any order
+	SheetCellIndex mSheetIndex;
+	// the row of the cell being created in mSheetIndex
+	int miIndexRow;
+	// the column of the cell being created in mSheetIndex
+	int miIndexColumn;
+
+	// the content of the row being created
+	libodfgen::DocumentElementVector mRowStorage;
+	// the style name of the row being created
+	librevenge::RVNGString msRowStyleName;
+	// a flag to know if the row being created can be merged with the following rows
+	bool mbRowCanBeRepeated;
+	// the content of the last closed rows which are not sent
+	libodfgen::DocumentElementVector mPendingRowStorage;
+	// the style name of the last closed rows which are not sent
+	librevenge::RVNGString msPendingRowStyleName;
+	// the number of identical rows which are not sent
+	int miPendingRowRepeat;
+	// the content of the cell being created
+	libodfgen::DocumentElementVector mCellStorage;
+	// the opening tag of the cell being created
+	shared_ptr<TagOpenElement> mpCellOpenElement;
+	// a flag to know if the cell being created can be merged with the following cells
+	bool mbCellCanBeRepeated;
+	// the opening tag of the last closed cells which are not sent
+	shared_ptr<TagOpenElement> mpPendingCellOpenElement;
+	// the number of identical cells which are not sent
+	int miPendingCellRepeat;
 
 	//
 private:
@@ -373,10 +511,17 @@ OdsGeneratorPrivate::OdsGeneratorPrivate() : OdfGenerator(),
 	mStateStack(),
 	mAuxiliarOdcState(), mAuxiliarOdtState(),
 	mSheetManager(),
-	mpCurrentPageSpan(0)
+	mpCurrentPageSpan(0), mbSheetSpilling(false),
+	mbSheetRandomOrder(false), mbInIndexedSheet(false), mSheetIndex(), miIndexRow(0), miIndexColumn(0),
+	mRowStorage(), msRowStyleName(), mbRowCanBeRepeated(false),
+	mPendingRowStorage(), msPendingRowStyleName(), miPendingRowRepeat(0),
+	mCellStorage(), mpCellOpenElement(), mbCellCanBeRepeated(false),
+	mpPendingCellOpenElement(), miPendingCellRepeat(0)
 {
 	mStateStack.push(State());
 	initPageManager();
+	// the texts of the cells can be stored in the string pool
+	mCellStorage.setStringPool(&mStringPool);
 }
 
 OdsGeneratorPrivate::~OdsGeneratorPrivate()
@@ -388,6 +533,229 @@ OdsGeneratorPrivate::~OdsGeneratorPrivate()
 	mSheetManager.clean();
 }
 
+void OdsGeneratorPrivate::closeCurrentCell()
+{
+	if (!mpCellOpenElement)
+	{
+		ODFGEN_DEBUG_MSG(("OdsGeneratorPrivate::closeCurrentCell: can not find the cell\n"));
+		return;
+	}
+	if (mbInIndexedSheet)
+	{
+		storeCurrentCell();
+		return;
+	}
+	bool canBeRepeated=mbCellCanBeRepeated && mCellStorage.empty();
+	if (canBeRepeated && miPendingCellRepeat && mpPendingCellOpenElement &&
+	        mpPendingCellOpenElement->getAttributes()==mpCellOpenElement->getAttributes())
+	{
+		++miPendingCellRepeat;
+		mpCellOpenElement.reset();
+		return;
+	}
+	flushPendingCells();
+	if (canBeRepeated)
+	{
+		mpPendingCellOpenElement=mpCellOpenElement;
+		miPendingCellRepeat=1;
+	}
+	else
+	{
+		getCurrentStorage()->push_back(*mpCellOpenElement);
+		mCellStorage.appendTo(*getCurrentStorage());
+		mCellStorage.clear();
+		getCurrentStorage()->push_back(TagCloseElement("table:table-cell"));
+	}
+	mpCellOpenElement.reset();
+}
+
+void OdsGeneratorPrivate::flushPendingCells()
+{
+	if (!miPendingCellRepeat || !mpPendingCellOpenElement)
+		return;
+	if (miPendingCellRepeat>1)
+	{
+		libodfgen::NumberString numRepeated;
+		numRepeated.setInt(miPendingCellRepeat);
+		mpPendingCellOpenElement->addAttribute("table:number-columns-repeated", numRepeated.cstr());
+	}
+	getCurrentStorage()->push_back(*mpPendingCellOpenElement);
+	getCurrentStorage()->push_back(TagCloseElement("table:table-cell"));
+	mpPendingCellOpenElement.reset();
+	miPendingCellRepeat=0;
+}
+
+void OdsGeneratorPrivate::closeCurrentRow()
+{
+	if (mbRowCanBeRepeated && miPendingRowRepeat && msPendingRowStyleName==msRowStyleName &&
+	        mPendingRowStorage==mRowStorage)
+	{
+		++miPendingRowRepeat;
+		mRowStorage.clear();
+		return;
+	}
+	flushPendingRows();
+	if (mbRowCanBeRepeated)
+	{
+		mPendingRowStorage.swap(mRowStorage);
+		msPendingRowStyleName=msRowStyleName;
+		miPendingRowRepeat=1;
+	}
+	else
+	{
+		TagOpenElement sheetRowOpenElement("table:table-row");
+		sheetRowOpenElement.addAttribute("table:style-name", msRowStyleName);
+		getCurrentStorage()->push_back(sheetRowOpenElement);
+		mRowStorage.appendTo(*getCurrentStorage());
+		getCurrentStorage()->push_back(TagCloseElement("table:table-row"));
+	}
+	mRowStorage.clear();
+}
+
+void OdsGeneratorPrivate::flushPendingRows()
+{
+	if (!miPendingRowRepeat)
+		return;
+	TagOpenElement sheetRowOpenElement("table:table-row");
+	sheetRowOpenElement.addAttribute("table:style-name", msPendingRowStyleName);
+	if (miPendingRowRepeat>1)
+	{
+		libodfgen::NumberString numRepeated;
+		numRepeated.setInt(miPendingRowRepeat);
+		sheetRowOpenElement.addAttribute("table:number-rows-repeated", numRepeated.cstr());
+	}
+	getCurrentStorage()->push_back(sheetRowOpenElement);
+	mPendingRowStorage.appendTo(*getCurrentStorage());
+	mPendingRowStorage.clear();
+	getCurrentStorage()->push_back(TagCloseElement("table:table-row"));
+	miPendingRowRepeat=0;
+}
+
+void OdsGeneratorPrivate::insertEmptyRows(SheetStyle &style, int numRows)
+{
+	flushPendingRows();
+	librevenge::RVNGString sEmptyRowStyleName=style.addRow(librevenge::RVNGPropertyList());
+
+	TagOpenElement emptyRowOpenElement("table:table-row");
+	emptyRowOpenElement.addAttribute("table:style-name", sEmptyRowStyleName);
+	libodfgen::NumberString numEmpty;
+	numEmpty.setInt(numRows);
+	emptyRowOpenElement.addAttribute("table:number-rows-repeated", numEmpty.cstr());
+
+	getCurrentStorage()->push_back(emptyRowOpenElement);
+	getCurrentStorage()->push_back(TagOpenElement("table:table-cell"));
+	getCurrentStorage()->push_back(TagCloseElement("table:table-cell"));
+	getCurrentStorage()->push_back(TagCloseElement("table:table-row"));
+}
+
+void OdsGeneratorPrivate::storeCurrentCell()
+{
+	SheetCellIndex::Cell cell;
+	cell.miColumn=miIndexColumn;
+	cell.mpOpenElement=mpCellOpenElement;
+	cell.mbCanBeRepeated=mbCellCanBeRepeated;
+	if (!mCellStorage.empty())
+	{
+		cell.mpContent.reset(new libodfgen::DocumentElementVector);
+		cell.mpContent->swap(mCellStorage);
+	}
+	SheetCellIndex::Row &row=mSheetIndex.mRows[miIndexRow];
+	if (!mbRowCanBeRepeated)
+		row.mbCanBeRepeated=false;
+	row.insert(cell);
+	mpCellOpenElement.reset();
+}
+
+void OdsGeneratorPrivate::sendSheetIndex(SheetStyle &style)
+{
+	mbInIndexedSheet=false;
+	int lastRow=0;
+	std::map<int, SheetCellIndex::Row>::iterator rIt;
+	for (rIt=mSheetIndex.mRows.begin(); rIt!=mSheetIndex.mRows.end(); ++rIt)
+	{
+		if (rIt->first > lastRow)
+			insertEmptyRows(style, rIt->first-lastRow);
+		lastRow=rIt->first+1;
+		SheetCellIndex::Row &row=rIt->second;
+		msRowStyleName=row.msStyleName;
+		mbRowCanBeRepeated=row.mbCanBeRepeated;
+		pushStorage(&mRowStorage);
+		if (row.mCells.empty())
+		{
+			TagOpenElement sheetCellOpenElement("table:table-cell");
+			sheetCellOpenElement.addAttribute("table:number-columns-repeated","1");
+			getCurrentStorage()->push_back(sheetCellOpenElement);
+			getCurrentStorage()->push_back(TagCloseElement("table:table-cell"));
+		}
+		int lastColumn=0;
+		for (size_t c=0; c<row.mCells.size(); ++c)
+		{
+			SheetCellIndex::Cell &cell=row.mCells[c];
+			if (cell.miColumn > lastColumn)
+				insertEmptyCells(cell.miColumn-lastColumn);
+			lastColumn=cell.miColumn+1;
+			mpCellOpenElement=cell.mpOpenElement;
+			mbCellCanBeRepeated=cell.mbCanBeRepeated;
+			if (cell.mpContent)
+				mCellStorage.swap(*cell.mpContent);
+			closeCurrentCell();
+		}
+		flushPendingCells();
+		popStorage();
+		closeCurrentRow();
+		// the row content is not needed anymore
+		row.mCells.clear();
+	}
+	mSheetIndex.mRows.clear();
+	flushPendingRows();
+}
+
+OdsGeneratorPrivate::CellValueType OdsGeneratorPrivate::getCellValueType(char const *type)
+{
+	if (!type) return V_Unknown;
+	switch (type[0])
+	{
+	case 'b':
+		if (!strcmp(type, "boolean") || !strcmp(type, "bool")) return V_Boolean;
+		break;
+	case 'c':
+		if (!strcmp(type, "currency")) return V_Currency;
+		break;
+	case 'd':
+		if (!strcmp(type, "double")) return V_Float;
+		if (!strcmp(type, "date")) return V_Date;
+		break;
+	case 'f':
+		if (!strcmp(type, "float")) return V_Float;
+		break;
+	case 'p':
+		if (!strcmp(type, "percentage") || !strcmp(type, "percent")) return V_Percentage;
+		break;
+	case 's':
+		if (!strcmp(type, "string")) return V_String;
+		if (!strcmp(type, "scientific")) return V_Float;
+		break;
+	case 't':
+		if (!strcmp(type, "text")) return V_String;
+		if (!strcmp(type, "time")) return V_Time;
+		break;
+	default:
+		break;
+	}
+	return V_Unknown;
+}
+
+void OdsGeneratorPrivate::insertEmptyCells(int numCells)
+{
+	flushPendingCells();
+	TagOpenElement emptyElement("table:table-cell");
+	libodfgen::NumberString numEmpty;
+	numEmpty.setInt(numCells);
+	emptyElement.addAttribute("table:number-columns-repeated", numEmpty.cstr());
+	getCurrentStorage()->push_back(emptyElement);
+	getCurrentStorage()->push_back(TagCloseElement("table:table-cell"));
+}
+
 bool OdsGeneratorPrivate::close(Command command)
 {
 	if (mCommandStack.empty() || mCommandStack.top()!=command)
@@ -474,6 +842,97 @@ bool OdsGenerator::getObjectContent(librevenge::RVNGString const &objectName, Od
 	return mpImpl->getObjectContent(objectName, pHandler);
 }
 
+void OdsGenerator::setContentStreaming(bool stream)
+{
+	if (mpImpl)
+		mpImpl->setContentStreaming(stream);
+}
+
+void OdsGenerator::setPackageWriter(OdfPackageWriter *pWriter)
+{
+	if (mpImpl)
+		mpImpl->setPackageWriter(pWriter);
+}
+
+void OdsGenerator::setParallelWriting(bool parallel)
+{
+	if (mpImpl)
+		mpImpl->setParallelWriting(parallel);
+}
+
+void OdsGenerator::setExternalPictures(bool external)
+{
+	if (mpImpl)
+		mpImpl->setExternalPictures(external);
+}
+
+void OdsGenerator::setAsynchronousImageConversion(bool async)
+{
+	if (mpImpl)
+		mpImpl->setAsynchronousImageConversion(async);
+}
+
+void OdsGenerator::setEmbeddedObjectCacheSize(unsigned size)
+{
+	if (mpImpl)
+		mpImpl->setEmbeddedObjectCacheSize(size);
+}
+
+void OdsGenerator::getEmbeddedObjectCacheStatistics(unsigned long &hits, unsigned long &misses) const
+{
+	hits=misses=0;
+	if (mpImpl)
+		mpImpl->getEmbeddedObjectCacheStatistics(hits, misses);
+}
+
+void OdsGenerator::getStyleCacheStatistics(unsigned long &hits, unsigned long &misses) const
+{
+	hits=misses=0;
+	if (mpImpl)
+	{
+		mpImpl->getStyleCacheStatistics(hits, misses);
+		mpImpl->mSheetManager.addCacheStatistics(hits, misses);
+	}
+}
+
+librevenge::RVNGStringVector OdsGenerator::getPictureNames() const
+{
+	if (mpImpl)
+		return mpImpl->getPictureNames();
+	return librevenge::RVNGStringVector();
+}
+
+bool OdsGenerator::getPictureContent(librevenge::RVNGString const &name, librevenge::RVNGBinaryData &data, librevenge::RVNGString &mimeType) const
+{
+	if (!mpImpl)
+		return false;
+	return mpImpl->getPictureContent(name, data, mimeType);
+}
+
+void OdsGenerator::setSheetSpilling(bool spill)
+{
+	if (mpImpl)
+		mpImpl->mbSheetSpilling=spill;
+}
+
+void OdsGenerator::setSheetRandomOrder(bool randomOrder)
+{
+	if (mpImpl)
+		mpImpl->mbSheetRandomOrder=randomOrder;
+}
+
+void OdsGenerator::setTextInterning(unsigned minLength)
+{
+	if (mpImpl)
+		mpImpl->getStringPool().setMinLength(minLength);
+}
+
+void OdsGenerator::setSheetStyleSharing(bool share)
+{
+	if (mpImpl)
+		mpImpl->mSheetManager.setShareStyles(share);
+}
+
 void OdsGeneratorPrivate::_writeAutomaticStyles(OdfDocumentHandler *pHandler, OdfStreamType streamType)
 {
 	TagOpenElement("office:automatic-styles").write(pHandler);
@@ -630,11 +1089,11 @@ bool OdsGeneratorPrivate::writeTargetDocument(OdfDocumentHandler *pHandler, OdfS
 		pHandler->startDocument();
 		TagOpenElement manifestElement("manifest:manifest");
 		manifestElement.addAttribute("xmlns:manifest", "urn:oasis:names:tc:opendocument:xmlns:manifest:1.0");
-		manifestElement.addAttribute("manifest:version", "1.2", true);
+		manifestElement.addAttribute("manifest:version", "1.2");
 		manifestElement.write(pHandler);
 
 		TagOpenElement mainFile("manifest:file-entry");
-		mainFile.addAttribute("manifest:media-type", "application/vnd.oasis.opendocument.spreadsheet");
+		mainFile.addAttribute("manifest:media-type", getDocumentMimeType());
 		mainFile.addAttribute("manifest:full-path", "/");
 		mainFile.write(pHandler);
 		TagCloseElement("manifest:file-entry").write(pHandler);
@@ -677,7 +1136,7 @@ bool OdsGeneratorPrivate::writeTargetDocument(OdfDocumentHandler *pHandler, OdfS
 	docContentPropList.insert("xmlns:calcext","urn:org:documentfoundation:names:experimental:calc:xmlns:calcext:1.0");
 	docContentPropList.insert("office:version", librevenge::RVNGPropertyFactory::newStringProp("1.2"));
 	if (streamType == ODF_FLAT_XML)
-		docContentPropList.insert("office:mimetype", "application/vnd.oasis.opendocument.spreadsheet");
+		docContentPropList.insert("office:mimetype", getDocumentMimeType());
 	pHandler->startElement(documentType.c_str(), docContentPropList);
 
 	if (streamType == ODF_FLAT_XML || streamType == ODF_META_XML)
@@ -783,31 +1242,32 @@ void OdsGenerator::openSheet(const librevenge::RVNGPropertyList &propList)
 
 	if (!mpImpl->mSheetManager.openSheet(finalPropList, Style::Z_ContentAutomatic)) return;
 	mpImpl->getState().mbInSheet=true;
+	mpImpl->mbInIndexedSheet=mpImpl->mbSheetRandomOrder;
 
 	SheetStyle *style=mpImpl->mSheetManager.actualSheet();
 	if (!style) return;
 	librevenge::RVNGString sTableName(style->getName());
-	TagOpenElement *pTableOpenElement = new TagOpenElement("table:table");
+	TagOpenElement tableOpenElement("table:table");
 	if (propList["librevenge:sheet-name"])
-		pTableOpenElement->addAttribute("table:name", propList["librevenge:sheet-name"]->getStr());
+		tableOpenElement.addAttribute("table:name", propList["librevenge:sheet-name"]->getStr());
 	else
-		pTableOpenElement->addAttribute("table:name", sTableName.cstr());
-	pTableOpenElement->addAttribute("table:style-name", sTableName.cstr());
-	mpImpl->getCurrentStorage()->push_back(pTableOpenElement);
+		tableOpenElement.addAttribute("table:name", sTableName.cstr());
+	tableOpenElement.addAttribute("table:style-name", sTableName.cstr());
+	mpImpl->getCurrentStorage()->push_back(tableOpenElement);
 
 	/* TODO: open a table:shapes element
 	   a environment to store the table content which must be merged in closeSheet
 	*/
 	for (int i=0; i< style->getNumColumns(); ++i)
 	{
-		TagOpenElement *pTableColumnOpenElement = new TagOpenElement("table:table-column");
+		TagOpenElement tableColumnOpenElement("table:table-column");
 		librevenge::RVNGString sColumnStyleName;
 		sColumnStyleName.sprintf("%s_col%i", sTableName.cstr(), (i+1));
-		pTableColumnOpenElement->addAttribute("table:style-name", sColumnStyleName.cstr());
-		mpImpl->getCurrentStorage()->push_back(pTableColumnOpenElement);
+		tableColumnOpenElement.addAttribute("table:style-name", sColumnStyleName.cstr());
+		mpImpl->getCurrentStorage()->push_back(tableColumnOpenElement);
 
-		TagCloseElement *pTableColumnCloseElement = new TagCloseElement("table:table-column");
-		mpImpl->getCurrentStorage()->push_back(pTableColumnCloseElement);
+		TagCloseElement tableColumnCloseElement("table:table-column");
+		mpImpl->getCurrentStorage()->push_back(tableColumnCloseElement);
 	}
 }
 
@@ -818,13 +1278,29 @@ void OdsGenerator::closeSheet()
 	OdsGeneratorPrivate::State state=mpImpl->getState();
 	mpImpl->popState();
 	if (mpImpl->mAuxiliarOdcState || mpImpl->mAuxiliarOdtState || !state.mbInSheet) return;
+	if (mpImpl->mbInIndexedSheet)
+	{
+		if (state.mbInSheetShapes)
+		{
+			mpImpl->getCurrentStorage()->push_back(TagCloseElement("table:shapes"));
+			state.mbInSheetShapes=false;
+		}
+		SheetStyle *style=mpImpl->mSheetManager.actualSheet();
+		if (style)
+			mpImpl->sendSheetIndex(*style);
+		mpImpl->mbInIndexedSheet=false;
+	}
+	mpImpl->flushPendingRows();
 	if (state.mbInSheetShapes)
 	{
-		mpImpl->getCurrentStorage()->push_back(new TagCloseElement("table:shapes"));
+		mpImpl->getCurrentStorage()->push_back(TagCloseElement("table:shapes"));
 		mpImpl->getState().mbInSheetShapes=false;
 	}
 	mpImpl->mSheetManager.closeSheet();
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("table:table"));
+	mpImpl->getCurrentStorage()->push_back(TagCloseElement("table:table"));
+	// the sheet content does not change anymore
+	if (mpImpl->mbSheetSpilling && mpImpl->getCurrentStorage()==&mpImpl->getBodyStorage())
+		mpImpl->getBodyStorage().spill();
 }
 
 void OdsGenerator::openSheetRow(const librevenge::RVNGPropertyList &propList)
@@ -834,46 +1310,40 @@ void OdsGenerator::openSheetRow(const librevenge::RVNGPropertyList &propList)
 	OdsGeneratorPrivate::State state=mpImpl->getState();
 	SheetStyle *style=mpImpl->mSheetManager.actualSheet();
 
-	if (!state.mbInSheet || state.mbInComment || !style)
+	if (!state.mbInSheet || state.mbInSheetRow || state.mbInComment || !style)
 	{
 		ODFGEN_DEBUG_MSG(("OdsGenerator::openSheetRow can not be called!!!\n"));
 		return;
 	}
 	if (state.mbInSheetShapes)
 	{
-		mpImpl->getCurrentStorage()->push_back(new TagCloseElement("table:shapes"));
+		mpImpl->getCurrentStorage()->push_back(TagCloseElement("table:shapes"));
 		mpImpl->getState().mbInSheetShapes=false;
 	}
 
-	// check if we need to add some empty row
+	// check if we need to add some empty row, an indexed sheet accepts the rows in any order
 	int row = propList["librevenge:row"] ? propList["librevenge:row"]->getInt() : -1;
-	if (row > state.miLastSheetRow)
-	{
-		librevenge::RVNGString sEmptyRowStyleName=style->addRow(librevenge::RVNGPropertyList());
-
-		TagOpenElement *pEmptyRowOpenElement = new TagOpenElement("table:table-row");
-		pEmptyRowOpenElement->addAttribute("table:style-name", sEmptyRowStyleName);
-		librevenge::RVNGString numEmpty;
-		numEmpty.sprintf("%d", row-state.miLastSheetRow);
-		pEmptyRowOpenElement->addAttribute("table:number-rows-repeated", numEmpty);
-
-		mpImpl->getCurrentStorage()->push_back(pEmptyRowOpenElement);
-		mpImpl->getCurrentStorage()->push_back(new TagOpenElement("table:table-cell"));
-		mpImpl->getCurrentStorage()->push_back(new TagCloseElement("table:table-cell"));
-		mpImpl->getCurrentStorage()->push_back(new TagCloseElement("table:table-row"));
-	}
-	else
+	if (row < 0 || (row < state.miLastSheetRow && !mpImpl->mbInIndexedSheet))
 		row=state.miLastSheetRow;
+	else if (row > state.miLastSheetRow && !mpImpl->mbInIndexedSheet)
+		mpImpl->insertEmptyRows(*style, row-state.miLastSheetRow);
 	mpImpl->getState().miLastSheetRow=row+1;
 
+	state.miLastSheetRow=row+1;
 	state.miLastSheetColumn=0;
 	state.mbInSheetRow=state.mbFirstInSheetRow=true;
 	mpImpl->pushState(state);
 
-	librevenge::RVNGString sSheetRowStyleName=style->addRow(propList);
-	TagOpenElement *pSheetRowOpenElement = new TagOpenElement("table:table-row");
-	pSheetRowOpenElement->addAttribute("table:style-name", sSheetRowStyleName);
-	mpImpl->getCurrentStorage()->push_back(pSheetRowOpenElement);
+	// the row is sent in closeSheetRow, so that it can be merged with the identical following rows
+	mpImpl->msRowStyleName=style->addRow(propList);
+	mpImpl->mbRowCanBeRepeated=true;
+	mpImpl->pushStorage(&mpImpl->mRowStorage);
+	if (mpImpl->mbInIndexedSheet)
+	{
+		// the row is sent in closeSheet
+		mpImpl->miIndexRow=row;
+		mpImpl->mSheetIndex.mRows[row].msStyleName=mpImpl->msRowStyleName;
+	}
 }
 
 void OdsGenerator::closeSheetRow()
@@ -881,15 +1351,24 @@ void OdsGenerator::closeSheetRow()
 	if (!mpImpl->close(OdsGeneratorPrivate::C_SheetRow) || mpImpl->mAuxiliarOdcState || mpImpl->mAuxiliarOdtState) return;
 	OdsGeneratorPrivate::State state=mpImpl->getState();
 	if (!state.mbInSheetRow) return;
+	if (mpImpl->mbInIndexedSheet)
+	{
+		mpImpl->popState();
+		mpImpl->popStorage();
+		mpImpl->mRowStorage.clear();
+		return;
+	}
 	if (state.mbFirstInSheetRow)
 	{
-		TagOpenElement *pSheetCellOpenElement = new TagOpenElement("table:table-cell");
-		pSheetCellOpenElement->addAttribute("table:number-columns-repeated","1");
-		mpImpl->getCurrentStorage()->push_back(pSheetCellOpenElement);
-		mpImpl->getCurrentStorage()->push_back(new TagCloseElement("table:table-cell"));
+		TagOpenElement sheetCellOpenElement("table:table-cell");
+		sheetCellOpenElement.addAttribute("table:number-columns-repeated","1");
+		mpImpl->getCurrentStorage()->push_back(sheetCellOpenElement);
+		mpImpl->getCurrentStorage()->push_back(TagCloseElement("table:table-cell"));
 	}
+	mpImpl->flushPendingCells();
 	mpImpl->popState();
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("table:table-row"));
+	mpImpl->popStorage();
+	mpImpl->closeCurrentRow();
 }
 
 void OdsGenerator::openSheetCell(const librevenge::RVNGPropertyList &propList)
@@ -899,26 +1378,20 @@ void OdsGenerator::openSheetCell(const librevenge::RVNGPropertyList &propList)
 	OdsGeneratorPrivate::State state=mpImpl->getState();
 	SheetStyle *style=mpImpl->mSheetManager.actualSheet();
 
-	if (!state.mbInSheetRow || state.mbInComment || !style)
+	if (!state.mbInSheetRow || state.mbInSheetCell || state.mbInComment || !style)
 	{
 		ODFGEN_DEBUG_MSG(("OdsGenerator::openSheetCell can not be called!!!\n"));
 		return;
 	}
 	mpImpl->getState().mbFirstInSheetRow=false;
-	// check if we need to add empty column
+	// check if we need to add empty column, an indexed sheet accepts the cells in any order
 	int col = propList["librevenge:column"] ? propList["librevenge:column"]->getInt() : -1;
-	if (col > state.miLastSheetColumn)
-	{
-		TagOpenElement *pEmptyElement = new TagOpenElement("table:table-cell");
-		librevenge::RVNGString numEmpty;
-		numEmpty.sprintf("%d", col-state.miLastSheetColumn);
-		pEmptyElement->addAttribute("table:number-columns-repeated", numEmpty);
-		mpImpl->getCurrentStorage()->push_back(pEmptyElement);
-		mpImpl->getCurrentStorage()->push_back(new TagCloseElement("table:table-cell"));
-	}
-	else
+	if (col < 0 || (col < state.miLastSheetColumn && !mpImpl->mbInIndexedSheet))
 		col=state.miLastSheetColumn;
+	else if (col > state.miLastSheetColumn && !mpImpl->mbInIndexedSheet)
+		mpImpl->insertEmptyCells(col-state.miLastSheetColumn);
 	mpImpl->getState().miLastSheetColumn=col+1;
+	mpImpl->miIndexColumn=col;
 
 	state.mbInSheetCell=true;
 	mpImpl->pushState(state);
@@ -927,93 +1400,107 @@ void OdsGenerator::openSheetCell(const librevenge::RVNGPropertyList &propList)
 		mpImpl->getFontManager().findOrAdd(propList["style:font-name"]->getStr().cstr());
 	librevenge::RVNGString sSheetCellStyleName=style->addCell(propList);
 
-	TagOpenElement *pSheetCellOpenElement = new TagOpenElement("table:table-cell");
-	pSheetCellOpenElement->addAttribute("table:style-name", sSheetCellStyleName);
+	// the cell is sent in closeSheetCell, so that it can be merged with the identical following cells
+	mpImpl->mpCellOpenElement.reset(new TagOpenElement("table:table-cell"));
+	mpImpl->mbCellCanBeRepeated=true;
+	TagOpenElement &sheetCellOpenElement=*mpImpl->mpCellOpenElement;
+	sheetCellOpenElement.addAttribute("table:style-name", sSheetCellStyleName);
 
 	if (propList["librevenge:value-type"])
 	{
-		std::string valueType(propList["librevenge:value-type"]->getStr().cstr());
-		if (valueType=="double" || valueType=="scientific") valueType="float";
-		else if (valueType=="percent") valueType="percentage";
-		if (valueType=="float" || valueType=="percentage" || valueType=="currency")
+		librevenge::RVNGString const valueTypeStr=propList["librevenge:value-type"]->getStr();
+		OdsGeneratorPrivate::CellValueType const valueType=OdsGeneratorPrivate::getCellValueType(valueTypeStr.cstr());
+		switch (valueType)
 		{
-			pSheetCellOpenElement->addAttribute("calcext:value-type", valueType.c_str());
-			pSheetCellOpenElement->addAttribute("office:value-type", valueType.c_str());
-			if (propList["librevenge:value"])
+		case OdsGeneratorPrivate::V_Float:
+		case OdsGeneratorPrivate::V_Percentage:
+		case OdsGeneratorPrivate::V_Currency:
+		{
+			char const *typeName=valueType==OdsGeneratorPrivate::V_Float ? "float" :
+			                     valueType==OdsGeneratorPrivate::V_Percentage ? "percentage" : "currency";
+			sheetCellOpenElement.addAttribute("calcext:value-type", typeName);
+			sheetCellOpenElement.addAttribute("office:value-type", typeName);
+			if (!propList["librevenge:value"])
+				break;
+			/* the value is usually a double property, but a string property
+			   returns 0 in getDouble, so its text is read: "12.5" or "nan" */
+			librevenge::RVNGProperty const *valueProp=propList["librevenge:value"];
+			double value=valueProp->getDouble();
+			if (value==0 && !libodfgen::readDouble(valueProp->getStr().cstr(), value))
 			{
-				if (!strncmp(propList["librevenge:value"]->getStr().cstr(),"nan",3) ||
-				        !strncmp(propList["librevenge:value"]->getStr().cstr(),"NAN",3))
-				{
-					pSheetCellOpenElement->addAttribute("office:string-value", "");
-					pSheetCellOpenElement->addAttribute("office:value-type", "string");
-					pSheetCellOpenElement->addAttribute("calcext:value-type", "error");
-				}
-				else
-				{
-					pSheetCellOpenElement->addAttribute("office:value-type", valueType.c_str());
-					pSheetCellOpenElement->addAttribute("office:value", propList["librevenge:value"]->getStr().cstr());
-				}
+				ODFGEN_DEBUG_MSG(("OdsGenerator::openSheetCell: can not read the value %s\n", valueProp->getStr().cstr()));
+				sheetCellOpenElement.addAttribute("office:value", valueProp->getStr());
 			}
+			else if (value!=value)
+			{
+				sheetCellOpenElement.addAttribute("office:string-value", "");
+				sheetCellOpenElement.addAttribute("office:value-type", "string");
+				sheetCellOpenElement.addAttribute("calcext:value-type", "error");
+			}
+			else
+				sheetCellOpenElement.addAttribute("office:value", libodfgen::NumberString().setRoundTripDouble(value).cstr());
+			break;
 		}
-		else if (valueType=="string" || valueType=="text")
-		{
-			pSheetCellOpenElement->addAttribute("office:value-type", "string");
-			pSheetCellOpenElement->addAttribute("calcext:value-type", "string");
-		}
-		else if (valueType=="bool" || valueType=="boolean")
-		{
-			pSheetCellOpenElement->addAttribute("office:value-type", "boolean");
-			pSheetCellOpenElement->addAttribute("calcext:value-type", "boolean");
+		case OdsGeneratorPrivate::V_String:
+			sheetCellOpenElement.addAttribute("office:value-type", "string");
+			sheetCellOpenElement.addAttribute("calcext:value-type", "string");
+			break;
+		case OdsGeneratorPrivate::V_Boolean:
+			sheetCellOpenElement.addAttribute("office:value-type", "boolean");
+			sheetCellOpenElement.addAttribute("calcext:value-type", "boolean");
 			if (propList["librevenge:value"])
-				pSheetCellOpenElement->addAttribute("office:boolean-value", propList["librevenge:value"]->getStr().cstr());
-		}
-		else if (valueType=="date")
-		{
-			pSheetCellOpenElement->addAttribute("office:value-type", "date");
-			pSheetCellOpenElement->addAttribute("calcext:value-type", "date");
+				sheetCellOpenElement.addAttribute("office:boolean-value", propList["librevenge:value"]->getStr().cstr());
+			break;
+		case OdsGeneratorPrivate::V_Date:
+			sheetCellOpenElement.addAttribute("office:value-type", "date");
+			sheetCellOpenElement.addAttribute("calcext:value-type", "date");
 			if (propList["librevenge:day"] && propList["librevenge:month"] && propList["librevenge:year"])
 			{
-				librevenge::RVNGString date;
+				libodfgen::NumberString date;
+				date.setInt(propList["librevenge:year"]->getInt(), 4).append('-')
+				.appendInt(propList["librevenge:month"]->getInt(), 2).append('-')
+				.appendInt(propList["librevenge:day"]->getInt(), 2);
 				if (propList["librevenge:hours"])
 				{
 					int minute=propList["librevenge:minutes"] ? propList["librevenge:minutes"]->getInt() : 0;
 					int second=propList["librevenge:seconds"] ? propList["librevenge:seconds"]->getInt() : 0;
-					date.sprintf("%04d-%02d-%02dT%02d:%02d:%02d", propList["librevenge:year"]->getInt(),
-					             propList["librevenge:month"]->getInt(),  propList["librevenge:day"]->getInt(),
-					             propList["librevenge:hours"]->getInt(), minute, second);
+					date.append('T').appendInt(propList["librevenge:hours"]->getInt(), 2).append(':')
+					.appendInt(minute, 2).append(':').appendInt(second, 2);
 				}
-				else
-					date.sprintf("%04d-%02d-%02d", propList["librevenge:year"]->getInt(),
-					             propList["librevenge:month"]->getInt(),  propList["librevenge:day"]->getInt());
-				pSheetCellOpenElement->addAttribute("office:date-value", date);
+				sheetCellOpenElement.addAttribute("office:date-value", date.cstr());
 			}
-		}
-		else if (valueType=="time")
-		{
-			pSheetCellOpenElement->addAttribute("office:value-type", "time");
-			pSheetCellOpenElement->addAttribute("calcext:value-type", "time");
+			break;
+		case OdsGeneratorPrivate::V_Time:
+			sheetCellOpenElement.addAttribute("office:value-type", "time");
+			sheetCellOpenElement.addAttribute("calcext:value-type", "time");
 			if (propList["librevenge:hours"])
 			{
 				int minute=propList["librevenge:minutes"] ? propList["librevenge:minutes"]->getInt() : 0;
 				int second=propList["librevenge:seconds"] ? propList["librevenge:seconds"]->getInt() : 0;
-				librevenge::RVNGString time;
-				time.sprintf("PT%02dH%02dM%02dS", propList["librevenge:hours"]->getInt(), minute, second);
-				pSheetCellOpenElement->addAttribute("office:time-value", time);
+				libodfgen::NumberString time;
+				time.append("PT").appendInt(propList["librevenge:hours"]->getInt(), 2).append('H')
+				.appendInt(minute, 2).append('M').appendInt(second, 2).append('S');
+				sheetCellOpenElement.addAttribute("office:time-value", time.cstr());
 			}
-		}
-		else
-		{
-			ODFGEN_DEBUG_MSG(("OdsGenerator::openSheetCell: unexpected value type: %s\n", valueType.c_str()));
+			break;
+		case OdsGeneratorPrivate::V_Unknown:
+		default:
+			ODFGEN_DEBUG_MSG(("OdsGenerator::openSheetCell: unexpected value type: %s\n", valueTypeStr.cstr()));
+			break;
 		}
 	}
 	librevenge::RVNGPropertyListVector const *formula=propList.child("librevenge:formula");
 	if (formula)
 	{
-		librevenge::RVNGString finalFormula=SheetManager::convertFormula(*formula);
+		librevenge::RVNGString finalFormula=mpImpl->mSheetManager.convertFormula(*formula, col, state.miLastSheetRow-1);
 		if (!finalFormula.empty())
-			pSheetCellOpenElement->addAttribute("table:formula", finalFormula);
+		{
+			sheetCellOpenElement.addEscapedAttribute("table:formula", finalFormula);
+			// the references in a repeated formula would be moved by the readers
+			mpImpl->mbCellCanBeRepeated=mpImpl->mbRowCanBeRepeated=false;
+		}
 	}
-	mpImpl->getCurrentStorage()->push_back(pSheetCellOpenElement);
+	mpImpl->pushStorage(&mpImpl->mCellStorage);
 }
 
 void OdsGenerator::closeSheetCell()
@@ -1022,7 +1509,127 @@ void OdsGenerator::closeSheetCell()
 	if (!mpImpl->getState().mbInSheetCell) return;
 
 	mpImpl->popState();
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("table:table-cell"));
+	mpImpl->popStorage();
+	mpImpl->closeCurrentCell();
+}
+
+void OdsGenerator::insertSheetCellBlock(const librevenge::RVNGPropertyList &rowPropList,
+                                        const librevenge::RVNGPropertyList &cellPropList, const OdsCellBlock &block)
+{
+	if (mpImpl->mAuxiliarOdcState || mpImpl->mAuxiliarOdtState) return;
+	OdsGeneratorPrivate::State &state=mpImpl->getState();
+	SheetStyle *style=mpImpl->mSheetManager.actualSheet();
+
+	if (!state.mbInSheet || state.mbInSheetRow || state.mbInComment || !style)
+	{
+		ODFGEN_DEBUG_MSG(("OdsGenerator::insertSheetCellBlock can not be called!!!\n"));
+		return;
+	}
+	int const numRows=int(block.getNumRows());
+	unsigned const numColumns=block.getNumColumns();
+	if (numRows<=0) return;
+	if (state.mbInSheetShapes)
+	{
+		mpImpl->getCurrentStorage()->push_back(TagCloseElement("table:shapes"));
+		state.mbInSheetShapes=false;
+	}
+
+	// check if we need to add some empty row, an indexed sheet accepts the rows in any order
+	bool const indexed=mpImpl->mbInIndexedSheet;
+	int row = rowPropList["librevenge:row"] ? rowPropList["librevenge:row"]->getInt() : -1;
+	if (row < 0 || (row < state.miLastSheetRow && !indexed))
+		row=state.miLastSheetRow;
+	else if (row > state.miLastSheetRow && !indexed)
+		mpImpl->insertEmptyRows(*style, row-state.miLastSheetRow);
+	state.miLastSheetRow=row+numRows;
+	int col = cellPropList["librevenge:column"] ? cellPropList["librevenge:column"]->getInt() : 0;
+
+	// the styles are the same for all the rows and all the cells
+	librevenge::RVNGString const sSheetRowStyleName=style->addRow(rowPropList);
+	if (cellPropList["style:font-name"])
+		mpImpl->getFontManager().findOrAdd(cellPropList["style:font-name"]->getStr().cstr());
+	TagOpenElement emptyCellOpenElement("table:table-cell");
+	emptyCellOpenElement.addAttribute("table:style-name", style->addCell(cellPropList));
+
+	for (int r=0; r<numRows; ++r)
+	{
+		mpImpl->msRowStyleName=sSheetRowStyleName;
+		mpImpl->mbRowCanBeRepeated=true;
+		mpImpl->pushStorage(&mpImpl->mRowStorage);
+		if (indexed)
+		{
+			mpImpl->miIndexRow=row+r;
+			mpImpl->mSheetIndex.mRows[row+r].msStyleName=sSheetRowStyleName;
+		}
+		else if (!numColumns)
+		{
+			TagOpenElement sheetCellOpenElement("table:table-cell");
+			sheetCellOpenElement.addAttribute("table:number-columns-repeated","1");
+			mpImpl->getCurrentStorage()->push_back(sheetCellOpenElement);
+			mpImpl->getCurrentStorage()->push_back(TagCloseElement("table:table-cell"));
+		}
+		else if (col > 0)
+			mpImpl->insertEmptyCells(col);
+		for (unsigned c=0; c<numColumns; ++c)
+		{
+			mpImpl->mpCellOpenElement.reset(new TagOpenElement(emptyCellOpenElement));
+			mpImpl->mbCellCanBeRepeated=true;
+			TagOpenElement &sheetCellOpenElement=*mpImpl->mpCellOpenElement;
+			switch (block.getColumnType(c))
+			{
+			case OdsCellBlock::Float:
+			{
+				double const value=block.getFloatValues(c)[r];
+				if (value>=value) // false if value is NaN
+				{
+					sheetCellOpenElement.addAttribute("calcext:value-type", "float");
+					sheetCellOpenElement.addAttribute("office:value-type", "float");
+					sheetCellOpenElement.addAttribute("office:value", libodfgen::NumberString().setRoundTripDouble(value).cstr());
+				}
+				break;
+			}
+			case OdsCellBlock::String:
+			{
+				char const *value=block.getStringValues(c)[r];
+				if (!value) break;
+				sheetCellOpenElement.addAttribute("office:value-type", "string");
+				sheetCellOpenElement.addAttribute("calcext:value-type", "string");
+				mpImpl->mCellStorage.push_back(TagOpenElement("text:p"));
+				mpImpl->mCellStorage.push_back(TextElement(value));
+				mpImpl->mCellStorage.push_back(TagCloseElement("text:p"));
+				break;
+			}
+			case OdsCellBlock::Boolean:
+				sheetCellOpenElement.addAttribute("office:value-type", "boolean");
+				sheetCellOpenElement.addAttribute("calcext:value-type", "boolean");
+				sheetCellOpenElement.addAttribute("office:boolean-value", block.getBooleanValues(c)[r] ? "true" : "false");
+				break;
+			case OdsCellBlock::Date:
+			{
+				char const *value=block.getStringValues(c)[r];
+				if (!value) break;
+				sheetCellOpenElement.addAttribute("office:value-type", "date");
+				sheetCellOpenElement.addAttribute("calcext:value-type", "date");
+				sheetCellOpenElement.addAttribute("office:date-value", value);
+				break;
+			}
+			case OdsCellBlock::Empty:
+			default:
+				break;
+			}
+			mpImpl->miIndexColumn=col+int(c);
+			mpImpl->closeCurrentCell();
+		}
+		if (indexed)
+		{
+			mpImpl->popStorage();
+			mpImpl->mRowStorage.clear();
+			continue;
+		}
+		mpImpl->flushPendingCells();
+		mpImpl->popStorage();
+		mpImpl->closeCurrentRow();
+	}
 }
 
 void OdsGenerator::defineChartStyle(const librevenge::RVNGPropertyList &propList)
@@ -1461,7 +2068,7 @@ void OdsGenerator::openComment(const librevenge::RVNGPropertyList &propList)
 
 	mpImpl->getState().mbInComment=true;
 	mpImpl->pushListState();
-	mpImpl->getCurrentStorage()->push_back(new TagOpenElement("office:annotation"));
+	mpImpl->getCurrentStorage()->push_back(TagOpenElement("office:annotation"));
 }
 
 void OdsGenerator::closeComment()
@@ -1475,7 +2082,7 @@ void OdsGenerator::closeComment()
 
 	if (mpImpl->mAuxiliarOdcState || !state.mbInComment) return;
 	mpImpl->popListState();
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("office:annotation"));
+	mpImpl->getCurrentStorage()->push_back(TagCloseElement("office:annotation"));
 }
 
 void OdsGenerator::openTable(const librevenge::RVNGPropertyList &propList)
@@ -1629,7 +2236,7 @@ void OdsGenerator::openFrame(const librevenge::RVNGPropertyList &propList)
 
 	if (!state.mbInSheetRow && !state.mbInSheetShapes)
 	{
-		mpImpl->getCurrentStorage()->push_back(new TagOpenElement("table:shapes"));
+		mpImpl->getCurrentStorage()->push_back(TagOpenElement("table:shapes"));
 		mpImpl->getState().mbInSheetShapes=prevState.mbInSheetShapes=true;
 	}
 
@@ -1711,7 +2318,7 @@ void OdsGenerator::closeTextBox()
 		return mpImpl->mAuxiliarOdtState->get().closeTextBox();
 	if (mpImpl->mAuxiliarOdcState || !state.mbInTextBox)
 		return;
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("draw:text-box"));
+	mpImpl->getCurrentStorage()->push_back(TagCloseElement("draw:text-box"));
 }
 
 void OdsGenerator::startDocument(const librevenge::RVNGPropertyList &)
@@ -1723,6 +2330,7 @@ void OdsGenerator::startDocument(const librevenge::RVNGPropertyList &)
 	}
 	mpImpl->getState().mbStarted=true;
 	mpImpl->open(OdsGeneratorPrivate::C_Document);
+	mpImpl->startContentStreaming();
 }
 
 void OdsGenerator::endDocument()
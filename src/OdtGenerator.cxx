@@ -51,6 +51,11 @@ public:
 	~OdtGeneratorPrivate();
 
 	bool writeTargetDocument(OdfDocumentHandler *pHandler, OdfStreamType streamType);
+	//! returns the document mime type
+	char const *getDocumentMimeType() const
+	{
+		return "application/vnd.oasis.opendocument.text";
+	}
 	void _writeStyles(OdfDocumentHandler *pHandler);
 	void _writeAutomaticStyles(OdfDocumentHandler *pHandler, OdfStreamType streamType);
 
@@ -356,7 +361,7 @@ bool OdtGeneratorPrivate::writeTargetDocument(OdfDocumentHandler *pHandler, OdfS
 		manifestElement.write(pHandler);
 
 		TagOpenElement mainFile("manifest:file-entry");
-		mainFile.addAttribute("manifest:media-type", "application/vnd.oasis.opendocument.text");
+		mainFile.addAttribute("manifest:media-type", getDocumentMimeType());
 		mainFile.addAttribute("manifest:full-path", "/");
 		mainFile.write(pHandler);
 		TagCloseElement("manifest:file-entry").write(pHandler);
@@ -394,7 +399,7 @@ bool OdtGeneratorPrivate::writeTargetDocument(OdfDocumentHandler *pHandler, OdfS
 	docContentPropList.insert("xmlns:style", "urn:oasis:names:tc:opendocument:xmlns:style:1.0");
 	docContentPropList.insert("office:version", librevenge::RVNGPropertyFactory::newStringProp("1.1"));
 	if (streamType == ODF_FLAT_XML)
-		docContentPropList.insert("office:mimetype", "application/vnd.oasis.opendocument.text");
+		docContentPropList.insert("office:mimetype", getDocumentMimeType());
 	pHandler->startElement(documentType.c_str(), docContentPropList);
 
 	// write out the metadata
@@ -475,6 +480,70 @@ bool OdtGenerator::getObjectContent(librevenge::RVNGString const &objectName, Od
 	return mpImpl->getObjectContent(objectName, pHandler);
 }
 
+void OdtGenerator::setContentStreaming(bool stream)
+{
+	if (mpImpl)
+		mpImpl->setContentStreaming(stream);
+}
+
+void OdtGenerator::setPackageWriter(OdfPackageWriter *pWriter)
+{
+	if (mpImpl)
+		mpImpl->setPackageWriter(pWriter);
+}
+
+void OdtGenerator::setParallelWriting(bool parallel)
+{
+	if (mpImpl)
+		mpImpl->setParallelWriting(parallel);
+}
+
+void OdtGenerator::setExternalPictures(bool external)
+{
+	if (mpImpl)
+		mpImpl->setExternalPictures(external);
+}
+
+void OdtGenerator::setAsynchronousImageConversion(bool async)
+{
+	if (mpImpl)
+		mpImpl->setAsynchronousImageConversion(async);
+}
+
+void OdtGenerator::setEmbeddedObjectCacheSize(unsigned size)
+{
+	if (mpImpl)
+		mpImpl->setEmbeddedObjectCacheSize(size);
+}
+
+void OdtGenerator::getEmbeddedObjectCacheStatistics(unsigned long &hits, unsigned long &misses) const
+{
+	hits=misses=0;
+	if (mpImpl)
+		mpImpl->getEmbeddedObjectCacheStatistics(hits, misses);
+}
+
+void OdtGenerator::getStyleCacheStatistics(unsigned long &hits, unsigned long &misses) const
+{
+	hits=misses=0;
+	if (mpImpl)
+		mpImpl->getStyleCacheStatistics(hits, misses);
+}
+
+librevenge::RVNGStringVector OdtGenerator::getPictureNames() const
+{
+	if (mpImpl)
+		return mpImpl->getPictureNames();
+	return librevenge::RVNGStringVector();
+}
+
+bool OdtGenerator::getPictureContent(librevenge::RVNGString const &name, librevenge::RVNGBinaryData &data, librevenge::RVNGString &mimeType) const
+{
+	if (!mpImpl)
+		return false;
+	return mpImpl->getPictureContent(name, data, mimeType);
+}
+
 void OdtGenerator::setDocumentMetaData(const librevenge::RVNGPropertyList &propList)
 {
 	mpImpl->setDocumentMetaData(propList);
@@ -593,7 +662,7 @@ void OdtGenerator::openSection(const librevenge::RVNGPropertyList &propList)
 void OdtGenerator::closeSection()
 {
 	if (!mpImpl->getState().mbInFakeSection)
-		mpImpl->getCurrentStorage()->push_back(new TagCloseElement("text:section"));
+		mpImpl->getCurrentStorage()->push_back(TagCloseElement("text:section"));
 	else
 		mpImpl->getState().mbInFakeSection = false;
 }
@@ -710,17 +779,17 @@ void OdtGenerator::openFootnote(const librevenge::RVNGPropertyList &propList)
 	{
 		librevenge::RVNGString tmpString;
 		tmpString.appendEscapedXML(propList["text:label"]->getStr());
-		pOpenFootCitation->addAttribute("text:label", tmpString);
+		pOpenFootCitation->addEscapedAttribute("text:label", tmpString);
 	}
 	mpImpl->getCurrentStorage()->push_back(pOpenFootCitation);
 
 	if (propList["text:label"])
-		mpImpl->getCurrentStorage()->push_back(new CharDataElement(propList["text:label"]->getStr().cstr()));
+		mpImpl->getCurrentStorage()->push_back(CharDataElement(propList["text:label"]->getStr().cstr()));
 	else if (propList["librevenge:number"])
-		mpImpl->getCurrentStorage()->push_back(new CharDataElement(propList["librevenge:number"]->getStr().cstr()));
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("text:note-citation"));
+		mpImpl->getCurrentStorage()->push_back(CharDataElement(propList["librevenge:number"]->getStr().cstr()));
+	mpImpl->getCurrentStorage()->push_back(TagCloseElement("text:note-citation"));
 
-	mpImpl->getCurrentStorage()->push_back(new TagOpenElement("text:note-body"));
+	mpImpl->getCurrentStorage()->push_back(TagOpenElement("text:note-body"));
 
 	mpImpl->getState().mbInNote = true;
 }
@@ -730,8 +799,8 @@ void OdtGenerator::closeFootnote()
 	mpImpl->getState().mbInNote = false;
 	mpImpl->popListState();
 
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("text:note-body"));
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("text:note"));
+	mpImpl->getCurrentStorage()->push_back(TagCloseElement("text:note-body"));
+	mpImpl->getCurrentStorage()->push_back(TagCloseElement("text:note"));
 }
 
 void OdtGenerator::openEndnote(const librevenge::RVNGPropertyList &propList)
@@ -752,17 +821,17 @@ void OdtGenerator::openEndnote(const librevenge::RVNGPropertyList &propList)
 	{
 		librevenge::RVNGString tmpString;
 		tmpString.appendEscapedXML(propList["text:label"]->getStr());
-		pOpenEndCitation->addAttribute("text:label", tmpString);
+		pOpenEndCitation->addEscapedAttribute("text:label", tmpString);
 	}
 	mpImpl->getCurrentStorage()->push_back(pOpenEndCitation);
 
 	if (propList["text:label"])
-		mpImpl->getCurrentStorage()->push_back(new CharDataElement(propList["text:label"]->getStr().cstr()));
+		mpImpl->getCurrentStorage()->push_back(CharDataElement(propList["text:label"]->getStr().cstr()));
 	else if (propList["librevenge:number"])
-		mpImpl->getCurrentStorage()->push_back(new CharDataElement(propList["librevenge:number"]->getStr().cstr()));
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("text:note-citation"));
+		mpImpl->getCurrentStorage()->push_back(CharDataElement(propList["librevenge:number"]->getStr().cstr()));
+	mpImpl->getCurrentStorage()->push_back(TagCloseElement("text:note-citation"));
 
-	mpImpl->getCurrentStorage()->push_back(new TagOpenElement("text:note-body"));
+	mpImpl->getCurrentStorage()->push_back(TagOpenElement("text:note-body"));
 
 	mpImpl->getState().mbInNote = true;
 }
@@ -771,14 +840,14 @@ void OdtGenerator::closeEndnote()
 {
 	mpImpl->getState().mbInNote = false;
 	mpImpl->popListState();
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("text:note-body"));
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("text:note"));
+	mpImpl->getCurrentStorage()->push_back(TagCloseElement("text:note-body"));
+	mpImpl->getCurrentStorage()->push_back(TagCloseElement("text:note"));
 }
 
 void OdtGenerator::openComment(const librevenge::RVNGPropertyList &)
 {
 	mpImpl->pushListState();
-	mpImpl->getCurrentStorage()->push_back(new TagOpenElement("office:annotation"));
+	mpImpl->getCurrentStorage()->push_back(TagOpenElement("office:annotation"));
 
 	mpImpl->getState().mbInNote = true;
 }
@@ -787,7 +856,7 @@ void OdtGenerator::closeComment()
 {
 	mpImpl->getState().mbInNote = false;
 	mpImpl->popListState();
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("office:annotation"));
+	mpImpl->getCurrentStorage()->push_back(TagCloseElement("office:annotation"));
 }
 
 void OdtGenerator::openTable(const librevenge::RVNGPropertyList &propList)
@@ -981,7 +1050,7 @@ void OdtGenerator::closeTextBox()
 	mpImpl->popListState();
 	mpImpl->popState();
 
-	mpImpl->getCurrentStorage()->push_back(new TagCloseElement("draw:text-box"));
+	mpImpl->getCurrentStorage()->push_back(TagCloseElement("draw:text-box"));
 }
 
 void OdtGenerator::defineSectionStyle(librevenge::RVNGPropertyList const &)
@@ -1000,6 +1069,7 @@ void OdtGenerator::endDocument()
 
 void OdtGenerator::startDocument(const librevenge::RVNGPropertyList &)
 {
+	mpImpl->startContentStreaming();
 }
 
 void OdtGenerator::closePageSpan()
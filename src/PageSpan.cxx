@@ -42,14 +42,15 @@ PageDrawingStyle::~PageDrawingStyle()
 
 void PageDrawingStyle::write(OdfDocumentHandler *pHandler) const
 {
-	librevenge::RVNGPropertyList propList;
-	propList.insert("style:name", getName());
+	// the display name is already escaped
+	TagOpenElement styleOpen("style:style");
+	styleOpen.addAttribute("style:name", getName());
 	if (mpPropList["style:display-name"])
-		propList.insert("style:display-name", mpPropList["style:display-name"]);
-	propList.insert("style:family", "drawing-page");
-	pHandler->startElement("style:style", propList);
+		styleOpen.addEscapedAttribute("style:display-name", mpPropList["style:display-name"]->getStr());
+	styleOpen.addAttribute("style:family", "drawing-page");
+	styleOpen.write(pHandler);
 
-	propList.clear();
+	librevenge::RVNGPropertyList propList;
 	librevenge::RVNGPropertyList::Iter i(mpPropList);
 	for (i.rewind(); i.next();)
 	{
@@ -88,26 +89,27 @@ void PageLayoutStyle::resetPageSizeAndMargins(double width, double height)
 
 void PageLayoutStyle::write(OdfDocumentHandler *pHandler) const
 {
-	librevenge::RVNGPropertyList propList;
-	propList.insert("style:name", getName());
+	// the display name is already escaped
+	TagOpenElement layoutOpen("style:page-layout");
+	layoutOpen.addAttribute("style:name", getName());
 	if (mpPropList["style:display-name"])
-		propList.insert("style:display-name", mpPropList["style:display-name"]);
-	pHandler->startElement("style:page-layout", propList);
+		layoutOpen.addEscapedAttribute("style:display-name", mpPropList["style:display-name"]->getStr());
+	layoutOpen.write(pHandler);
 
-	librevenge::RVNGPropertyList tempPropList;
-	tempPropList.insert("style:writing-mode", librevenge::RVNGString("lr-tb"));
-	tempPropList.insert("style:footnote-max-height", librevenge::RVNGString("0in"));
+	TagOpenElement propertiesOpen("style:page-layout-properties");
+	propertiesOpen.addAttribute("style:writing-mode", "lr-tb");
+	propertiesOpen.addAttribute("style:footnote-max-height", "0in");
 	librevenge::RVNGPropertyList::Iter i(mpPropList);
 	for (i.rewind(); i.next();)
 	{
 		if (i.child() || strncmp(i.key(), "librevenge:", 11)==0 || strncmp(i.key(), "svg:", 4)==0)
 			continue;
 		if (strncmp(i.key(), "draw:name", 9) == 0)
-			tempPropList.insert(i.key(), librevenge::RVNGString::escapeXML(i()->getStr()));
+			propertiesOpen.addEscapedAttribute(i.key(), librevenge::RVNGString::escapeXML(i()->getStr()));
 		else
-			tempPropList.insert(i.key(), i()->clone());
+			propertiesOpen.addAttribute(i.key(), i()->getStr());
 	}
-	pHandler->startElement("style:page-layout-properties", tempPropList);
+	propertiesOpen.write(pHandler);
 
 	librevenge::RVNGPropertyList footnoteSepPropList;
 	if (mpPropList.child("librevenge:footnote"))
@@ -181,11 +183,11 @@ void PageSpan::storeContent(ContentType type, libodfgen::DocumentElementVector *
 
 void PageSpan::writeMasterPages(OdfDocumentHandler *pHandler) const
 {
+	// the display name is already escaped
 	TagOpenElement masterOpen("style:master-page");
-	librevenge::RVNGPropertyList propList;
-	propList.insert("style:name", msMasterName);
+	masterOpen.addAttribute("style:name", msMasterName);
 	if (!msMasterDisplay.empty() && msMasterDisplay!=msMasterName)
-		propList.insert("style:display-name", msMasterDisplay);
+		masterOpen.addEscapedAttribute("style:display-name", msMasterDisplay);
 	/* we do not set any next-style to avoid problem when the input is
 	   OpenPageSpan("A")
 	      ... : many pages of text without any page break
@@ -199,10 +201,10 @@ void PageSpan::writeMasterPages(OdfDocumentHandler *pHandler) const
 		  the layout B.
 	 */
 	if (!msDrawingName.empty())
-		propList.insert("draw:style-name", getDrawingName());
+		masterOpen.addAttribute("draw:style-name", getDrawingName());
 	if (!msLayoutName.empty())
-		propList.insert("style:page-layout-name", msLayoutName);
-	pHandler->startElement("style:master-page", propList);
+		masterOpen.addAttribute("style:page-layout-name", msLayoutName);
+	masterOpen.write(pHandler);
 
 	if (mpContent[C_Header])
 		_writeContent("style:header", *mpContent[C_Header], pHandler);
@@ -248,12 +250,7 @@ void PageSpan::_writeContent(const char *contentTagName,
 	bool hasTagName=contentTagName && strlen(contentTagName);
 	if (hasTagName)
 		TagOpenElement(contentTagName).write(pHandler);
-	for (std::vector<shared_ptr<DocumentElement> >::const_iterator iter = content.begin();
-	        iter != content.end();
-	        ++iter)
-	{
-		(*iter)->write(pHandler);
-	}
+	content.write(pHandler);
 	if (hasTagName)
 		TagCloseElement(contentTagName).write(pHandler);
 }
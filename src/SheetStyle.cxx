@@ -53,7 +53,7 @@ void SheetNumberingStyle::writeCondition(librevenge::RVNGPropertyList const &pro
 		return;
 	}
 	TagOpenElement mapOpen("style:map");
-	mapOpen.addAttribute("style:condition",formulaString);
+	mapOpen.addEscapedAttribute("style:condition",formulaString);
 	mapOpen.addAttribute("style:apply-style-name",applyName);
 	mapOpen.write(pHandler);
 	TagCloseElement("style:map").write(pHandler);
@@ -338,15 +338,70 @@ void SheetRowStyle::writeStyle(OdfDocumentHandler *pHandler, SheetManager const
 }
 
 
-SheetStyle::SheetStyle(const librevenge::RVNGPropertyList &xPropList, const char *psName, Style::Zone zone) :
+SheetStylePool::SheetStylePool(const char *prefix) :
+	msPrefix(prefix), mRowNameHash(), mRowStyleHash(), mCellNameHash(), mCellStyleHash()
+{
+}
+
+librevenge::RVNGString SheetStylePool::addRow(const librevenge::RVNGPropertyList &propList, libodfgen::StyleKey const &key)
+{
+	librevenge::RVNGString const *styleName=mRowNameHash.find(key);
+	if (styleName) return *styleName;
+
+	librevenge::RVNGString name;
+	name.sprintf("%s_row%i", msPrefix.cstr(), (int) mRowStyleHash.size());
+	mRowNameHash.insert(key, name);
+	mRowStyleHash[name]=shared_ptr<SheetRowStyle>(new SheetRowStyle(propList, name.cstr()));
+	return name;
+}
+
+librevenge::RVNGString SheetStylePool::addCell(const librevenge::RVNGPropertyList &propList, libodfgen::StyleKey const &key)
+{
+	librevenge::RVNGString const *styleName=mCellNameHash.find(key);
+	if (styleName) return *styleName;
+
+	librevenge::RVNGString name;
+	name.sprintf("%s_cell%i", msPrefix.cstr(), (int) mCellStyleHash.size());
+	mCellNameHash.insert(key, name);
+	mCellStyleHash[name]=shared_ptr<SheetCellStyle>(new SheetCellStyle(propList, name.cstr()));
+	return name;
+}
+
+void SheetStylePool::write(OdfDocumentHandler *pHandler, SheetManager const &manager) const
+{
+	std::map<librevenge::RVNGString, shared_ptr<SheetRowStyle> >::const_iterator rIt;
+	for (rIt=mRowStyleHash.begin(); rIt!=mRowStyleHash.end(); ++rIt)
+	{
+		if (!rIt->second) continue;
+		rIt->second->writeStyle(pHandler, manager);
+	}
+
+	std::map<librevenge::RVNGString, shared_ptr<SheetCellStyle> >::const_iterator cIt;
+	for (cIt=mCellStyleHash.begin(); cIt!=mCellStyleHash.end(); ++cIt)
+	{
+		if (!cIt->second) continue;
+		cIt->second->writeStyle(pHandler, manager);
+	}
+}
+
+SheetStyle::SheetStyle(const librevenge::RVNGPropertyList &xPropList, const char *psName, Style::Zone zone,
+                       shared_ptr<SheetStylePool> pool) :
 	Style(psName, zone), mPropList(xPropList), mColumns(0),
-	mRowNameHash(), mRowStyleHash(), mCellNameHash(), mCellStyleHash()
+	mRowCache(libodfgen::StyleKey::isNotLibrevengeProperty, false),
+	mCellCache(libodfgen::StyleKey::isCellStyleProperty, false),
+	mKey(), mPool(pool), mbSharedPool(bool(pool))
 {
 	mColumns = mPropList.child("librevenge:columns");
+	if (!mPool)
+		mPool.reset(new SheetStylePool(psName));
 }
 
 SheetStyle::~SheetStyle()
 {
+	if (mCellCache.getNumLookups())
+	{
+		ODFGEN_DEBUG_MSG(("SheetStyle::~SheetStyle: %lu cell styles found in the cache on %lu\n", mCellCache.getNumHits(), mCellCache.getNumLookups()));
+	}
 }
 
 void SheetStyle::writeStyle(OdfDocumentHandler *pHandler, SheetManager const &manager) const
@@ -398,73 +453,38 @@ void SheetStyle::writeStyle(OdfDocumentHandler *pHandler, SheetManager const &ma
 		}
 	}
 
-	std::map<librevenge::RVNGString, shared_ptr<SheetRowStyle> >::const_iterator rIt;
-	for (rIt=mRowStyleHash.begin(); rIt!=mRowStyleHash.end(); ++rIt)
-	{
-		if (!rIt->second) continue;
-		rIt->second->writeStyle(pHandler, manager);
-	}
-
-	std::map<librevenge::RVNGString, shared_ptr<SheetCellStyle> >::const_iterator cIt;
-	for (cIt=mCellStyleHash.begin(); cIt!=mCellStyleHash.end(); ++cIt)
-	{
-		if (!cIt->second) continue;
-		cIt->second->writeStyle(pHandler, manager);
-	}
+	// the shared styles are written by the manager
+	if (!mbSharedPool)
+		mPool->write(pHandler, manager);
 }
 
 librevenge::RVNGString SheetStyle::addRow(const librevenge::RVNGPropertyList &propList)
 {
-	// first remove unused data
-	librevenge::RVNGPropertyList pList;
-	librevenge::RVNGPropertyList::Iter i(propList);
-	for (i.rewind(); i.next();)
-	{
-		if (!strncmp(i.key(), "librevenge:", 11))
-			continue;
-		if (i.child())
-			continue;
-		pList.insert(i.key(),i()->clone());
-	}
-	librevenge::RVNGString hashKey = pList.getPropString();
-	std::map<librevenge::RVNGString, librevenge::RVNGString>::const_iterator iter =
-	    mRowNameHash.find(hashKey);
-	if (iter!=mRowNameHash.end()) return iter->second;
-
-	librevenge::RVNGString name;
-	name.sprintf("%s_row%i", getName().cstr(), (int) mRowStyleHash.size());
-	mRowNameHash[hashKey]=name;
-	mRowStyleHash[name]=shared_ptr<SheetRowStyle>(new SheetRowStyle(propList, name.cstr()));
+	librevenge::RVNGString const *styleName=mRowCache.find(propList, 0);
+	if (styleName) return *styleName;
+	// the key does not contain the librevenge: data
+	mKey.clear();
+	mKey.append(propList, libodfgen::StyleKey::isNotLibrevengeProperty, false);
+	librevenge::RVNGString name=mPool->addRow(propList, mKey);
+	mRowCache.insert(propList, 0, name);
 	return name;
 }
 
 librevenge::RVNGString SheetStyle::addCell(const librevenge::RVNGPropertyList &propList)
 {
-	// first remove unused data
-	librevenge::RVNGPropertyList pList;
-	librevenge::RVNGPropertyList::Iter i(propList);
-	for (i.rewind(); i.next();)
-	{
-		if (!strncmp(i.key(), "librevenge:", 11) &&
-		        strncmp(i.key(), "librevenge:numbering-name", 24))
-			continue;
-		if (i.child())
-			continue;
-		pList.insert(i.key(),i()->clone());
-	}
-	librevenge::RVNGString hashKey = pList.getPropString();
-	std::map<librevenge::RVNGString, librevenge::RVNGString>::const_iterator iter =
-	    mCellNameHash.find(hashKey);
-	if (iter!=mCellNameHash.end()) return iter->second;
-
-	librevenge::RVNGString name;
-	name.sprintf("%s_cell%i", getName().cstr(), (int) mCellStyleHash.size());
-	mCellNameHash[hashKey]=name;
-	mCellStyleHash[name]=shared_ptr<SheetCellStyle>(new SheetCellStyle(propList, name.cstr()));
+	librevenge::RVNGString const *styleName=mCellCache.find(propList, 0);
+	if (styleName) return *styleName;
+	// the key does not contain the librevenge: data, excepted the numbering name
+	mKey.clear();
+	mKey.append(propList, libodfgen::StyleKey::isCellStyleProperty, false);
+	librevenge::RVNGString name=mPool->addCell(propList, mKey);
+	mCellCache.insert(propList, 0, name);
 	return name;
 }
 
-SheetManager::SheetManager() : mbSheetOpened(false), mSheetStyles(), mNumberingHash()
+SheetManager::SheetManager() : mbSheetOpened(false), mSheetStyles(),
+	mbShareStyles(false), mContentStylePool(), mStyleStylePool(), mNumberingHash(),
+	mFormulaKey(), mFormulaHash(), mFormulaBuffer()
 {
 }
 
@@ -475,6 +495,9 @@ SheetManager::~SheetManager()
 void SheetManager::clean()
 {
 	mSheetStyles.clear();
+	mContentStylePool.reset();
+	mStyleStylePool.reset();
+	mFormulaHash.clear();
 }
 
 bool SheetManager::openSheet(const librevenge::RVNGPropertyList &xPropList, Style::Zone zone)
@@ -493,7 +516,15 @@ bool SheetManager::openSheet(const librevenge::RVNGPropertyList &xPropList, Styl
 		sTableName.sprintf("Sheet_M%i", (int) mSheetStyles.size());
 	else
 		sTableName.sprintf("Sheet%i", (int) mSheetStyles.size());
-	shared_ptr<SheetStyle> sheet(new SheetStyle(xPropList, sTableName.cstr(), zone));
+	shared_ptr<SheetStylePool> pool;
+	if (mbShareStyles)
+	{
+		shared_ptr<SheetStylePool> &sharedPool=zone==Style::Z_StyleAutomatic ? mStyleStylePool : mContentStylePool;
+		if (!sharedPool)
+			sharedPool.reset(new SheetStylePool(zone==Style::Z_StyleAutomatic ? "Sheet_M" : "Sheet"));
+		pool=sharedPool;
+	}
+	shared_ptr<SheetStyle> sheet(new SheetStyle(xPropList, sTableName.cstr(), zone, pool));
 	mSheetStyles.push_back(sheet);
 	return true;
 }
@@ -509,6 +540,15 @@ bool SheetManager::closeSheet()
 	return true;
 }
 
+void SheetManager::addCacheStatistics(unsigned long &hits, unsigned long &misses) const
+{
+	for (size_t i=0; i<mSheetStyles.size(); ++i)
+	{
+		if (mSheetStyles[i])
+			mSheetStyles[i]->addCacheStatistics(hits, misses);
+	}
+}
+
 librevenge::RVNGString SheetManager::getNumberingStyleName(librevenge::RVNGString const &localName) const
 {
 	std::map<librevenge::RVNGString, shared_ptr<SheetNumberingStyle> >::const_iterator it=
@@ -539,94 +579,341 @@ void SheetManager::addNumberingStyle(const librevenge::RVNGPropertyList &xPropLi
 	mNumberingHash[name]=style;
 }
 
-librevenge::RVNGString SheetManager::convertFormula(const librevenge::RVNGPropertyListVector &formula)
+SheetFormula::TokenType SheetFormula::getTokenType(librevenge::RVNGPropertyList const &token)
 {
-	librevenge::RVNGString res("");
-	std::stringstream s;
-	s << "of:=";
+	librevenge::RVNGProperty const *prop=token["librevenge:type"];
+	if (!prop)
+		return T_Bad;
+	librevenge::RVNGString const type(prop->getStr());
+	char const *str=type.cstr();
+	if (strncmp(str, "librevenge-", 11)!=0)
+		return T_Bad;
+	str+=11;
+	// the first character is enough to find the type, excepted for cell and cells
+	switch (str[0])
+	{
+	case 'c':
+		return strcmp(str, "cell")==0 ? T_Cell : strcmp(str, "cells")==0 ? T_Cells : T_Bad;
+	case 'f':
+		return strcmp(str, "function")==0 ? T_Function : T_Bad;
+	case 'n':
+		return strcmp(str, "number")==0 ? T_Number : T_Bad;
+	case 'o':
+		return strcmp(str, "operator")==0 ? T_Operator : T_Bad;
+	case 't':
+		return strcmp(str, "text")==0 ? T_Text : T_Bad;
+	default:
+		break;
+	}
+	return T_Bad;
+}
+
+bool SheetFormula::isOperator(char const *op)
+{
+	// the operators are: ( ) + - * / = <> ; < > <= >= ^ &
+	switch (op[0])
+	{
+	case '(':
+	case ')':
+	case '+':
+	case '-':
+	case '*':
+	case '/':
+	case '=':
+	case ';':
+	case '^':
+	case '&':
+		return op[1]==0;
+	case '<':
+		return op[1]==0 || ((op[1]=='>' || op[1]=='=') && op[2]==0);
+	case '>':
+		return op[1]==0 || (op[1]=='=' && op[2]==0);
+	default:
+		break;
+	}
+	return false;
+}
+
+bool SheetFormula::getKey(const librevenge::RVNGPropertyListVector &formula, int column, int row, libodfgen::StyleKey &key)
+{
+	key.clear();
 	for (unsigned long i=0; i<formula.count(); ++i)
 	{
-		librevenge::RVNGPropertyList const &list=formula[i];
-		if (!list["librevenge:type"])
+		librevenge::RVNGPropertyList const &token=formula[i];
+		TokenType const type=getTokenType(token);
+		key.append(int(type));
+		switch (type)
 		{
-			ODFGEN_DEBUG_MSG(("SheetManager::convertFormula can not find %s formula type !!!\n", s.str().c_str()));
-			return res;
-		}
-		std::string type(list["librevenge:type"]->getStr().cstr());
-		if (type=="librevenge-operator")
+		case T_Operator:
 		{
-			if (!list["librevenge:operator"])
+			if (!token["librevenge:operator"])
 			{
-				ODFGEN_DEBUG_MSG(("SheetManager::convertFormula can not find operator for formula[%s]!!!\n", s.str().c_str()));
-				return res;
+				ODFGEN_DEBUG_MSG(("SheetFormula::getKey can not find operator for formula!!!\n"));
+				return false;
 			}
-			std::string oper(list["librevenge:operator"]->getStr().cstr());
-			bool find=false;
-			for (int w=0; w<15; ++w)
+			librevenge::RVNGString const oper(token["librevenge:operator"]->getStr());
+			if (!isOperator(oper.cstr()))
 			{
-				static char const *(s_operators[15])=
-				{
-					"(", ")", "+", "-", "*", "/", "=", "<>",  ";", "<", ">", "<=", ">=", "^", "&"
-				};
-				if (oper!=s_operators[w]) continue;
-				s << oper;
-				find=true;
-				break;
-			}
-			if (!find)
-			{
-				ODFGEN_DEBUG_MSG(("SheetManager::convertFormula find unknown operator for formula[%s]!!!\n", s.str().c_str()));
-				return res;
+				ODFGEN_DEBUG_MSG(("SheetFormula::getKey find unknown operator %s!!!\n", oper.cstr()));
+				return false;
 			}
+			key.append(oper.cstr());
+			break;
 		}
-		else if (type=="librevenge-function")
+		case T_Function:
+		case T_Number:
+		case T_Text:
 		{
-			if (!list["librevenge:function"])
+			char const *wh=type==T_Function ? "librevenge:function" : type==T_Number ? "librevenge:number" : "librevenge:text";
+			if (!token[wh])
 			{
-				ODFGEN_DEBUG_MSG(("SheetManager::convertFormula can not find value for formula[%s]!!!\n", s.str().c_str()));
-				return res;
+				ODFGEN_DEBUG_MSG(("SheetFormula::getKey can not find %s for formula!!!\n", wh));
+				return false;
 			}
-			s << list["librevenge:function"]->getStr().cstr();
+			key.append(token[wh]->getStr().cstr());
+			break;
 		}
-		else if (type=="librevenge-number")
+		case T_Cell:
+		case T_Cells:
 		{
-			if (!list["librevenge:number"])
+			static char const *(s_cellKeys[])=
+			{
+				"librevenge:column", "librevenge:row", "librevenge:column-absolute", "librevenge:row-absolute", "librevenge:sheet"
+			};
+			static char const *(s_cellsKeys[])=
+			{
+				"librevenge:start-column", "librevenge:start-row", "librevenge:start-column-absolute", "librevenge:start-row-absolute", "librevenge:sheet-name",
+				"librevenge:end-column", "librevenge:end-row", "librevenge:end-column-absolute", "librevenge:end-row-absolute"
+			};
+			char const *const *keys=type==T_Cell ? s_cellKeys : s_cellsKeys;
+			if (!token[keys[0]] || !token[keys[1]])
 			{
-				ODFGEN_DEBUG_MSG(("SheetManager::convertFormula can not find value for formula[%s]!!!\n", s.str().c_str()));
-				return res;
+				ODFGEN_DEBUG_MSG(("SheetFormula::getKey can not find cell coordinate!!!\n"));
+				return false;
 			}
-			s << list["librevenge:number"]->getStr().cstr();
+			key.append(token[keys[4]] ? token[keys[4]]->getStr().cstr() : 0);
+			int const cellValues[]= {column, row};
+			int lastValues[2]= {0, 0};
+			for (int c=0; c<(type==T_Cell ? 1 : 2); ++c)
+			{
+				for (int w=0; w<2; ++w)
+				{
+					librevenge::RVNGProperty const *prop=token[keys[c==0 ? w : 5+w]];
+					int const value=prop ? prop->getInt() : lastValues[w];
+					if (value<0)
+					{
+						ODFGEN_DEBUG_MSG(("SheetFormula::getKey: find bad coordinate!!!\n"));
+						return false;
+					}
+					librevenge::RVNGProperty const *absolute=token[keys[c==0 ? 2+w : 7+w]];
+					bool const isAbsolute=absolute && absolute->getInt();
+					key.append(isAbsolute ? 1 : 0);
+					key.append(isAbsolute ? value : value-cellValues[w]);
+					lastValues[w]=value;
+				}
+			}
+			break;
+		}
+		case T_Bad:
+		default:
+			ODFGEN_DEBUG_MSG(("SheetFormula::getKey find unknown type!!!\n"));
+			return false;
 		}
-		else if (type=="librevenge-text")
+	}
+	return true;
+}
+
+void SheetFormula::appendText(char const *text)
+{
+	if (mParts.empty() || mParts.back().mCoordinate!=C_None)
+		mParts.push_back(Part());
+	mParts.back().mText.append(text);
+}
+
+void SheetFormula::addCoordinate(bool column, bool absolute, int value, int cellValue)
+{
+	appendText(absolute ? "$" : "");
+	Part &part=mParts.back();
+	part.mCoordinate=column ? C_Column : C_Row;
+	part.mAbsolute=absolute;
+	part.mValue=absolute ? value : value-cellValue;
+}
+
+bool SheetFormula::addCellReference(librevenge::RVNGPropertyList const &token, char const *prefix, int column, int row,
+                                    librevenge::RVNGProperty const *defaultColumn, librevenge::RVNGProperty const *defaultRow)
+{
+	std::string name(prefix);
+	size_t const len=name.length();
+	name.append("column");
+	librevenge::RVNGProperty const *colProp=token[name.c_str()] ? token[name.c_str()] : defaultColumn;
+	name.replace(len, std::string::npos, "row");
+	librevenge::RVNGProperty const *rowProp=token[name.c_str()] ? token[name.c_str()] : defaultRow;
+	if (!colProp || !rowProp)
+		return false;
+	if (colProp->getInt()<0 || rowProp->getInt()<0)
+	{
+		ODFGEN_DEBUG_MSG(("SheetFormula::addCellReference: find bad coordinate!!!\n"));
+		return false;
+	}
+	name.replace(len, std::string::npos, "column-absolute");
+	librevenge::RVNGProperty const *colAbsolute=token[name.c_str()];
+	name.replace(len, std::string::npos, "row-absolute");
+	librevenge::RVNGProperty const *rowAbsolute=token[name.c_str()];
+	addCoordinate(true, colAbsolute && colAbsolute->getInt(), colProp->getInt(), column);
+	addCoordinate(false, rowAbsolute && rowAbsolute->getInt(), rowProp->getInt(), row);
+	return true;
+}
+
+bool SheetFormula::compile(const librevenge::RVNGPropertyListVector &formula, int column, int row)
+{
+	mParts.clear();
+	appendText("of:=");
+	for (unsigned long i=0; i<formula.count(); ++i)
+	{
+		librevenge::RVNGPropertyList const &token=formula[i];
+		switch (getTokenType(token))
+		{
+		case T_Operator:
 		{
-			if (!list["librevenge:text"])
+			if (!token["librevenge:operator"]) return false;
+			librevenge::RVNGString const oper(token["librevenge:operator"]->getStr());
+			if (!isOperator(oper.cstr()))
 			{
-				ODFGEN_DEBUG_MSG(("SheetManager::convertFormula can not find text for formula[%s]!!!\n", s.str().c_str()));
-				return res;
+				ODFGEN_DEBUG_MSG(("SheetFormula::compile find unknown operator %s!!!\n", oper.cstr()));
+				return false;
 			}
-			librevenge::RVNGString escaped;
-			escaped.appendEscapedXML(list["librevenge:text"]->getStr());
-			s << "\"" << escaped.cstr() << "\"";
+			appendText(librevenge::RVNGString::escapeXML(oper).cstr());
+			break;
 		}
-		else if (type=="librevenge-cell")
+		case T_Function:
+			if (!token["librevenge:function"]) return false;
+			appendText(librevenge::RVNGString::escapeXML(token["librevenge:function"]->getStr()).cstr());
+			break;
+		case T_Number:
+			if (!token["librevenge:number"]) return false;
+			appendText(librevenge::RVNGString::escapeXML(token["librevenge:number"]->getStr()).cstr());
+			break;
+		case T_Text:
 		{
-			librevenge::RVNGString range=convertCellRange(list);
-			if (range.empty()) return res;
-			s << "[" << range.cstr() << "]";
+			if (!token["librevenge:text"]) return false;
+			librevenge::RVNGString text("\"");
+			text.appendEscapedXML(token["librevenge:text"]->getStr());
+			text.append("\"");
+			appendText(librevenge::RVNGString::escapeXML(text).cstr());
+			break;
 		}
-		else if (type=="librevenge-cells")
+		case T_Cell:
+			appendText("[");
+			if (token["librevenge:sheet"])
+				appendText(librevenge::RVNGString::escapeXML(token["librevenge:sheet"]->getStr()).cstr());
+			appendText(".");
+			if (!addCellReference(token, "librevenge:", column, row)) return false;
+			appendText("]");
+			break;
+		case T_Cells:
 		{
-			librevenge::RVNGString ranges=convertCellsRange(list);
-			if (ranges.empty()) return res;
-			s << "[" << ranges.cstr() << "]";
+			appendText("[");
+			if (token["librevenge:sheet-name"])
+				appendText(librevenge::RVNGString::escapeXML(token["librevenge:sheet-name"]->getStr()).cstr());
+			appendText(".");
+			if (!addCellReference(token, "librevenge:start-", column, row)) return false;
+			appendText(":");
+			// the end coordinates are the start coordinates if they are not defined
+			if (!addCellReference(token, "librevenge:end-", column, row,
+			                      token["librevenge:start-column"], token["librevenge:start-row"])) return false;
+			appendText("]");
+			break;
+		}
+		case T_Bad:
+		default:
+			return false;
+		}
+	}
+	return true;
+}
+
+bool SheetFormula::write(int column, int row, std::string &res) const
+{
+	char buffer[16];
+	for (size_t p=0; p<mParts.size(); ++p)
+	{
+		Part const &part=mParts[p];
+		res.append(part.mText);
+		if (part.mCoordinate==C_None) continue;
+		int value=part.mValue;
+		if (!part.mAbsolute)
+			value+=part.mCoordinate==C_Column ? column : row;
+		if (value<0)
+		{
+			ODFGEN_DEBUG_MSG(("SheetFormula::write: find bad coordinate!!!\n"));
+			return false;
+		}
+		// the digits are created from the last one
+		char *pos=buffer+sizeof(buffer);
+		if (part.mCoordinate==C_Column)
+		{
+			// A..Z, AA..AZ, BA..., ZZ, AAA, ...
+			do
+			{
+				*(--pos)=char('A'+value%26);
+				value=value/26-1;
+			}
+			while (value>=0 && pos!=buffer);
 		}
 		else
 		{
-			ODFGEN_DEBUG_MSG(("SheetManager::convertFormula find unknown type %s!!!\n", type.c_str()));
-			return res;
+			unsigned number=unsigned(value)+1;
+			do
+			{
+				*(--pos)=char('0'+number%10);
+				number/=10;
+			}
+			while (number && pos!=buffer);
 		}
+		res.append(pos, size_t(buffer+sizeof(buffer)-pos));
 	}
-	return librevenge::RVNGString::escapeXML(s.str().c_str());
+	return true;
+}
+
+librevenge::RVNGString SheetManager::convertFormula(const librevenge::RVNGPropertyListVector &formula)
+{
+	SheetFormula converted;
+	if (!converted.compile(formula, 0, 0))
+	{
+		ODFGEN_DEBUG_MSG(("SheetManager::convertFormula can not convert a formula!!!\n"));
+		return librevenge::RVNGString("");
+	}
+	std::string res;
+	if (!converted.write(0, 0, res))
+		return librevenge::RVNGString("");
+	return librevenge::RVNGString(res.c_str());
+}
+
+librevenge::RVNGString SheetManager::convertFormula(const librevenge::RVNGPropertyListVector &formula, int column, int row)
+{
+	if (!SheetFormula::getKey(formula, column, row, mFormulaKey))
+		return librevenge::RVNGString("");
+	shared_ptr<SheetFormula> const *cached=mFormulaHash.find(mFormulaKey);
+	shared_ptr<SheetFormula> converted;
+	if (cached)
+		converted=*cached;
+	else
+	{
+		converted.reset(new SheetFormula);
+		if (!converted->compile(formula, column, row))
+		{
+			ODFGEN_DEBUG_MSG(("SheetManager::convertFormula can not convert a formula!!!\n"));
+			return librevenge::RVNGString("");
+		}
+		// the formulas with absolute references are all different, so the cache must be limited
+		if (mFormulaHash.size()>=4096)
+			mFormulaHash.clear();
+		mFormulaHash.insert(mFormulaKey, converted);
+	}
+	mFormulaBuffer.clear();
+	if (!converted->write(column, row, mFormulaBuffer))
+		return librevenge::RVNGString("");
+	return librevenge::RVNGString(mFormulaBuffer.c_str());
 }
 
 librevenge::RVNGString SheetManager::convertCellRange(const librevenge::RVNGPropertyList &list)
@@ -712,6 +999,9 @@ void SheetManager::write(OdfDocumentHandler *pHandler, Style::Zone zone) const
 		if (mSheetStyles[i] && mSheetStyles[i]->getZone()==zone)
 			mSheetStyles[i]->writeStyle(pHandler, *this);
 	}
+	shared_ptr<SheetStylePool> const &sharedPool=zone==Style::Z_StyleAutomatic ? mStyleStylePool : mContentStylePool;
+	if (sharedPool)
+		sharedPool->write(pHandler, *this);
 }
 
 /* vim:set shiftwidth=4 softtabstop=4 noexpandtab: */
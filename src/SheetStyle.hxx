@@ -34,6 +34,7 @@
 #include "FilterInternal.hxx"
 
 #include "Style.hxx"
+#include "StyleHash.hxx"
 
 class OdfDocumentHandler;
 class SheetManager;
@@ -72,10 +73,40 @@ private:
 	librevenge::RVNGPropertyList mPropList;
 };
 
+/** the row and the cell styles used by a sheet or shared by all the
+	sheets of a zone */
+class SheetStylePool
+{
+public:
+	//! constructor: the style names begin with prefix
+	explicit SheetStylePool(const char *prefix);
+	//! returns the row style name corresponding to a key, creates it if needed
+	librevenge::RVNGString addRow(const librevenge::RVNGPropertyList &propList, libodfgen::StyleKey const &key);
+	//! returns the cell style name corresponding to a key, creates it if needed
+	librevenge::RVNGString addCell(const librevenge::RVNGPropertyList &propList, libodfgen::StyleKey const &key);
+	//! writes the row and the cell styles
+	void write(OdfDocumentHandler *pHandler, SheetManager const &manager) const;
+
+private:
+	//! the style name prefix
+	librevenge::RVNGString msPrefix;
+	// hash key -> row style name
+	libodfgen::StyleKeyMap<librevenge::RVNGString> mRowNameHash;
+	// style name -> SheetRowStyle
+	std::map<librevenge::RVNGString, shared_ptr<SheetRowStyle> > mRowStyleHash;
+	// hash key -> cell style name
+	libodfgen::StyleKeyMap<librevenge::RVNGString> mCellNameHash;
+	// style name -> SheetCellStyle
+	std::map<librevenge::RVNGString, shared_ptr<SheetCellStyle> > mCellStyleHash;
+};
+
 class SheetStyle : public Style
 {
 public:
-	SheetStyle(const librevenge::RVNGPropertyList &xPropList, const char *psName, Style::Zone zone);
+	/** constructor: if pool is empty, the sheet creates and writes its own
+		row and cell styles, if not, they are added in pool */
+	SheetStyle(const librevenge::RVNGPropertyList &xPropList, const char *psName, Style::Zone zone,
+	           shared_ptr<SheetStylePool> pool=shared_ptr<SheetStylePool>());
 	virtual ~SheetStyle();
 	virtual void writeStyle(OdfDocumentHandler *pHandler, SheetManager const &manager) const;
 	int getNumColumns() const
@@ -85,25 +116,92 @@ public:
 
 	librevenge::RVNGString addCell(const librevenge::RVNGPropertyList &propList);
 	librevenge::RVNGString addRow(const librevenge::RVNGPropertyList &propList);
+	//! adds the number of row and cell styles found and not found in the caches to hits and misses
+	void addCacheStatistics(unsigned long &hits, unsigned long &misses) const
+	{
+		mRowCache.addStatistics(hits, misses);
+		mCellCache.addStatistics(hits, misses);
+	}
 
 private:
 	librevenge::RVNGPropertyList mPropList;
 	librevenge::RVNGPropertyListVector const *mColumns;
 
-	// hash key -> row style name
-	std::map<librevenge::RVNGString, librevenge::RVNGString> mRowNameHash;
-	// style name -> SheetRowStyle
-	std::map<librevenge::RVNGString, shared_ptr<SheetRowStyle> > mRowStyleHash;
-	// hash key -> cell style name
-	std::map<librevenge::RVNGString, librevenge::RVNGString> mCellNameHash;
-	// style name -> SheetCellStyle
-	std::map<librevenge::RVNGString, shared_ptr<SheetCellStyle> > mCellStyleHash;
+	// the last row styles
+	libodfgen::StyleCache mRowCache;
+	// the last cell styles
+	libodfgen::StyleCache mCellCache;
+	// the key used to find a row or a cell style
+	libodfgen::StyleKey mKey;
+	// the row and the cell styles
+	shared_ptr<SheetStylePool> mPool;
+	// a flag to know if the pool is shared with other sheets
+	bool mbSharedPool;
 
 	// Disable copying
 	SheetStyle(const SheetStyle &);
 	SheetStyle &operator=(const SheetStyle &);
 };
 
+/** a formula converted in the ODF syntax.
+
+	The cell references which are not absolute are stored relatively to
+	the cell which contains the formula, so the same formula copied in
+	many cells can be converted once and written for each cell.
+ */
+class SheetFormula
+{
+public:
+	//! constructor
+	SheetFormula() : mParts()
+	{
+	}
+	/** fills key with the structure of a librevenge:formula for a cell,
+		returns false if the formula is bad */
+	static bool getKey(const librevenge::RVNGPropertyListVector &formula, int column, int row, libodfgen::StyleKey &key);
+	//! converts a librevenge:formula for a cell, returns false if the formula is bad
+	bool compile(const librevenge::RVNGPropertyListVector &formula, int column, int row);
+	//! appends the formula for a cell to res, returns false if a cell reference is bad
+	bool write(int column, int row, std::string &res) const;
+
+private:
+	//! the token types
+	enum TokenType { T_Bad, T_Operator, T_Function, T_Number, T_Text, T_Cell, T_Cells };
+	//! the coordinate types
+	enum Coordinate { C_None, C_Column, C_Row };
+	//! a part of the formula: a text followed by a coordinate
+	struct Part
+	{
+		//! constructor
+		Part() : mText(), mCoordinate(C_None), mAbsolute(false), mValue(0)
+		{
+		}
+		//! the text, already escaped
+		std::string mText;
+		//! the coordinate type
+		Coordinate mCoordinate;
+		//! a flag to know if the coordinate is absolute
+		bool mAbsolute;
+		//! the coordinate or its difference with the cell coordinate
+		int mValue;
+	};
+	//! returns the type of a token
+	static TokenType getTokenType(librevenge::RVNGPropertyList const &token);
+	//! returns true if op is an operator
+	static bool isOperator(char const *op);
+	//! appends a text in the last part
+	void appendText(char const *text);
+	//! adds a coordinate
+	void addCoordinate(bool column, bool absolute, int value, int cellValue);
+	/** adds a cell reference: the coordinate names are prefix+column, prefix+row, ...
+		defaultColumn and defaultRow are used when the coordinates are not defined */
+	bool addCellReference(librevenge::RVNGPropertyList const &token, char const *prefix, int column, int row,
+	                      librevenge::RVNGProperty const *defaultColumn=0, librevenge::RVNGProperty const *defaultRow=0);
+
+	//! the formula parts
+	std::vector<Part> mParts;
+};
+
 /** main class to create/store/write the sheet and the numbering styles */
 class SheetManager
 {
@@ -133,10 +231,18 @@ public:
 		if (!mbSheetOpened || !mSheetStyles.back()) return 0;
 		return mSheetStyles.back().get();
 	}
+	/** sets if the row and the cell styles are shared by all the sheets.
+		By default, each sheet has its own styles. */
+	void setShareStyles(bool share)
+	{
+		mbShareStyles=share;
+	}
 	//! open a sheet and update the list of elements
 	bool openSheet(const librevenge::RVNGPropertyList &xPropList, Style::Zone zone);
 	//! close the last sheet
 	bool closeSheet();
+	//! adds the number of styles found and not found in the caches of the sheets to hits and misses
+	void addCacheStatistics(unsigned long &hits, unsigned long &misses) const;
 
 	//! create a new numbering style
 	void addNumberingStyle(const librevenge::RVNGPropertyList &xPropList);
@@ -144,6 +250,9 @@ public:
 	librevenge::RVNGString getNumberingStyleName(librevenge::RVNGString const &localName) const;
 
 	static librevenge::RVNGString convertFormula(const librevenge::RVNGPropertyListVector &formatsList);
+	/** converts the formula of the cell in column, row: the conversions are
+		cached, so a formula copied in many cells is only converted once */
+	librevenge::RVNGString convertFormula(const librevenge::RVNGPropertyListVector &formula, int column, int row);
 	static librevenge::RVNGString convertCellRange(const librevenge::RVNGPropertyList &cell);
 	static librevenge::RVNGString convertCellsRange(const librevenge::RVNGPropertyList &cells);
 
@@ -152,8 +261,20 @@ private:
 	bool mbSheetOpened;
 	//! the list of style
 	std::vector<shared_ptr<SheetStyle> > mSheetStyles;
+	//! flag to know if the row and the cell styles are shared by the sheets
+	bool mbShareStyles;
+	//! the shared styles of the sheets in the content automatic styles
+	shared_ptr<SheetStylePool> mContentStylePool;
+	//! the shared styles of the sheets in the styles automatic styles
+	shared_ptr<SheetStylePool> mStyleStylePool;
 	//! style name -> NumberingStyle
 	std::map<librevenge::RVNGString, shared_ptr<SheetNumberingStyle> > mNumberingHash;
+	//! the key used to find a converted formula
+	libodfgen::StyleKey mFormulaKey;
+	//! formula structure -> converted formula
+	libodfgen::StyleKeyMap<shared_ptr<SheetFormula> > mFormulaHash;
+	//! the buffer used to write a formula
+	std::string mFormulaBuffer;
 };
 #endif
 
@@ -0,0 +1,213 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* libodfgen
+ * Version: MPL 2.0 / LGPLv2.1+
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU Lesser General Public License Version 2.1 or later
+ * (LGPLv2.1+), in which case the provisions of the LGPLv2.1+ are
+ * applicable instead of those above.
+ *
+ * For further information visit http://libwpd.sourceforge.net
+ */
+
+#include "StyleHash.hxx"
+
+namespace libodfgen
+{
+namespace
+{
+//! the markers which separate the data in a key
+enum KeyMarker { K_Integer=1, K_Property, K_Vector, K_List, K_EndList, K_String };
+}
+
+void StyleKey::append(int value)
+{
+	char buffer[1+sizeof(int)];
+	buffer[0]=char(K_Integer);
+	memcpy(buffer+1, &value, sizeof(int));
+	appendData(buffer, sizeof(buffer));
+}
+
+void StyleKey::append(char const *str)
+{
+	char const marker=char(K_String);
+	appendData(&marker, 1);
+	appendString(str ? str : "");
+}
+
+void StyleKey::append(librevenge::RVNGPropertyList const &propList, Filter filter, bool withChildren)
+{
+	librevenge::RVNGPropertyList::Iter i(propList);
+	for (i.rewind(); i.next();)
+	{
+		if (filter && !filter(i.key()))
+			continue;
+		librevenge::RVNGPropertyListVector const *child=i.child();
+		if (child)
+		{
+			if (!withChildren)
+				continue;
+			char const marker=char(K_Vector);
+			appendData(&marker, 1);
+			appendString(i.key());
+			for (unsigned long c=0; c<child->count(); ++c)
+			{
+				char const listMarker=char(K_List);
+				appendData(&listMarker, 1);
+				append((*child)[c]);
+			}
+			char const endMarker=char(K_EndList);
+			appendData(&endMarker, 1);
+			continue;
+		}
+		if (!i())
+			continue;
+		char const header[2]= {char(K_Property), char(i()->getUnit())};
+		appendData(header, 2);
+		appendString(i.key());
+		appendString(i()->getStr().cstr());
+	}
+	char const endMarker=char(K_EndList);
+	appendData(&endMarker, 1);
+}
+
+unsigned long StyleKey::getHash(char const *data, size_t size)
+{
+	// FNV-1a, followed by a final mix so that the low bits depend on all the data
+	unsigned long hash=2166136261UL;
+	for (size_t i=0; i<size; ++i)
+	{
+		hash^=(unsigned char) data[i];
+		hash*=16777619UL;
+	}
+	hash^=hash>>15;
+	hash*=0x2c1b3c6dUL;
+	hash^=hash>>12;
+	return hash;
+}
+
+namespace
+{
+//! moves the iterator to the next property which must be compared
+bool nextProperty(librevenge::RVNGPropertyList::Iter &it, StyleKey::Filter filter, bool withChildren)
+{
+	while (it.next())
+	{
+		if (filter && !filter(it.key()))
+			continue;
+		if (it.child() ? withChildren : it()!=0)
+			return true;
+	}
+	return false;
+}
+
+//! returns true if the two properties have the same unit and the same value
+bool isSameProperty(librevenge::RVNGProperty const &prop1, librevenge::RVNGProperty const &prop2)
+{
+	librevenge::RVNGUnit const unit=prop1.getUnit();
+	if (unit!=prop2.getUnit())
+		return false;
+	// a property with a unit is a double: if the values are equal, the strings are equal
+	if (unit!=librevenge::RVNG_GENERIC)
+	{
+		double const value1=prop1.getDouble(), value2=prop2.getDouble();
+		if (value1<=value2 && value1>=value2)
+			return true;
+	}
+	return prop1.getStr()==prop2.getStr();
+}
+}
+
+StyleCache::StyleCache(StyleKey::Filter filter, bool withChildren)
+	: mFilter(filter), mWithChildren(withChildren), mEntries(), mTime(0), mNumLookups(0), mNumHits(0)
+{
+}
+
+librevenge::RVNGString const *StyleCache::find(librevenge::RVNGPropertyList const &propList, int extra)
+{
+	++mNumLookups;
+	for (size_t i=0; i<mEntries.size(); ++i)
+	{
+		Entry &entry=mEntries[i];
+		if (entry.mExtra!=extra || !isEqual(entry.mList, propList))
+			continue;
+		entry.mLastUse=++mTime;
+		++mNumHits;
+		return &entry.mName;
+	}
+	return 0;
+}
+
+void StyleCache::insert(librevenge::RVNGPropertyList const &propList, int extra, librevenge::RVNGString const &name)
+{
+	size_t pos=mEntries.size();
+	if (pos<size_t(MaxEntries))
+		mEntries.resize(pos+1);
+	else
+	{
+		pos=0;
+		for (size_t i=1; i<mEntries.size(); ++i)
+		{
+			if (mEntries[i].mLastUse<mEntries[pos].mLastUse)
+				pos=i;
+		}
+	}
+	Entry &entry=mEntries[pos];
+	entry.mList=propList;
+	entry.mExtra=extra;
+	entry.mName=name;
+	entry.mLastUse=++mTime;
+}
+
+bool StyleCache::isEqual(librevenge::RVNGPropertyList const &list1, librevenge::RVNGPropertyList const &list2) const
+{
+	librevenge::RVNGPropertyList::Iter it1(list1), it2(list2);
+	it1.rewind();
+	it2.rewind();
+	while (true)
+	{
+		bool const has1=nextProperty(it1, mFilter, mWithChildren);
+		if (has1!=nextProperty(it2, mFilter, mWithChildren))
+			return false;
+		if (!has1)
+			return true;
+		if (strcmp(it1.key(), it2.key())!=0)
+			return false;
+		librevenge::RVNGPropertyListVector const *child1=it1.child();
+		librevenge::RVNGPropertyListVector const *child2=it2.child();
+		if (child1 || child2)
+		{
+			if (!child1 || !child2 || child1->count()!=child2->count())
+				return false;
+			// the child lists are compared completely, as in StyleKey::append
+			StyleCache const childCache;
+			for (unsigned long c=0; c<child1->count(); ++c)
+			{
+				if (!childCache.isEqual((*child1)[c], (*child2)[c]))
+					return false;
+			}
+			continue;
+		}
+		if (!isSameProperty(*it1(), *it2()))
+			return false;
+	}
+}
+
+bool StyleKey::isNotLibrevengeProperty(char const *name)
+{
+	return strncmp(name, "librevenge:", 11)!=0;
+}
+
+bool StyleKey::isCellStyleProperty(char const *name)
+{
+	return strncmp(name, "librevenge:", 11)!=0 || strncmp(name, "librevenge:numbering-name", 24)==0;
+}
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 noexpandtab: */
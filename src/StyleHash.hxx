@@ -0,0 +1,271 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* libodfgen
+ * Version: MPL 2.0 / LGPLv2.1+
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU Lesser General Public License Version 2.1 or later
+ * (LGPLv2.1+), in which case the provisions of the LGPLv2.1+ are
+ * applicable instead of those above.
+ *
+ * For further information visit http://libwpd.sourceforge.net
+ */
+
+#ifndef _STYLEHASH_HXX_
+#define _STYLEHASH_HXX_
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include <librevenge/librevenge.h>
+
+namespace libodfgen
+{
+/** the key used to find a style: a binary serialization of the style
+	properties (name, unit and value of each property, child vectors
+	included) and of some extra integers (the style zone, ...).
+
+	Two keys are equal if and only if the properties are the same, so the
+	key can be used as a hash key instead of RVNGPropertyList::getPropString.
+	Its buffer is reused, so a manager can keep one key and recreate it for
+	each lookup without any allocation once the buffer is large enough.
+ */
+class StyleKey
+{
+public:
+	//! a function which returns true if a property must be stored in the key
+	typedef bool (*Filter)(char const *name);
+
+	//! constructor
+	StyleKey() : mData(), mSize(0)
+	{
+	}
+	//! resets the key
+	void clear()
+	{
+		mSize=0;
+	}
+	//! appends an integer
+	void append(int value);
+	//! appends a string
+	void append(char const *str);
+	/** appends the properties of a list which are accepted by filter (all if
+		filter is null); if withChildren is false, the child vectors are ignored */
+	void append(librevenge::RVNGPropertyList const &propList, Filter filter=0, bool withChildren=true);
+	//! returns the key data
+	char const *data() const
+	{
+		return mSize ? &mData[0] : "";
+	}
+	//! returns the key data size
+	size_t size() const
+	{
+		return mSize;
+	}
+	//! returns the key hash
+	unsigned long getHash() const
+	{
+		return getHash(data(), mSize);
+	}
+	//! returns the hash of a data block
+	static unsigned long getHash(char const *data, size_t size);
+
+	//! filter which skips the librevenge: properties
+	static bool isNotLibrevengeProperty(char const *name);
+	//! filter which skips the librevenge: properties excepted librevenge:numbering-name
+	static bool isCellStyleProperty(char const *name);
+private:
+	//! appends a block of data
+	void appendData(char const *data, size_t size)
+	{
+		if (mSize+size > mData.size())
+			mData.resize(2*(mSize+size));
+		memcpy(&mData[0]+mSize, data, size);
+		mSize+=size;
+	}
+	//! appends a string and its final 0
+	void appendString(char const *str)
+	{
+		appendData(str, strlen(str)+1);
+	}
+	//! the key data
+	std::vector<char> mData;
+	//! the key size
+	size_t mSize;
+};
+
+/** a hash table which associates a value to a StyleKey.
+
+	The table uses open addressing with linear probing; the entries are
+	compared with their hash first, then with their whole key.
+ */
+template <class T> class StyleKeyMap
+{
+public:
+	//! constructor
+	StyleKeyMap() : mEntries(), mSlots(), mMask(0)
+	{
+	}
+	//! returns the value associated to a key or 0
+	T const *find(StyleKey const &key) const
+	{
+		if (mSlots.empty())
+			return 0;
+		unsigned long const hash=key.getHash();
+		for (size_t pos=size_t(hash)&mMask;; pos=(pos+1)&mMask)
+		{
+			size_t const id=mSlots[pos];
+			if (!id)
+				return 0;
+			Entry const &entry=mEntries[id-1];
+			if (entry.mHash==hash && entry.mKey.size()==key.size() &&
+			        memcmp(entry.mKey.data(), key.data(), key.size())==0)
+				return &entry.mValue;
+		}
+	}
+	//! associates a value to a key, which must not be already in the table
+	void insert(StyleKey const &key, T const &value)
+	{
+		if (2*(mEntries.size()+1) > mSlots.size())
+			resize(mSlots.empty() ? 16 : 2*mSlots.size());
+		mEntries.push_back(Entry(key.getHash(), std::string(key.data(), key.size()), value));
+		insertSlot(mEntries.size());
+	}
+	//! returns the number of values
+	size_t size() const
+	{
+		return mEntries.size();
+	}
+	//! returns true if the table is empty
+	bool empty() const
+	{
+		return mEntries.empty();
+	}
+	//! removes all the values
+	void clear()
+	{
+		mEntries.clear();
+		mSlots.clear();
+		mMask=0;
+	}
+private:
+	//! an entry of the table
+	struct Entry
+	{
+		Entry(unsigned long hash, std::string const &key, T const &value) : mHash(hash), mKey(key), mValue(value)
+		{
+		}
+		//! the key hash
+		unsigned long mHash;
+		//! the key data
+		std::string mKey;
+		//! the value
+		T mValue;
+	};
+	//! stores the entry id in the first free slot
+	void insertSlot(size_t id)
+	{
+		size_t pos=size_t(mEntries[id-1].mHash)&mMask;
+		while (mSlots[pos])
+			pos=(pos+1)&mMask;
+		mSlots[pos]=id;
+	}
+	//! changes the number of slots (a power of 2) and reinserts the entries
+	void resize(size_t numSlots)
+	{
+		mSlots.assign(numSlots, 0);
+		mMask=numSlots-1;
+		for (size_t id=1; id<=mEntries.size(); ++id)
+			insertSlot(id);
+	}
+	//! the entries
+	std::vector<Entry> mEntries;
+	//! the slots: 0 if empty or the entry id+1
+	std::vector<size_t> mSlots;
+	//! the number of slots minus 1
+	size_t mMask;
+};
+
+/** a small cache which stores the last property lists used to find a style
+	and the corresponding style names.
+
+	Documents often use the same style for many consecutive spans or cells:
+	in this case, the property list is directly compared with the cached
+	lists, which avoids creating the StyleKey and looking it up. The
+	comparison is exact: it gives the same result as comparing the keys.
+ */
+class StyleCache
+{
+public:
+	//! the maximum number of cached lists
+	enum { MaxEntries=4 };
+	//! constructor: the filter and withChildren are used as in StyleKey::append
+	explicit StyleCache(StyleKey::Filter filter=0, bool withChildren=true);
+	//! returns the style name corresponding to a list and an extra integer (the zone, ...) or 0
+	librevenge::RVNGString const *find(librevenge::RVNGPropertyList const &propList, int extra);
+	//! stores a list, replacing the least recently used list if the cache is full
+	void insert(librevenge::RVNGPropertyList const &propList, int extra, librevenge::RVNGString const &name);
+	//! removes all the lists and resets the counters
+	void clear()
+	{
+		mEntries.clear();
+		mNumLookups=mNumHits=0;
+	}
+	//! returns the number of calls to find
+	unsigned long getNumLookups() const
+	{
+		return mNumLookups;
+	}
+	//! returns the number of lists found by find
+	unsigned long getNumHits() const
+	{
+		return mNumHits;
+	}
+	//! adds the number of lists found and not found by find to hits and misses
+	void addStatistics(unsigned long &hits, unsigned long &misses) const
+	{
+		hits+=mNumHits;
+		misses+=mNumLookups-mNumHits;
+	}
+private:
+	//! returns true if the two lists are equal (the filtered properties are ignored)
+	bool isEqual(librevenge::RVNGPropertyList const &list1, librevenge::RVNGPropertyList const &list2) const;
+	//! a cached list
+	struct Entry
+	{
+		Entry() : mList(), mExtra(0), mName(), mLastUse(0)
+		{
+		}
+		//! the property list
+		librevenge::RVNGPropertyList mList;
+		//! the extra integer
+		int mExtra;
+		//! the style name
+		librevenge::RVNGString mName;
+		//! the time of the last use
+		unsigned long mLastUse;
+	};
+	//! the properties filter
+	StyleKey::Filter mFilter;
+	//! a flag to know if the child vectors are compared
+	bool mWithChildren;
+	//! the cached lists
+	std::vector<Entry> mEntries;
+	//! the current time: the number of calls to find and insert
+	unsigned long mTime;
+	//! the number of calls to find
+	unsigned long mNumLookups;
+	//! the number of lists found
+	unsigned long mNumHits;
+};
+}
+
+#endif
+/* vim:set shiftwidth=4 softtabstop=4 noexpandtab: */
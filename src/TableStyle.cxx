@@ -130,12 +130,18 @@ void TableRowStyle::write(OdfDocumentHandler *pHandler) const
 Table::Table(const librevenge::RVNGPropertyList &xPropList, const char *psName, Style::Zone zone) :
 	Style(psName, zone), mPropList(xPropList),
 	mbRowOpened(false), mbRowHeaderOpened(false), mbCellOpened(false),
-	mRowNameHash(), mRowStyleHash(), mCellNameHash(), mCellStyleHash()
+	mRowCache(libodfgen::StyleKey::isNotLibrevengeProperty, false),
+	mCellCache(libodfgen::StyleKey::isCellStyleProperty, false),
+	mKey(), mRowNameHash(), mRowStyleHash(), mCellNameHash(), mCellStyleHash()
 {
 }
 
 Table::~Table()
 {
+	if (mCellCache.getNumLookups())
+	{
+		ODFGEN_DEBUG_MSG(("Table::~Table: %lu cell styles found in the cache on %lu\n", mCellCache.getNumHits(), mCellCache.getNumLookups()));
+	}
 }
 
 int Table::getNumColumns() const
@@ -156,25 +162,22 @@ librevenge::RVNGString Table::openRow(const librevenge::RVNGPropertyList &propLi
 	mbRowOpened=true;
 	mbRowHeaderOpened=propList["librevenge:is-header-row"] &&
 	                  propList["librevenge:is-header-row"]->getInt();
-	// first remove unused data
-	librevenge::RVNGPropertyList pList;
-	librevenge::RVNGPropertyList::Iter i(propList);
-	for (i.rewind(); i.next();)
+	librevenge::RVNGString const *styleName=mRowCache.find(propList, 0);
+	if (styleName) return *styleName;
+	// the key does not contain the librevenge: data
+	mKey.clear();
+	mKey.append(propList, libodfgen::StyleKey::isNotLibrevengeProperty, false);
+	styleName=mRowNameHash.find(mKey);
+	if (styleName)
 	{
-		if (strncmp(i.key(), "librevenge:", 11)==0)
-			continue;
-		if (i.child())
-			continue;
-		pList.insert(i.key(),i()->clone());
+		mRowCache.insert(propList, 0, *styleName);
+		return *styleName;
 	}
-	librevenge::RVNGString hashKey = pList.getPropString();
-	std::map<librevenge::RVNGString, librevenge::RVNGString>::const_iterator iter =
-	    mRowNameHash.find(hashKey);
-	if (iter!=mRowNameHash.end()) return iter->second;
 
 	librevenge::RVNGString name;
 	name.sprintf("%s_row%i", getName().cstr(), (int) mRowStyleHash.size());
-	mRowNameHash[hashKey]=name;
+	mRowNameHash.insert(mKey, name);
+	mRowCache.insert(propList, 0, name);
 	mRowStyleHash[name]=shared_ptr<TableRowStyle>(new TableRowStyle(propList, name.cstr()));
 	return name;
 }
@@ -198,26 +201,22 @@ librevenge::RVNGString Table::openCell(const librevenge::RVNGPropertyList &propL
 		return "";
 	}
 	mbCellOpened=true;
-	// first remove unused data
-	librevenge::RVNGPropertyList pList;
-	librevenge::RVNGPropertyList::Iter i(propList);
-	for (i.rewind(); i.next();)
+	librevenge::RVNGString const *styleName=mCellCache.find(propList, 0);
+	if (styleName) return *styleName;
+	// the key does not contain the librevenge: data, excepted the numbering name
+	mKey.clear();
+	mKey.append(propList, libodfgen::StyleKey::isCellStyleProperty, false);
+	styleName=mCellNameHash.find(mKey);
+	if (styleName)
 	{
-		if (!strncmp(i.key(), "librevenge:", 11) &&
-		        strncmp(i.key(), "librevenge:numbering-name", 24))
-			continue;
-		if (i.child())
-			continue;
-		pList.insert(i.key(),i()->clone());
+		mCellCache.insert(propList, 0, *styleName);
+		return *styleName;
 	}
-	librevenge::RVNGString hashKey = pList.getPropString();
-	std::map<librevenge::RVNGString, librevenge::RVNGString>::const_iterator iter =
-	    mCellNameHash.find(hashKey);
-	if (iter!=mCellNameHash.end()) return iter->second;
 
 	librevenge::RVNGString name;
 	name.sprintf("%s_cell%i", getName().cstr(), (int) mCellStyleHash.size());
-	mCellNameHash[hashKey]=name;
+	mCellNameHash.insert(mKey, name);
+	mCellCache.insert(propList, 0, name);
 	mCellStyleHash[name]=shared_ptr<TableCellStyle>(new TableCellStyle(propList, name.cstr()));
 	return name;
 }
@@ -355,6 +354,15 @@ bool TableManager::closeTable()
 	return true;
 }
 
+void TableManager::addCacheStatistics(unsigned long &hits, unsigned long &misses) const
+{
+	for (size_t i=0; i < mTableStyles.size(); ++i)
+	{
+		if (mTableStyles[i])
+			mTableStyles[i]->addCacheStatistics(hits, misses);
+	}
+}
+
 void TableManager::write(OdfDocumentHandler *pHandler, Style::Zone zone, bool compatibleOdp) const
 {
 	for (size_t i=0; i < mTableStyles.size(); ++i)
@@ -35,6 +35,7 @@
 #include "FilterInternal.hxx"
 
 #include "Style.hxx"
+#include "StyleHash.hxx"
 
 class OdfDocumentHandler;
 
@@ -83,6 +84,12 @@ public:
 	{
 		return mbCellOpened;
 	}
+	//! adds the number of row and cell styles found and not found in the caches to hits and misses
+	void addCacheStatistics(unsigned long &hits, unsigned long &misses) const
+	{
+		mRowCache.addStatistics(hits, misses);
+		mCellCache.addStatistics(hits, misses);
+	}
 protected:
 	// default write function ( must not be called)
 	virtual void write(OdfDocumentHandler *) const;
@@ -90,12 +97,18 @@ private:
 	librevenge::RVNGPropertyList mPropList;
 	bool mbRowOpened, mbRowHeaderOpened, mbCellOpened;
 
+	// the last row styles
+	libodfgen::StyleCache mRowCache;
+	// the last cell styles
+	libodfgen::StyleCache mCellCache;
+	// the key used to find a row or a cell style
+	libodfgen::StyleKey mKey;
 	// hash key -> row style name
-	std::map<librevenge::RVNGString, librevenge::RVNGString> mRowNameHash;
+	libodfgen::StyleKeyMap<librevenge::RVNGString> mRowNameHash;
 	// style name -> TableRowStyle
 	std::map<librevenge::RVNGString, shared_ptr<TableRowStyle> > mRowStyleHash;
 	// hash key -> cell style name
-	std::map<librevenge::RVNGString, librevenge::RVNGString> mCellNameHash;
+	libodfgen::StyleKeyMap<librevenge::RVNGString> mCellNameHash;
 	// style name -> TableCellStyle
 	std::map<librevenge::RVNGString, shared_ptr<TableCellStyle> > mCellStyleHash;
 
@@ -137,6 +150,8 @@ public:
 	//! open a table and update the list of elements
 	bool openTable(const librevenge::RVNGPropertyList &xPropList, Style::Zone zone);
 	bool closeTable();
+	//! adds the number of styles found and not found in the caches of the tables to hits and misses
+	void addCacheStatistics(unsigned long &hits, unsigned long &misses) const;
 
 private:
 	std::vector<shared_ptr<Table> > mTableOpened;
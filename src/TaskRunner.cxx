@@ -0,0 +1,120 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* libodfgen
+ * Version: MPL 2.0 / LGPLv2.1+
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU Lesser General Public License Version 2.1 or later
+ * (LGPLv2.1+), in which case the provisions of the LGPLv2.1+ are
+ * applicable instead of those above.
+ *
+ * For further information visit http://libwpd.sourceforge.net
+ */
+
+#include "TaskRunner.hxx"
+
+#include "FilterInternal.hxx"
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+namespace libodfgen
+{
+Task::~Task()
+{
+}
+
+#ifdef HAVE_PTHREAD
+namespace
+{
+//! the list of tasks shared by the worker threads
+struct TaskQueue
+{
+	TaskQueue(std::vector<Task *> const &tasks) : mTasks(tasks), mNext(0), mMutex()
+	{
+		pthread_mutex_init(&mMutex, 0);
+	}
+	~TaskQueue()
+	{
+		pthread_mutex_destroy(&mMutex);
+	}
+	//! returns the next task to run or 0
+	Task *next()
+	{
+		Task *task=0;
+		pthread_mutex_lock(&mMutex);
+		if (mNext<mTasks.size())
+			task=mTasks[mNext++];
+		pthread_mutex_unlock(&mMutex);
+		return task;
+	}
+	std::vector<Task *> const &mTasks;
+	size_t mNext;
+	pthread_mutex_t mMutex;
+private:
+	TaskQueue(TaskQueue const &);
+	TaskQueue &operator=(TaskQueue const &);
+};
+
+extern "C" void *runTaskQueue(void *data)
+{
+	TaskQueue *queue=static_cast<TaskQueue *>(data);
+	while (Task *task=queue->next())
+		task->run();
+	return 0;
+}
+
+size_t getNumProcessors()
+{
+#ifdef _SC_NPROCESSORS_ONLN
+	long const num=sysconf(_SC_NPROCESSORS_ONLN);
+	if (num>1)
+		return size_t(num);
+#endif
+	return 1;
+}
+}
+#endif
+
+void runTasks(std::vector<Task *> const &tasks, bool inParallel)
+{
+#ifdef HAVE_PTHREAD
+	size_t numThreads=tasks.size();
+	size_t const numProcessors=getNumProcessors();
+	if (numThreads>numProcessors)
+		numThreads=numProcessors;
+	if (inParallel && numThreads>1)
+	{
+		TaskQueue queue(tasks);
+		// the calling thread is also a worker
+		std::vector<pthread_t> threads(numThreads-1);
+		size_t numCreated=0;
+		for (; numCreated<threads.size(); ++numCreated)
+		{
+			if (pthread_create(&threads[numCreated], 0, runTaskQueue, &queue)!=0)
+			{
+				ODFGEN_DEBUG_MSG(("libodfgen::runTasks: can not create a thread\n"));
+				break;
+			}
+		}
+		runTaskQueue(&queue);
+		for (size_t i=0; i<numCreated; ++i)
+			pthread_join(threads[i], 0);
+		return;
+	}
+#else
+	(void) inParallel;
+#endif
+	for (size_t i=0; i<tasks.size(); ++i)
+		tasks[i]->run();
+}
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 noexpandtab: */
@@ -0,0 +1,53 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* libodfgen
+ * Version: MPL 2.0 / LGPLv2.1+
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU Lesser General Public License Version 2.1 or later
+ * (LGPLv2.1+), in which case the provisions of the LGPLv2.1+ are
+ * applicable instead of those above.
+ *
+ * For further information visit http://libwpd.sourceforge.net
+ */
+
+#ifndef _TASKRUNNER_HXX_
+#define _TASKRUNNER_HXX_
+
+#include <vector>
+
+namespace libodfgen
+{
+/** a small independent job which can be run in a worker thread */
+class Task
+{
+public:
+	//! constructor
+	Task() {}
+	//! destructor
+	virtual ~Task();
+	//! does the job
+	virtual void run() = 0;
+private:
+	Task(Task const &);
+	Task &operator=(Task const &);
+};
+
+/** runs a list of tasks.
+
+	When the library is built with thread support and inParallel is set, the
+	tasks are distributed on a small pool of worker threads (one by processor
+	at most) and the function returns when all the tasks are finished; the
+	caller must ensure that the tasks do not share any modifiable data.
+	Otherwise, the tasks are run one after the other in the calling thread.
+ */
+void runTasks(std::vector<Task *> const &tasks, bool inParallel);
+}
+
+#endif
+/* vim:set shiftwidth=4 softtabstop=4 noexpandtab: */
@@ -163,6 +163,11 @@ void SpanStyle::write(OdfDocumentHandler *pHandler) const
 
 void ParagraphStyleManager::clean()
 {
+	if (mCache.getNumLookups())
+	{
+		ODFGEN_DEBUG_MSG(("ParagraphStyleManager::clean: %lu styles found in the cache on %lu\n", mCache.getNumHits(), mCache.getNumLookups()));
+	}
+	mCache.clear();
 	mHashNameMap.clear();
 	mStyleHash.clear();
 	mDisplayNameMap.clear();
@@ -178,41 +183,58 @@ void ParagraphStyleManager::write(OdfDocumentHandler *pHandler, Style::Zone zone
 	}
 }
 
-librevenge::RVNGString ParagraphStyleManager::findOrAdd(const librevenge::RVNGPropertyList &propList, Style::Zone zone)
+namespace
 {
-	librevenge::RVNGPropertyList pList(propList);
+//! filter used to find a paragraph style without its master page
+bool isNotMasterPageName(char const *name)
+{
+	return strcmp(name, "style:master-page-name")!=0;
+}
+}
 
+librevenge::RVNGString ParagraphStyleManager::findOrAdd(const librevenge::RVNGPropertyList &propList, Style::Zone zone)
+{
 	// first check if we need to store the style as style or as automatic style
 	bool deferMasterPageNameInsertion=false;
 	Style::Zone currentZone=zone;
 	if (propList["style:display-name"])
 	{
 		if (propList["style:master-page-name"])
-		{
 			deferMasterPageNameInsertion=true;
-			pList.remove("style:master-page-name");
-		}
 		currentZone=Style::Z_Style;
 	}
 	else if (currentZone==Style::Z_Unknown)
 		currentZone=Style::Z_ContentAutomatic;
-	pList.insert("librevenge:zone-style", int(currentZone));
+	if (!deferMasterPageNameInsertion)
+	{
+		librevenge::RVNGString const *cachedName=mCache.find(propList, int(currentZone));
+		if (cachedName)
+			return *cachedName;
+	}
+	mKey.clear();
+	mKey.append(propList, deferMasterPageNameInsertion ? isNotMasterPageName : 0);
+	mKey.append(int(currentZone));
 
 	// look if we have already create this style
-	librevenge::RVNGString hashKey = pList.getPropString();
-	std::map<librevenge::RVNGString, librevenge::RVNGString>::const_iterator iter =
-	    mHashNameMap.find(hashKey);
+	librevenge::RVNGString const *name=mHashNameMap.find(mKey);
 	librevenge::RVNGString sName("");
-	if (iter!=mHashNameMap.end())
+	if (name)
 	{
+		sName=*name;
 		if (!deferMasterPageNameInsertion)
-			return iter->second;
-		sName=iter->second;
+		{
+			mCache.insert(propList, int(currentZone), sName);
+			return sName;
+		}
 	}
 	else
 	{
-		ODFGEN_DEBUG_MSG(("ParagraphStyleManager::findOrAdd: Paragraph Hash Key: %s\n", hashKey.cstr()));
+		ODFGEN_DEBUG_MSG(("ParagraphStyleManager::findOrAdd: Paragraph Hash Key: %s\n", propList.getPropString().cstr()));
 
+		librevenge::RVNGPropertyList pList(propList);
+		if (deferMasterPageNameInsertion)
+			pList.remove("style:master-page-name");
+		pList.insert("librevenge:zone-style", int(currentZone));
 		// ok create a new style
 		if (currentZone==Style::Z_Style)
 			sName.sprintf("S_N%i", (int)mStyleHash.size());
@@ -222,26 +244,29 @@ librevenge::RVNGString ParagraphStyleManager::findOrAdd(const librevenge::RVNGPr
 			sName.sprintf("S%i", (int)mStyleHash.size());
 		if (propList["style:display-name"])
 		{
-			librevenge::RVNGString name(propList["style:display-name"]->getStr());
-			if (mDisplayNameMap.find(name) != mDisplayNameMap.end())
+			librevenge::RVNGString displayName(propList["style:display-name"]->getStr());
+			if (mDisplayNameMap.find(displayName) != mDisplayNameMap.end())
 			{
-				ODFGEN_DEBUG_MSG(("ParagraphStyleManager::findOrAdd: a paragraph with name %s already exists\n", name.cstr()));
+				ODFGEN_DEBUG_MSG(("ParagraphStyleManager::findOrAdd: a paragraph with name %s already exists\n", displayName.cstr()));
 				pList.remove("style:display-name");
 			}
 			else
-				mDisplayNameMap[name]=sName;
+				mDisplayNameMap[displayName]=sName;
 		}
 		shared_ptr<ParagraphStyle> parag(new ParagraphStyle(pList, sName, currentZone));
 		mStyleHash[sName] =parag;
-		mHashNameMap[hashKey] = sName;
+		mHashNameMap.insert(mKey, sName);
 		if (!deferMasterPageNameInsertion)
+		{
+			mCache.insert(propList, int(currentZone), sName);
 			return sName;
+		}
 	}
 
 	//
 	// we must now create the style with master-page-name attribute : let inherete from the named style
 	//
-	pList=propList;
+	librevenge::RVNGPropertyList pList(propList);
 	pList.remove("style:display-name");
 	pList.insert("style:parent-style-name", sName);
 	return findOrAdd(pList, zone);
@@ -260,6 +285,11 @@ shared_ptr<ParagraphStyle> const ParagraphStyleManager::get(const librevenge::RV
 ////////////////////////////////////////////////////////////
 void SpanStyleManager::clean()
 {
+	if (mCache.getNumLookups())
+	{
+		ODFGEN_DEBUG_MSG(("SpanStyleManager::clean: %lu styles found in the cache on %lu\n", mCache.getNumHits(), mCache.getNumLookups()));
+	}
+	mCache.clear();
 	mHashNameMap.clear();
 	mStyleHash.clear();
 	mDisplayNameMap.clear();
@@ -342,22 +372,27 @@ void SpanStyleManager::write(OdfDocumentHandler *pHandler, Style::Zone zone) con
 
 librevenge::RVNGString SpanStyleManager::findOrAdd(const librevenge::RVNGPropertyList &propList, Style::Zone zone)
 {
-	librevenge::RVNGPropertyList pList(propList);
-
 	// first check if we need to store the style as style or as automatic style
 	if (propList["style:display-name"] && !propList["style:master-page-name"])
 		zone=Style::Z_Style;
 	else if (zone==Style::Z_Unknown)
 		zone=Style::Z_ContentAutomatic;
-	pList.insert("librevenge:zone-style", int(zone));
-
-	librevenge::RVNGString hashKey = pList.getPropString();
-	std::map<librevenge::RVNGString, librevenge::RVNGString>::const_iterator iter =
-	    mHashNameMap.find(hashKey);
-	if (iter!=mHashNameMap.end()) return iter->second;
+	librevenge::RVNGString const *cachedName=mCache.find(propList, int(zone));
+	if (cachedName)
+		return *cachedName;
+	mKey.clear();
+	mKey.append(propList);
+	mKey.append(int(zone));
+
+	librevenge::RVNGString const *name=mHashNameMap.find(mKey);
+	if (name)
+	{
+		mCache.insert(propList, int(zone), *name);
+		return *name;
+	}
 
 	// ok create a new list
-	ODFGEN_DEBUG_MSG(("SpanStyleManager::findOrAdd: Span Hash Key: %s\n", hashKey.cstr()));
+	ODFGEN_DEBUG_MSG(("SpanStyleManager::findOrAdd: Span Hash Key: %s\n", propList.getPropString().cstr()));
 
 	librevenge::RVNGString sName("");
 	if (zone==Style::Z_Style)
@@ -368,7 +403,8 @@ librevenge::RVNGString SpanStyleManager::findOrAdd(const librevenge::RVNGPropert
 		sName.sprintf("Span%i", (int)mStyleHash.size());
 	shared_ptr<SpanStyle> span(new SpanStyle(sName.cstr(), propList, zone));
 	mStyleHash[sName] = span;
-	mHashNameMap[hashKey] = sName;
+	mHashNameMap.insert(mKey, sName);
+	mCache.insert(propList, int(zone), sName);
 	if (propList["style:display-name"] && !propList["style:display-name"]->getStr().empty())
 		mDisplayNameMap[propList["style:display-name"]->getStr()]=sName;
 	return sName;
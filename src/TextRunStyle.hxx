@@ -34,6 +34,7 @@
 #include "FilterInternal.hxx"
 
 #include "Style.hxx"
+#include "StyleHash.hxx"
 
 class OdfDocumentHandler;
 
@@ -61,7 +62,7 @@ private:
 class ParagraphStyleManager : public StyleManager
 {
 public:
-	ParagraphStyleManager() : mHashNameMap(), mStyleHash(), mDisplayNameMap() {}
+	ParagraphStyleManager() : mCache(), mKey(), mHashNameMap(), mStyleHash(), mDisplayNameMap() {}
 	virtual ~ParagraphStyleManager()
 	{
 		clean();
@@ -78,6 +79,11 @@ public:
 	librevenge::RVNGString getFinalDisplayName(const librevenge::RVNGString &displayName);
 
 	virtual void clean();
+	//! adds the number of styles found and not found in the cache to hits and misses
+	void addCacheStatistics(unsigned long &hits, unsigned long &misses) const
+	{
+		mCache.addStatistics(hits, misses);
+	}
 	// write all
 	virtual void write(OdfDocumentHandler *pHandler) const
 	{
@@ -89,8 +95,12 @@ public:
 	void write(OdfDocumentHandler *pHandler, Style::Zone zone) const;
 
 protected:
+	// the last styles
+	libodfgen::StyleCache mCache;
+	// the key used to find a style
+	libodfgen::StyleKey mKey;
 	// hash key -> name
-	std::map<librevenge::RVNGString, librevenge::RVNGString> mHashNameMap;
+	libodfgen::StyleKeyMap<librevenge::RVNGString> mHashNameMap;
 	// style name -> paragraph style
 	std::map<librevenge::RVNGString, shared_ptr<ParagraphStyle> > mStyleHash;
 	// display name -> style name
@@ -100,7 +110,7 @@ protected:
 class SpanStyleManager : public StyleManager
 {
 public:
-	SpanStyleManager() : mHashNameMap(), mStyleHash(), 	mDisplayNameMap() {}
+	SpanStyleManager() : mCache(), mKey(), mHashNameMap(), mStyleHash(), mDisplayNameMap() {}
 	virtual ~SpanStyleManager()
 	{
 		clean();
@@ -118,6 +128,11 @@ public:
 	librevenge::RVNGString getFinalDisplayName(const librevenge::RVNGString &displayName);
 
 	virtual void clean();
+	//! adds the number of styles found and not found in the cache to hits and misses
+	void addCacheStatistics(unsigned long &hits, unsigned long &misses) const
+	{
+		mCache.addStatistics(hits, misses);
+	}
 	// write all
 	virtual void write(OdfDocumentHandler *pHandler) const
 	{
@@ -129,8 +144,12 @@ public:
 	void write(OdfDocumentHandler *pHandler, Style::Zone zone) const;
 
 protected:
+	// the last styles
+	libodfgen::StyleCache mCache;
+	// the key used to find a style
+	libodfgen::StyleKey mKey;
 	// hash key -> style name
-	std::map<librevenge::RVNGString, librevenge::RVNGString> mHashNameMap;
+	libodfgen::StyleKeyMap<librevenge::RVNGString> mHashNameMap;
 	// style name -> SpanStyle
 	std::map<librevenge::RVNGString, shared_ptr<SpanStyle> > mStyleHash;
 	// display name -> style name
@@ -0,0 +1,216 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* libodfgen
+ * Version: MPL 2.0 / LGPLv2.1+
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU Lesser General Public License Version 2.1 or later
+ * (LGPLv2.1+), in which case the provisions of the LGPLv2.1+ are
+ * applicable instead of those above.
+ *
+ * For further information visit http://libwpd.sourceforge.net
+ */
+
+#include <string.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "XMLChecker.hxx"
+
+namespace
+{
+bool isSpace(char c)
+{
+	return c==' ' || c=='\t' || c=='\n' || c=='\r';
+}
+
+bool isNameChar(char c)
+{
+	return (c>='a' && c<='z') || (c>='A' && c<='Z') || (c>='0' && c<='9') ||
+	       c==':' || c=='_' || c=='-' || c=='.' || (unsigned char) c>=0x80;
+}
+
+//! reads a name and updates pos, returns false if there is no name
+bool readName(char const *&pos, char const *end, std::string &name)
+{
+	char const *start=pos;
+	while (pos<end && isNameChar(*pos))
+		++pos;
+	name.assign(start, size_t(pos-start));
+	return pos!=start;
+}
+
+void skipSpaces(char const *&pos, char const *end)
+{
+	while (pos<end && isSpace(*pos))
+		++pos;
+}
+
+//! checks an entity or a character reference beginning at pos and updates pos
+bool readReference(char const *&pos, char const *end)
+{
+	static char const *entities[]= {"&amp;", "&lt;", "&gt;", "&quot;", "&apos;"};
+	for (size_t i=0; i<sizeof(entities)/sizeof(entities[0]); ++i)
+	{
+		size_t const len=strlen(entities[i]);
+		if (size_t(end-pos)>=len && strncmp(pos, entities[i], len)==0)
+		{
+			pos+=len;
+			return true;
+		}
+	}
+	if (end-pos<4 || pos[1]!='#')
+		return false;
+	char const *digit=pos+2;
+	bool const hexa=*digit=='x';
+	if (hexa) ++digit;
+	char const *start=digit;
+	while (digit<end && ((*digit>='0' && *digit<='9') || (hexa && ((*digit>='a' && *digit<='f') || (*digit>='A' && *digit<='F')))))
+		++digit;
+	if (digit==start || digit==end || *digit!=';')
+		return false;
+	pos=digit+1;
+	return true;
+}
+
+//! checks a text or an attribute value which ends with delimiter
+bool readText(char const *&pos, char const *end, char delimiter)
+{
+	while (pos<end && *pos!=delimiter)
+	{
+		if (*pos=='<')
+			return false;
+		if (*pos=='&')
+		{
+			if (!readReference(pos, end))
+				return false;
+			continue;
+		}
+		++pos;
+	}
+	return true;
+}
+
+//! checks the content of a start tag after its name and updates pos after the tag
+bool readAttributes(char const *&pos, char const *end, bool &isEmpty)
+{
+	std::set<std::string> names;
+	while (true)
+	{
+		bool const hasSpace=pos<end && isSpace(*pos);
+		skipSpaces(pos, end);
+		if (pos==end)
+			return false;
+		if (*pos=='>')
+		{
+			++pos;
+			isEmpty=false;
+			return true;
+		}
+		if (*pos=='/')
+		{
+			if (end-pos<2 || pos[1]!='>')
+				return false;
+			pos+=2;
+			isEmpty=true;
+			return true;
+		}
+		std::string name;
+		if (!hasSpace || !readName(pos, end, name) || !names.insert(name).second)
+			return false;
+		skipSpaces(pos, end);
+		if (pos==end || *pos!='=')
+			return false;
+		++pos;
+		skipSpaces(pos, end);
+		if (pos==end || (*pos!='"' && *pos!='\''))
+			return false;
+		char const quote=*(pos++);
+		if (!readText(pos, end, quote) || pos==end)
+			return false;
+		++pos;
+	}
+}
+
+//! skips a comment or a processing instruction beginning at pos
+bool skipSpecial(char const *&pos, char const *end, char const *begin, char const *finish)
+{
+	size_t const beginLen=strlen(begin), finishLen=strlen(finish);
+	if (size_t(end-pos)<beginLen || strncmp(pos, begin, beginLen)!=0)
+		return false;
+	for (char const *p=pos+beginLen; size_t(end-p)>=finishLen; ++p)
+	{
+		if (strncmp(p, finish, finishLen)==0)
+		{
+			pos=p+finishLen;
+			return true;
+		}
+	}
+	return false;
+}
+}
+
+bool isWellFormedXML(char const *data, size_t size)
+{
+	if (!data) return false;
+	char const *pos=data, *end=data+size;
+	std::vector<std::string> openedTags;
+	bool rootSeen=false;
+	while (pos<end)
+	{
+		if (*pos!='<')
+		{
+			if (openedTags.empty())
+			{
+				// only spaces are accepted outside the root element
+				if (!isSpace(*pos))
+					return false;
+				++pos;
+				continue;
+			}
+			if (!readText(pos, end, '<'))
+				return false;
+			continue;
+		}
+		if (skipSpecial(pos, end, "<?", "?>") || skipSpecial(pos, end, "<!--", "-->"))
+			continue;
+		std::string name;
+		if (end-pos>=2 && pos[1]=='/')
+		{
+			pos+=2;
+			if (!readName(pos, end, name) || openedTags.empty() || openedTags.back()!=name)
+				return false;
+			openedTags.pop_back();
+			skipSpaces(pos, end);
+			if (pos==end || *pos!='>')
+				return false;
+			++pos;
+			continue;
+		}
+		++pos;
+		if (!readName(pos, end, name))
+			return false;
+		if (openedTags.empty())
+		{
+			// there must be only one root element
+			if (rootSeen)
+				return false;
+			rootSeen=true;
+		}
+		bool isEmpty;
+		if (!readAttributes(pos, end, isEmpty))
+			return false;
+		if (!isEmpty)
+			openedTags.push_back(name);
+	}
+	return rootSeen && openedTags.empty();
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 noexpandtab: */
@@ -0,0 +1,31 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* libodfgen
+ * Version: MPL 2.0 / LGPLv2.1+
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU Lesser General Public License Version 2.1 or later
+ * (LGPLv2.1+), in which case the provisions of the LGPLv2.1+ are
+ * applicable instead of those above.
+ *
+ * For further information visit http://libwpd.sourceforge.net
+ */
+
+#ifndef _XML_CHECKER_H
+#define _XML_CHECKER_H
+
+#include <stddef.h>
+
+/** returns true if data is a well-formed XML document: the tags are
+	balanced, the attribute values are quoted and unique, and the
+	characters < and & only appear as markup or as references */
+bool isWellFormedXML(char const *data, size_t size);
+
+#endif
+
+/* vim:set shiftwidth=4 softtabstop=4 noexpandtab: */
@@ -0,0 +1,388 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* libodfgen
+ * Version: MPL 2.0 / LGPLv2.1+
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU Lesser General Public License Version 2.1 or later
+ * (LGPLv2.1+), in which case the provisions of the LGPLv2.1+ are
+ * applicable instead of those above.
+ *
+ * For further information visit http://libwpd.sourceforge.net
+ */
+
+/* benchmark: creates a spreadsheet with OdsGenerator and reports the time,
+   the memory and the number of allocations used to create and write it
+
+   usage: benchSheet1 [-r rows] [-c columns] [-s sheets] [-t string%] [-f formula%]
+                      [-y number of cell styles] [-h null|xml|string] [-i interning length]
+                      [-p] [-g]
+     -p: spills the closed sheets in a temporary file
+     -g: shares the cell and row styles between the sheets
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <new>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#include <sys/time.h>
+#endif
+
+#include <librevenge/librevenge.h>
+#include <libodfgen/libodfgen.hxx>
+
+#include "StringDocumentHandler.hxx"
+
+#if __cplusplus >= 201103L
+#define BENCH_THROW_BAD_ALLOC
+#define BENCH_NO_THROW noexcept
+#else
+#define BENCH_THROW_BAD_ALLOC throw(std::bad_alloc)
+#define BENCH_NO_THROW throw()
+#endif
+
+// the allocation counters: the library uses the operators defined here
+static unsigned long s_numAllocations=0;
+static unsigned long s_allocatedSize=0;
+
+static void *countedAlloc(std::size_t size)
+{
+	++s_numAllocations;
+	s_allocatedSize+=(unsigned long) size;
+	void *res=malloc(size ? size : 1);
+	if (!res)
+		throw std::bad_alloc();
+	return res;
+}
+
+void *operator new(std::size_t size) BENCH_THROW_BAD_ALLOC
+{
+	return countedAlloc(size);
+}
+
+void *operator new[](std::size_t size) BENCH_THROW_BAD_ALLOC
+{
+	return countedAlloc(size);
+}
+
+void operator delete(void *ptr) BENCH_NO_THROW
+{
+	free(ptr);
+}
+
+void operator delete[](void *ptr) BENCH_NO_THROW
+{
+	free(ptr);
+}
+
+#if defined(__cpp_sized_deallocation)
+void operator delete(void *ptr, std::size_t) BENCH_NO_THROW
+{
+	free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) BENCH_NO_THROW
+{
+	free(ptr);
+}
+#endif
+
+/** a handler which ignores the document: used to measure the library
+	without the XML serialization */
+class NullHandler : public OdfFastDocumentHandler
+{
+public:
+	using OdfFastDocumentHandler::startElement;
+	using OdfFastDocumentHandler::characters;
+
+	NullHandler() : m_numEvents(0)
+	{
+	}
+	unsigned long getNumEvents() const
+	{
+		return m_numEvents;
+	}
+	void startDocument() {}
+	void endDocument() {}
+	void startElement(const char *, const OdfAttribute *, unsigned long)
+	{
+		++m_numEvents;
+	}
+	void endElement(const char *)
+	{
+		++m_numEvents;
+	}
+	void characters(const char *, unsigned long)
+	{
+		++m_numEvents;
+	}
+private:
+	unsigned long m_numEvents;
+};
+
+//! the benchmark parameters
+struct Parameters
+{
+	Parameters() : m_numRows(10000), m_numColumns(20), m_numSheets(1), m_stringPercent(20), m_formulaPercent(10),
+		m_numStyles(4), m_handler("xml"), m_interningLength(0), m_spill(false), m_shareStyles(false)
+	{
+	}
+	bool read(int argc, char *argv[]);
+
+	int m_numRows;
+	int m_numColumns;
+	int m_numSheets;
+	int m_stringPercent;
+	int m_formulaPercent;
+	int m_numStyles;
+	char const *m_handler;
+	int m_interningLength;
+	bool m_spill;
+	bool m_shareStyles;
+};
+
+bool Parameters::read(int argc, char *argv[])
+{
+	for (int i=1; i<argc; ++i)
+	{
+		char const *arg=argv[i];
+		if (arg[0]!='-' || !arg[1] || arg[2])
+			return false;
+		if (arg[1]=='p')
+		{
+			m_spill=true;
+			continue;
+		}
+		if (arg[1]=='g')
+		{
+			m_shareStyles=true;
+			continue;
+		}
+		if (++i>=argc)
+			return false;
+		char const *value=argv[i];
+		switch (arg[1])
+		{
+		case 'r':
+			m_numRows=atoi(value);
+			break;
+		case 'c':
+			m_numColumns=atoi(value);
+			break;
+		case 's':
+			m_numSheets=atoi(value);
+			break;
+		case 't':
+			m_stringPercent=atoi(value);
+			break;
+		case 'f':
+			m_formulaPercent=atoi(value);
+			break;
+		case 'y':
+			m_numStyles=atoi(value);
+			break;
+		case 'h':
+			m_handler=value;
+			break;
+		case 'i':
+			m_interningLength=atoi(value);
+			break;
+		default:
+			return false;
+		}
+	}
+	return m_numRows>0 && m_numColumns>0 && m_numSheets>0 && m_numStyles>0 &&
+	       (!strcmp(m_handler, "null") || !strcmp(m_handler, "xml") || !strcmp(m_handler, "string"));
+}
+
+//! returns the wall time in seconds
+static double getTime()
+{
+#ifndef _WIN32
+	timeval tv;
+	gettimeofday(&tv, 0);
+	return double(tv.tv_sec)+1e-6*double(tv.tv_usec);
+#else
+	return double(clock())/CLOCKS_PER_SEC;
+#endif
+}
+
+//! returns the peak resident memory in kilobytes (or 0 if it is unknown)
+static long getPeakMemory()
+{
+#ifndef _WIN32
+	rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage)!=0)
+		return 0;
+#ifdef __APPLE__
+	return long(usage.ru_maxrss/1024);
+#else
+	return long(usage.ru_maxrss);
+#endif
+#else
+	return 0;
+#endif
+}
+
+//! the time and the allocations of a phase
+struct Phase
+{
+	Phase() : m_time(getTime()), m_numAllocations(s_numAllocations), m_allocatedSize(s_allocatedSize)
+	{
+	}
+	void print(char const *name) const
+	{
+		printf("%-12s %10.3f s %12lu allocations %14lu bytes\n", name, getTime()-m_time,
+		       s_numAllocations-m_numAllocations, s_allocatedSize-m_allocatedSize);
+	}
+	double m_time;
+	unsigned long m_numAllocations;
+	unsigned long m_allocatedSize;
+};
+
+//! a small deterministic random generator, so that all the runs create the same document
+static unsigned nextRandom(unsigned &seed)
+{
+	seed=seed*1103515245u+12345u;
+	return (seed>>16)&0x7fff;
+}
+
+static void createSheets(OdsGenerator &generator, Parameters const &param)
+{
+	static char const *const categories[]= {"North", "South", "East", "West", "Undefined region"};
+	unsigned seed=1;
+	for (int s=0; s<param.m_numSheets; ++s)
+	{
+		librevenge::RVNGPropertyList list;
+		librevenge::RVNGString name;
+		name.sprintf("Data %d", s+1);
+		list.insert("librevenge:sheet-name", name);
+		generator.openSheet(list);
+		for (int r=0; r<param.m_numRows; ++r)
+		{
+			list.clear();
+			list.insert("librevenge:row", r);
+			generator.openSheetRow(list);
+			for (int c=0; c<param.m_numColumns; ++c)
+			{
+				librevenge::RVNGPropertyList cell;
+				cell.insert("librevenge:column", c);
+				int const style=int(nextRandom(seed)%unsigned(param.m_numStyles));
+				if (style)
+				{
+					librevenge::RVNGString color;
+					color.sprintf("#%02x%02x%02x", (style*37)&0xff, (style*91)&0xff, (style*53)&0xff);
+					cell.insert("fo:background-color", color);
+				}
+				int const type=int(nextRandom(seed)%100);
+				bool isString=false;
+				if (type<param.m_formulaPercent && c>0)
+				{
+					// =<left cell>*2
+					librevenge::RVNGPropertyListVector formula;
+					librevenge::RVNGPropertyList token;
+					token.insert("librevenge:type", "librevenge-cell");
+					token.insert("librevenge:column", c-1);
+					token.insert("librevenge:row", r);
+					formula.append(token);
+					token.clear();
+					token.insert("librevenge:type", "librevenge-operator");
+					token.insert("librevenge:operator", "*");
+					formula.append(token);
+					token.clear();
+					token.insert("librevenge:type", "librevenge-number");
+					token.insert("librevenge:number", 2.0, librevenge::RVNG_GENERIC);
+					formula.append(token);
+					cell.insert("librevenge:formula", formula);
+				}
+				else if (type<param.m_formulaPercent+param.m_stringPercent)
+				{
+					cell.insert("librevenge:value-type", "string");
+					isString=true;
+				}
+				else
+				{
+					cell.insert("librevenge:value-type", "float");
+					// decimal amounts or computed ratios: neither are exactly representable
+					double const value=double(nextRandom(seed)*32768+nextRandom(seed));
+					cell.insert("librevenge:value", (type&1) ? value/100. : value/7., librevenge::RVNG_GENERIC);
+				}
+				generator.openSheetCell(cell);
+				if (isString)
+				{
+					generator.openParagraph(librevenge::RVNGPropertyList());
+					generator.insertText(categories[nextRandom(seed)%5]);
+					generator.closeParagraph();
+				}
+				generator.closeSheetCell();
+			}
+			generator.closeSheetRow();
+		}
+		generator.closeSheet();
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	Parameters param;
+	if (!param.read(argc, argv))
+	{
+		fprintf(stderr, "usage: benchSheet1 [-r rows] [-c columns] [-s sheets] [-t string%%] [-f formula%%]\n"
+		        "                   [-y number of cell styles] [-h null|xml|string] [-i interning length] [-p] [-g]\n");
+		return 1;
+	}
+	printf("%d sheet(s) of %d x %d cells, %d%% strings, %d%% formulas, %d cell styles, %s handler\n",
+	       param.m_numSheets, param.m_numRows, param.m_numColumns, param.m_stringPercent, param.m_formulaPercent,
+	       param.m_numStyles, param.m_handler);
+
+	NullHandler nullHandler;
+	OdfXMLWriter xmlHandler;
+	StringDocumentHandler stringHandler;
+	OdfDocumentHandler *handler=&xmlHandler;
+	if (!strcmp(param.m_handler, "null"))
+		handler=&nullHandler;
+	else if (!strcmp(param.m_handler, "string"))
+		handler=&stringHandler;
+
+	Phase total;
+	double numCells=double(param.m_numSheets)*double(param.m_numRows)*double(param.m_numColumns);
+	{
+		OdsGenerator generator;
+		generator.addDocumentHandler(handler, ODF_FLAT_XML);
+		generator.setSheetSpilling(param.m_spill);
+		generator.setSheetStyleSharing(param.m_shareStyles);
+		generator.setTextInterning(unsigned(param.m_interningLength));
+
+		Phase creation;
+		generator.startDocument(librevenge::RVNGPropertyList());
+		createSheets(generator, param);
+		creation.print("generation");
+
+		// the documents are written in endDocument
+		Phase writing;
+		generator.endDocument();
+		writing.print("writing");
+	}
+	total.print("total");
+	double const time=getTime()-total.m_time;
+	if (time>0)
+		printf("%.0f cells/s\n", numCells/time);
+	long const peak=getPeakMemory();
+	if (peak)
+		printf("peak memory: %ld kB\n", peak);
+	if (handler==&xmlHandler)
+		printf("output: %lu bytes\n", xmlHandler.getDataSize());
+	return 0;
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 noexpandtab: */
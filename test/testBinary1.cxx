@@ -0,0 +1,200 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* libodfgen
+ * Version: MPL 2.0 / LGPLv2.1+
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU Lesser General Public License Version 2.1 or later
+ * (LGPLv2.1+), in which case the provisions of the LGPLv2.1+ are
+ * applicable instead of those above.
+ *
+ * For further information visit http://libwpd.sourceforge.net
+ */
+
+#include <string.h>
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+
+#include <librevenge/librevenge.h>
+#include <libodfgen/libodfgen.hxx>
+
+#include "StringDocumentHandler.hxx"
+
+static librevenge::RVNGBinaryData createData(unsigned long size, unsigned seed)
+{
+	std::vector<unsigned char> buffer(size+1);
+	for (unsigned long i=0; i<size; ++i)
+		buffer[i]=(unsigned char)((i*37+i/7+seed)&0xff);
+	return librevenge::RVNGBinaryData(&buffer[0], size);
+}
+
+static int countOccurrences(char const *str, char const *what)
+{
+	int res=0;
+	size_t const len=strlen(what);
+	for (char const *pos=strstr(str, what); pos; pos=strstr(pos+len, what))
+		++res;
+	return res;
+}
+
+static void openFrame(OdtGenerator &generator, double y, librevenge::RVNGBinaryData const *bitmap)
+{
+	librevenge::RVNGPropertyList frame;
+	frame.insert("svg:x", 0.5, librevenge::RVNG_INCH);
+	frame.insert("svg:y", y, librevenge::RVNG_INCH);
+	frame.insert("svg:width", 1, librevenge::RVNG_INCH);
+	frame.insert("svg:height", 1, librevenge::RVNG_INCH);
+	frame.insert("text:anchor-type", "page");
+	frame.insert("text:anchor-page-number", 1);
+	if (bitmap)
+	{
+		frame.insert("draw:fill", "bitmap");
+		frame.insert("draw:fill-image", *bitmap);
+		frame.insert("librevenge:mime-type", "image/png");
+	}
+	generator.openFrame(frame);
+}
+
+static int numObjectConversions=0;
+
+//! a small object handler which writes the size of the data
+static bool convertObject(const librevenge::RVNGBinaryData &data, OdfDocumentHandler *pHandler, const OdfStreamType)
+{
+	++numObjectConversions;
+	librevenge::RVNGString text;
+	text.sprintf("object of size %lu", data.size());
+	pHandler->startElement("office:document", librevenge::RVNGPropertyList());
+	pHandler->characters(text);
+	pHandler->endElement("office:document");
+	return true;
+}
+
+//! inserts the objects A B A A and returns true if the expected content and statistics are found
+static bool createObjects(unsigned cacheSize, int expectedConversions, unsigned long expectedHits)
+{
+	StringDocumentHandler content;
+	OdtGenerator generator;
+	generator.addDocumentHandler(&content, ODF_FLAT_XML);
+	generator.registerEmbeddedObjectHandler("application/x-test", &convertObject);
+	generator.setEmbeddedObjectCacheSize(cacheSize);
+	numObjectConversions=0;
+
+	generator.startDocument(librevenge::RVNGPropertyList());
+	librevenge::RVNGPropertyList page;
+	page.insert("librevenge:num-pages", 1);
+	generator.openPageSpan(page);
+	unsigned long const sizes[]= { 100, 200, 100, 100 };
+	for (size_t i=0; i<4; ++i)
+	{
+		openFrame(generator, 0.5+double(i), 0);
+		librevenge::RVNGPropertyList object;
+		object.insert("librevenge:mime-type", "application/x-test");
+		object.insert("office:binary-data", createData(sizes[i], 300));
+		generator.insertBinaryObject(object);
+		generator.closeFrame();
+	}
+	generator.closePageSpan();
+	generator.endDocument();
+
+	unsigned long hits, misses;
+	generator.getEmbeddedObjectCacheStatistics(hits, misses);
+	return numObjectConversions==expectedConversions && hits==expectedHits &&
+	       (cacheSize==0 || hits+misses==4) &&
+	       countOccurrences(content.cstr(), "<draw:object><office:document>object of size 100</office:document></draw:object>")==3 &&
+	       countOccurrences(content.cstr(), "<draw:object><office:document>object of size 200</office:document></draw:object>")==1;
+}
+
+int main()
+{
+	StringDocumentHandler content;
+	OdtGenerator generator;
+	generator.addDocumentHandler(&content, ODF_FLAT_XML);
+
+	// the sizes check the padding and the data which are encoded by several blocks
+	unsigned long const sizes[]= { 1, 2, 3, 12288, 12289, 30000 };
+	size_t const numSizes=sizeof(sizes)/sizeof(sizes[0]);
+	std::vector<librevenge::RVNGBinaryData> images;
+	for (size_t i=0; i<numSizes; ++i)
+		images.push_back(createData(sizes[i], unsigned(i)));
+	librevenge::RVNGBinaryData const font=createData(20000, 100);
+	librevenge::RVNGBinaryData const bitmap=createData(5000, 200);
+
+	generator.startDocument(librevenge::RVNGPropertyList());
+	librevenge::RVNGPropertyList fontList;
+	fontList.insert("librevenge:name", "EmbeddedFont");
+	fontList.insert("librevenge:mime-type", "application/x-font-ttf");
+	fontList.insert("office:binary-data", font);
+	generator.defineEmbeddedFont(fontList);
+	// a second font with the same data: the data are shared, but written twice
+	fontList.insert("librevenge:name", "SameFont");
+	generator.defineEmbeddedFont(fontList);
+
+	librevenge::RVNGPropertyList page;
+	page.insert("librevenge:num-pages", 1);
+	generator.openPageSpan(page);
+	for (size_t i=0; i<numSizes; ++i)
+	{
+		openFrame(generator, 0.5+double(i), 0);
+		librevenge::RVNGPropertyList image;
+		image.insert("librevenge:mime-type", "image/png");
+		image.insert("office:binary-data", images[i]);
+		generator.insertBinaryObject(image);
+		generator.closeFrame();
+	}
+	// the same bitmap used twice must be stored once
+	for (int i=0; i<2; ++i)
+	{
+		openFrame(generator, 7+double(i), &bitmap);
+		generator.openTextBox(librevenge::RVNGPropertyList());
+		generator.closeTextBox();
+		generator.closeFrame();
+	}
+	generator.closePageSpan();
+	generator.endDocument();
+
+	std::ofstream file("testBinary1.odt");
+	file << content.cstr();
+
+	if (countOccurrences(content.cstr(), "<office:binary-data>")!=int(numSizes)+3)
+	{
+		std::cerr << "testBinary1: unexpected number of binary data\n";
+		return 1;
+	}
+	for (size_t i=0; i<numSizes; ++i)
+	{
+		std::string const expected=std::string(">")+images[i].getBase64Data().cstr()+"</office:binary-data";
+		if (countOccurrences(content.cstr(), expected.c_str())!=1)
+		{
+			std::cerr << "testBinary1: the image " << i << " is badly encoded\n";
+			return 1;
+		}
+	}
+	std::string expected=std::string(">")+font.getBase64Data().cstr()+"</office:binary-data";
+	if (countOccurrences(content.cstr(), expected.c_str())!=2)
+	{
+		std::cerr << "testBinary1: the font is badly encoded\n";
+		return 1;
+	}
+	expected=std::string(">")+bitmap.getBase64Data().cstr()+"</office:binary-data";
+	if (countOccurrences(content.cstr(), expected.c_str())!=1)
+	{
+		std::cerr << "testBinary1: the bitmap is badly encoded\n";
+		return 1;
+	}
+	// the repeated objects are converted once, unless the cache is too small or disabled
+	if (!createObjects(16, 2, 2) || !createObjects(1, 3, 1) || !createObjects(0, 4, 0))
+	{
+		std::cerr << "testBinary1: the embedded objects are badly cached\n";
+		return 1;
+	}
+	return 0;
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 noexpandtab: */
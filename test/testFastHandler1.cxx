@@ -0,0 +1,157 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* libodfgen
+ * Version: MPL 2.0 / LGPLv2.1+
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU Lesser General Public License Version 2.1 or later
+ * (LGPLv2.1+), in which case the provisions of the LGPLv2.1+ are
+ * applicable instead of those above.
+ *
+ * For further information visit http://libwpd.sourceforge.net
+ */
+
+#include <string.h>
+
+#include <iostream>
+#include <fstream>
+#include <string>
+
+#include <librevenge/librevenge.h>
+#include <libodfgen/libodfgen.hxx>
+
+#include "StringDocumentHandler.hxx"
+
+/** a handler which writes the xml using the fast path: it must produce
+	the same output as StringDocumentHandler */
+class FastStringHandler : public OdfFastDocumentHandler
+{
+public:
+	using OdfFastDocumentHandler::startElement;
+	using OdfFastDocumentHandler::characters;
+
+	FastStringHandler() : m_data("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"), m_isTagOpened(false), m_openedTagName(), m_numFastCalls(0)
+	{
+	}
+	char const *cstr() const
+	{
+		return m_data.c_str();
+	}
+	int getNumFastCalls() const
+	{
+		return m_numFastCalls;
+	}
+
+	void startDocument() {}
+	void endDocument()
+	{
+		closeTag();
+	}
+	void startElement(const char *psName, const OdfAttribute *pAttributes, unsigned long numAttributes)
+	{
+		++m_numFastCalls;
+		closeTag();
+		m_data.append("<");
+		m_data.append(psName);
+		for (unsigned long i=0; i<numAttributes; ++i)
+		{
+			if (!strncmp(pAttributes[i].name, "librevenge:", 11)) continue;
+			m_data.append(" ");
+			m_data.append(pAttributes[i].name);
+			m_data.append("=\"");
+			m_data.append(pAttributes[i].value, pAttributes[i].length);
+			m_data.append("\"");
+		}
+		m_isTagOpened=true;
+		m_openedTagName=psName;
+	}
+	void endElement(const char *psName)
+	{
+		if (m_isTagOpened && m_openedTagName==psName)
+		{
+			m_data.append("/>");
+			m_isTagOpened=false;
+			return;
+		}
+		closeTag();
+		m_data.append("</");
+		m_data.append(psName);
+		m_data.append(">");
+	}
+	void characters(const char *psCharacters, unsigned long length)
+	{
+		++m_numFastCalls;
+		closeTag();
+		librevenge::RVNGString escaped;
+		escaped.appendEscapedXML(std::string(psCharacters, length).c_str());
+		m_data.append(escaped.cstr());
+	}
+private:
+	void closeTag()
+	{
+		if (!m_isTagOpened) return;
+		m_data.append(">");
+		m_isTagOpened=false;
+	}
+	std::string m_data;
+	bool m_isTagOpened;
+	std::string m_openedTagName;
+	int m_numFastCalls;
+};
+
+static void createDocument(OdfDocumentHandler &handler)
+{
+	OdtGenerator generator;
+	generator.addDocumentHandler(&handler, ODF_FLAT_XML);
+
+	generator.startDocument(librevenge::RVNGPropertyList());
+	librevenge::RVNGPropertyList page;
+	page.insert("librevenge:num-pages", 1);
+	page.insert("fo:page-height", 11.5, librevenge::RVNG_INCH);
+	page.insert("fo:page-width", 9, librevenge::RVNG_INCH);
+	generator.openPageSpan(page);
+
+	librevenge::RVNGPropertyList para, span;
+	para.insert("fo:text-align","center");
+	span.insert("style:font-name","Courier");
+	span.insert("fo:font-size", 13, librevenge::RVNG_POINT);
+	for (int i=0; i<3; ++i)
+	{
+		generator.openParagraph(para);
+		generator.openSpan(span);
+		generator.insertText("a <fast> & \"short\" text");
+		generator.closeSpan();
+		generator.closeParagraph();
+	}
+
+	generator.closePageSpan();
+	generator.endDocument();
+}
+
+int main()
+{
+	StringDocumentHandler reference;
+	createDocument(reference);
+	FastStringHandler fast;
+	createDocument(fast);
+	std::ofstream file("testFastHandler1.odt");
+	file << fast.cstr();
+	if (strcmp(reference.cstr(), fast.cstr())!=0)
+	{
+		std::cerr << "testFastHandler1: the fast handler output differs\n";
+		return 1;
+	}
+	if (fast.getNumFastCalls()==0)
+	{
+		std::cerr << "testFastHandler1: the fast path is not used\n";
+		return 1;
+	}
+	return 0;
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 noexpandtab: */
@@ -0,0 +1,486 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* libodfgen
+ * Version: MPL 2.0 / LGPLv2.1+
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU Lesser General Public License Version 2.1 or later
+ * (LGPLv2.1+), in which case the provisions of the LGPLv2.1+ are
+ * applicable instead of those above.
+ *
+ * For further information visit http://libwpd.sourceforge.net
+ */
+
+#include <string.h>
+
+#include <iostream>
+#include <fstream>
+#include <set>
+#include <string>
+
+#include <librevenge/librevenge.h>
+#include <libodfgen/libodfgen.hxx>
+
+#include "StringDocumentHandler.hxx"
+#include "XMLChecker.hxx"
+
+static void createText(OdtGenerator &generator)
+{
+	generator.startDocument(librevenge::RVNGPropertyList());
+	librevenge::RVNGPropertyList page;
+	page.insert("librevenge:num-pages", 1);
+	page.insert("fo:page-height", 11.5, librevenge::RVNG_INCH);
+	page.insert("fo:page-width", 9, librevenge::RVNG_INCH);
+	generator.openPageSpan(page);
+
+	librevenge::RVNGPropertyList para, span;
+	para.insert("fo:text-align","center");
+	// the font name and the text contain characters which must be escaped
+	span.insert("style:font-name","Courier & <Co>");
+	span.insert("fo:font-size", 13, librevenge::RVNG_POINT);
+	for (int i=0; i<2000; ++i)
+	{
+		generator.openParagraph(para);
+		generator.openSpan(span);
+		librevenge::RVNGString text;
+		text.sprintf("paragraph %d: a <text> & a \"text\" which is compressed in the package", i);
+		generator.insertText(text);
+		generator.closeSpan();
+		generator.closeParagraph();
+	}
+
+	generator.closePageSpan();
+	generator.endDocument();
+}
+
+//
+// a small deflate decoder used to check the compressed files
+//
+
+//! the state of the decoder
+struct InflateState
+{
+	InflateState(unsigned char const *data, size_t size) : mpData(data), mSize(size), mPos(0), mBitBuffer(0), mBitCount(0), mOutput(), mbError(false) {}
+	//! the compressed data
+	unsigned char const *mpData;
+	//! the compressed size
+	size_t mSize;
+	//! the position of the next byte
+	size_t mPos;
+	//! the bits read and not used
+	unsigned long mBitBuffer;
+	//! the number of bits in mBitBuffer
+	int mBitCount;
+	//! the decompressed data
+	std::string mOutput;
+	//! a flag to know if the data are bad
+	bool mbError;
+};
+
+//! a canonical Huffman code
+struct Huffman
+{
+	//! the number of codes of each length
+	short mCount[16];
+	//! the symbols ordered by code
+	short mSymbol[288];
+};
+
+static unsigned getBits(InflateState &state, int numBits)
+{
+	while (state.mBitCount<numBits)
+	{
+		if (state.mPos>=state.mSize)
+		{
+			state.mbError=true;
+			return 0;
+		}
+		state.mBitBuffer|=(unsigned long)(state.mpData[state.mPos++])<<state.mBitCount;
+		state.mBitCount+=8;
+	}
+	unsigned const res=unsigned(state.mBitBuffer&((1UL<<numBits)-1));
+	state.mBitBuffer>>=numBits;
+	state.mBitCount-=numBits;
+	return res;
+}
+
+static void buildHuffman(Huffman &huffman, short const *lengths, int numSymbols)
+{
+	short offsets[16];
+	for (int len=0; len<16; ++len)
+		huffman.mCount[len]=0;
+	for (int s=0; s<numSymbols; ++s)
+		++huffman.mCount[lengths[s]];
+	huffman.mCount[0]=0;
+	offsets[1]=0;
+	for (int len=1; len<15; ++len)
+		offsets[len+1]=short(offsets[len]+huffman.mCount[len]);
+	for (int s=0; s<numSymbols; ++s)
+	{
+		if (lengths[s])
+			huffman.mSymbol[offsets[lengths[s]]++]=short(s);
+	}
+}
+
+static int decodeSymbol(InflateState &state, Huffman const &huffman)
+{
+	int code=0, first=0, index=0;
+	for (int len=1; len<16; ++len)
+	{
+		code|=int(getBits(state, 1));
+		int const count=huffman.mCount[len];
+		if (code-count<first)
+			return huffman.mSymbol[index+(code-first)];
+		index+=count;
+		first=(first+count)<<1;
+		code<<=1;
+	}
+	state.mbError=true;
+	return -1;
+}
+
+static bool decodeCodes(InflateState &state, Huffman const &lengthCode, Huffman const &distanceCode)
+{
+	static short const lengthBase[29]= {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+	static short const lengthExtra[29]= {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+	static short const distanceBase[30]= {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+	static short const distanceExtra[30]= {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+	while (!state.mbError)
+	{
+		int symbol=decodeSymbol(state, lengthCode);
+		if (symbol<0 || symbol>285)
+			return false;
+		if (symbol<256)
+		{
+			state.mOutput+=char(symbol);
+			continue;
+		}
+		if (symbol==256)
+			return true;
+		symbol-=257;
+		size_t const length=size_t(lengthBase[symbol])+getBits(state, lengthExtra[symbol]);
+		symbol=decodeSymbol(state, distanceCode);
+		if (symbol<0 || symbol>29)
+			return false;
+		size_t const distance=size_t(distanceBase[symbol])+getBits(state, distanceExtra[symbol]);
+		if (distance>state.mOutput.size())
+			return false;
+		for (size_t i=0; i<length; ++i)
+			state.mOutput+=state.mOutput[state.mOutput.size()-distance];
+	}
+	return false;
+}
+
+static bool decodeDynamicBlock(InflateState &state, Huffman &lengthCode, Huffman &distanceCode)
+{
+	static short const order[19]= {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+	int const numLengths=int(getBits(state, 5))+257;
+	int const numDistances=int(getBits(state, 5))+1;
+	int const numCodes=int(getBits(state, 4))+4;
+	short lengths[320];
+	for (int i=0; i<19; ++i)
+		lengths[order[i]]=i<numCodes ? short(getBits(state, 3)) : short(0);
+	buildHuffman(lengthCode, lengths, 19);
+	int index=0;
+	while (index<numLengths+numDistances && !state.mbError)
+	{
+		int symbol=decodeSymbol(state, lengthCode);
+		if (symbol<0)
+			return false;
+		if (symbol<16)
+		{
+			lengths[index++]=short(symbol);
+			continue;
+		}
+		short length=0;
+		int repeat;
+		if (symbol==16)
+		{
+			if (index==0)
+				return false;
+			length=lengths[index-1];
+			repeat=3+int(getBits(state, 2));
+		}
+		else if (symbol==17)
+			repeat=3+int(getBits(state, 3));
+		else
+			repeat=11+int(getBits(state, 7));
+		if (index+repeat>numLengths+numDistances)
+			return false;
+		while (repeat--)
+			lengths[index++]=length;
+	}
+	buildHuffman(lengthCode, lengths, numLengths);
+	buildHuffman(distanceCode, lengths+numLengths, numDistances);
+	return !state.mbError;
+}
+
+//! decompresses raw deflate data
+static bool inflate(unsigned char const *data, size_t size, std::string &output)
+{
+	InflateState state(data, size);
+	Huffman lengthCode, distanceCode;
+	bool last=false;
+	while (!last)
+	{
+		last=getBits(state, 1)!=0;
+		unsigned const type=getBits(state, 2);
+		if (state.mbError)
+			return false;
+		if (type==0)
+		{
+			// a stored block starts on a byte boundary
+			state.mBitBuffer=0;
+			state.mBitCount=0;
+			if (state.mPos+4>state.mSize)
+				return false;
+			size_t const length=size_t(state.mpData[state.mPos])|(size_t(state.mpData[state.mPos+1])<<8);
+			state.mPos+=4;
+			if (state.mPos+length>state.mSize)
+				return false;
+			state.mOutput.append(reinterpret_cast<char const *>(state.mpData+state.mPos), length);
+			state.mPos+=length;
+			continue;
+		}
+		if (type==1)
+		{
+			short lengths[288];
+			for (int i=0; i<288; ++i)
+				lengths[i]=short(i<144 ? 8 : i<256 ? 9 : i<280 ? 7 : 8);
+			buildHuffman(lengthCode, lengths, 288);
+			for (int i=0; i<30; ++i)
+				lengths[i]=5;
+			buildHuffman(distanceCode, lengths, 30);
+		}
+		else if (type!=2 || !decodeDynamicBlock(state, lengthCode, distanceCode))
+			return false;
+		if (!decodeCodes(state, lengthCode, distanceCode))
+			return false;
+	}
+	output=state.mOutput;
+	return true;
+}
+
+static unsigned long computeCRC32(std::string const &data)
+{
+	unsigned long crc=0xffffffffUL;
+	for (size_t i=0; i<data.size(); ++i)
+	{
+		crc^=(unsigned char) data[i];
+		for (int b=0; b<8; ++b)
+			crc=(crc>>1)^((crc&1) ? 0xedb88320UL : 0);
+	}
+	return crc^0xffffffffUL;
+}
+
+static unsigned long readUInt(std::string const &data, size_t pos, int numBytes)
+{
+	unsigned long res=0;
+	for (int i=numBytes-1; i>=0; --i)
+		res=(res<<8)|(unsigned char) data[pos+size_t(i)];
+	return res;
+}
+
+/** checks the zip signatures, that the first file is the uncompressed
+	mimetype, and that the XML files can be decompressed and are well-formed */
+static bool checkPackage(std::string const &data, char const *mimeType)
+{
+	if (data.size()<60 || data.compare(0, 4, "PK\3\4")!=0 || data.compare(30, 8, "mimetype")!=0 ||
+	        data.compare(38, strlen(mimeType), mimeType)!=0)
+		return false;
+	// the end of central directory record
+	size_t const endPos=data.size()-22;
+	if (data.compare(endPos, 4, "PK\5\6")!=0)
+		return false;
+	unsigned long const numEntries=readUInt(data, endPos+10, 2);
+	size_t pos=size_t(readUInt(data, endPos+16, 4));
+	std::set<std::string> xmlFiles;
+	for (unsigned long e=0; e<numEntries; ++e)
+	{
+		if (pos+46>endPos || data.compare(pos, 4, "PK\1\2")!=0)
+			return false;
+		unsigned long const method=readUInt(data, pos+10, 2), crc=readUInt(data, pos+16, 4);
+		size_t const compressedSize=size_t(readUInt(data, pos+20, 4)), size=size_t(readUInt(data, pos+24, 4));
+		size_t const nameLength=size_t(readUInt(data, pos+28, 2));
+		size_t const localPos=size_t(readUInt(data, pos+42, 4));
+		std::string const name=data.substr(pos+46, nameLength);
+		pos+=46+nameLength+size_t(readUInt(data, pos+30, 2))+size_t(readUInt(data, pos+32, 2));
+		if (localPos+30>endPos || data.compare(localPos, 4, "PK\3\4")!=0)
+			return false;
+		size_t const dataPos=localPos+30+size_t(readUInt(data, localPos+26, 2))+size_t(readUInt(data, localPos+28, 2));
+		if (dataPos+compressedSize>endPos)
+			return false;
+		if (name.size()<4 || name.compare(name.size()-4, 4, ".xml")!=0)
+			continue;
+		std::string content;
+		if (method==0)
+			content=data.substr(dataPos, compressedSize);
+		else if (method!=8 || !inflate(reinterpret_cast<unsigned char const *>(data.c_str()+dataPos), compressedSize, content))
+			return false;
+		if (content.size()!=size || computeCRC32(content)!=crc || !isWellFormedXML(content.c_str(), content.size()))
+		{
+			std::cerr << "testPackage1: the file " << name << " is bad\n";
+			return false;
+		}
+		xmlFiles.insert(name);
+	}
+	static char const *expected[]= {"content.xml", "styles.xml", "meta.xml", "settings.xml", "META-INF/manifest.xml"};
+	for (size_t i=0; i<sizeof(expected)/sizeof(expected[0]); ++i)
+	{
+		if (xmlFiles.find(expected[i])==xmlFiles.end())
+			return false;
+	}
+	return true;
+}
+
+static bool appendData(const char *data, unsigned long size, void *userData)
+{
+	static_cast<std::string *>(userData)->append(data, size);
+	return true;
+}
+
+static librevenge::RVNGBinaryData createPicture(unsigned seed)
+{
+	unsigned char buffer[300];
+	for (unsigned i=0; i<sizeof(buffer); ++i)
+		buffer[i]=(unsigned char)((i*seed+7)&0xff);
+	return librevenge::RVNGBinaryData(buffer, sizeof(buffer));
+}
+
+static void createPictures(OdtGenerator &generator, librevenge::RVNGBinaryData const &png, librevenge::RVNGBinaryData const &jpeg)
+{
+	generator.setExternalPictures(true);
+	generator.startDocument(librevenge::RVNGPropertyList());
+	librevenge::RVNGPropertyList page;
+	page.insert("librevenge:num-pages", 1);
+	generator.openPageSpan(page);
+	// the png picture is inserted twice, but must be stored once
+	for (int i=0; i<3; ++i)
+	{
+		librevenge::RVNGPropertyList frame;
+		frame.insert("svg:x", 1, librevenge::RVNG_INCH);
+		frame.insert("svg:y", 1+2*i, librevenge::RVNG_INCH);
+		frame.insert("svg:width", 1, librevenge::RVNG_INCH);
+		frame.insert("svg:height", 1, librevenge::RVNG_INCH);
+		frame.insert("text:anchor-type", "page");
+		frame.insert("text:anchor-page-number", 1);
+		generator.openFrame(frame);
+		librevenge::RVNGPropertyList image;
+		image.insert("librevenge:mime-type", i==1 ? "image/jpeg" : "image/png");
+		image.insert("office:binary-data", i==1 ? jpeg : png);
+		generator.insertBinaryObject(image);
+		generator.closeFrame();
+	}
+	generator.closePageSpan();
+	generator.endDocument();
+}
+
+static bool testPictures()
+{
+	librevenge::RVNGBinaryData const png=createPicture(3), jpeg=createPicture(5);
+	StringDocumentHandler content, manifest;
+	OdtGenerator generator;
+	generator.addDocumentHandler(&content, ODF_CONTENT_XML);
+	generator.addDocumentHandler(&manifest, ODF_MANIFEST_XML);
+	createPictures(generator, png, jpeg);
+	librevenge::RVNGStringVector const names=generator.getPictureNames();
+	if (names.size()!=2 || strstr(content.cstr(), "office:binary-data"))
+		return false;
+	for (unsigned i=0; i<names.size(); ++i)
+	{
+		librevenge::RVNGBinaryData data;
+		librevenge::RVNGString mimeType;
+		if (!generator.getPictureContent(names[i], data, mimeType))
+			return false;
+		bool const isPng=mimeType=="image/png";
+		librevenge::RVNGBinaryData const &expected=isPng ? png : jpeg;
+		if (data.size()!=expected.size() || memcmp(data.getDataBuffer(), expected.getDataBuffer(), data.size())!=0 ||
+		        strncmp(names[i].cstr(), "Pictures/", 9)!=0 || !strstr(names[i].cstr(), isPng ? ".png" : ".jpg"))
+			return false;
+		std::string const href=std::string("xlink:href=\"")+names[i].cstr()+"\"";
+		std::string const entry=std::string("manifest:full-path=\"")+names[i].cstr()+"\"";
+		if (!strstr(content.cstr(), href.c_str()) || !strstr(manifest.cstr(), entry.c_str()))
+			return false;
+	}
+	std::ofstream file("testPackage1-pictures.xml");
+	file << content.cstr();
+
+	// in a package, the pictures are stored without compression
+	OdfPackageWriter package;
+	OdtGenerator packageGenerator;
+	packageGenerator.setPackageWriter(&package);
+	createPictures(packageGenerator, png, jpeg);
+	std::string const data(package.getData(), package.getDataSize());
+	if (!checkPackage(data, "application/vnd.oasis.opendocument.text") ||
+	        data.find(std::string(reinterpret_cast<char const *>(png.getDataBuffer()), png.size()))==std::string::npos ||
+	        data.find(names[0].cstr())==std::string::npos)
+		return false;
+	return true;
+}
+
+static bool testTooManyFiles()
+{
+	// a zip file without the zip64 extensions can not contain more than 65535 files
+	OdfPackageWriter package;
+	unsigned char const data[]= {'x'};
+	for (int i=0; i<65536; ++i)
+	{
+		librevenge::RVNGString name;
+		name.sprintf("f%d", i);
+		if (!package.addFile(name.cstr(), data, 1, false))
+			return false;
+	}
+	// the directory must not be written
+	size_t const size=package.getDataSize();
+	return !package.close() && package.hasError() && package.getDataSize()==size;
+}
+
+int main()
+{
+	OdfPackageWriter memoryPackage;
+	OdtGenerator memoryGenerator;
+	memoryGenerator.setPackageWriter(&memoryPackage);
+	createText(memoryGenerator);
+	std::string const memory(memoryPackage.getData(), memoryPackage.getDataSize());
+	if (!checkPackage(memory, "application/vnd.oasis.opendocument.text"))
+	{
+		std::cerr << "testPackage1: the package is bad\n";
+		return 1;
+	}
+	std::ofstream file("testPackage1.odt", std::ios::binary);
+	file.write(memory.c_str(), std::streamsize(memory.size()));
+
+	// the same package with a spooled content
+	std::string streamed;
+	OdfPackageWriter streamedPackage(appendData, &streamed);
+	OdtGenerator streamedGenerator;
+	streamedGenerator.setPackageWriter(&streamedPackage);
+	streamedGenerator.setContentStreaming(true);
+	createText(streamedGenerator);
+	if (!checkPackage(streamed, "application/vnd.oasis.opendocument.text") || streamedPackage.hasError() || streamed!=memory)
+	{
+		std::cerr << "testPackage1: the streamed package is bad\n";
+		return 1;
+	}
+	std::ofstream streamedFile("testPackage1-streamed.odt", std::ios::binary);
+	streamedFile.write(streamed.c_str(), std::streamsize(streamed.size()));
+
+	if (!testPictures())
+	{
+		std::cerr << "testPackage1: the pictures are not stored in separate files\n";
+		return 1;
+	}
+	if (!testTooManyFiles())
+	{
+		std::cerr << "testPackage1: the number of files is not checked\n";
+		return 1;
+	}
+	return 0;
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 noexpandtab: */
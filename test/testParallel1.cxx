@@ -0,0 +1,185 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* libodfgen
+ * Version: MPL 2.0 / LGPLv2.1+
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU Lesser General Public License Version 2.1 or later
+ * (LGPLv2.1+), in which case the provisions of the LGPLv2.1+ are
+ * applicable instead of those above.
+ *
+ * For further information visit http://libwpd.sourceforge.net
+ */
+
+#include <string.h>
+
+#include <iostream>
+#include <fstream>
+#include <string>
+
+#include <librevenge/librevenge.h>
+#include <libodfgen/libodfgen.hxx>
+
+#include "StringDocumentHandler.hxx"
+
+static void createText(OdtGenerator &generator)
+{
+	librevenge::RVNGPropertyList meta;
+	meta.insert("dc:creator", "testParallel1");
+	generator.setDocumentMetaData(meta);
+	generator.startDocument(librevenge::RVNGPropertyList());
+	librevenge::RVNGPropertyList page;
+	page.insert("librevenge:num-pages", 1);
+	page.insert("fo:page-height", 11.5, librevenge::RVNG_INCH);
+	page.insert("fo:page-width", 9, librevenge::RVNG_INCH);
+	generator.openPageSpan(page);
+
+	librevenge::RVNGPropertyList para, span;
+	para.insert("fo:text-align","center");
+	for (int i=0; i<500; ++i)
+	{
+		span.insert("fo:font-size", 10+(i%8), librevenge::RVNG_POINT);
+		generator.openParagraph(para);
+		generator.openSpan(span);
+		librevenge::RVNGString text;
+		text.sprintf("paragraph %d", i);
+		generator.insertText(text);
+		generator.closeSpan();
+		generator.closeParagraph();
+	}
+
+	generator.closePageSpan();
+	generator.endDocument();
+}
+
+static bool compareHandlers()
+{
+	static OdfStreamType const types[]= {ODF_CONTENT_XML, ODF_STYLES_XML, ODF_META_XML, ODF_SETTINGS_XML, ODF_MANIFEST_XML};
+	static int const numTypes=int(sizeof(types)/sizeof(types[0]));
+	StringDocumentHandler sequential[numTypes], parallel[numTypes];
+	OdtGenerator sequentialGenerator, parallelGenerator;
+	parallelGenerator.setParallelWriting(true);
+	for (int i=0; i<numTypes; ++i)
+	{
+		sequentialGenerator.addDocumentHandler(&sequential[i], types[i]);
+		parallelGenerator.addDocumentHandler(&parallel[i], types[i]);
+	}
+	createText(sequentialGenerator);
+	createText(parallelGenerator);
+	for (int i=0; i<numTypes; ++i)
+	{
+		if (strcmp(sequential[i].cstr(), parallel[i].cstr())!=0)
+			return false;
+	}
+	std::ofstream file("testParallel1-content.xml");
+	file << parallel[0].cstr();
+	return true;
+}
+
+//! a reentrant image handler: reverses the bytes, fails if the first byte is 0
+static bool convertImage(const librevenge::RVNGBinaryData &input, librevenge::RVNGBinaryData &output)
+{
+	unsigned char const *data=input.getDataBuffer();
+	if (!data || data[0]==0)
+		return false;
+	for (unsigned long i=input.size(); i>0; --i)
+		output.append(data[i-1]);
+	return true;
+}
+
+static void createImages(OdtGenerator &generator)
+{
+	generator.registerEmbeddedImageHandler("image/x-test", &convertImage);
+	generator.startDocument(librevenge::RVNGPropertyList());
+	librevenge::RVNGPropertyList page;
+	page.insert("librevenge:num-pages", 1);
+	generator.openPageSpan(page);
+	for (int i=0; i<20; ++i)
+	{
+		librevenge::RVNGPropertyList frame;
+		frame.insert("svg:x", 1, librevenge::RVNG_INCH);
+		frame.insert("svg:y", 0.5*i, librevenge::RVNG_INCH);
+		frame.insert("svg:width", 1, librevenge::RVNG_INCH);
+		frame.insert("svg:height", 0.5, librevenge::RVNG_INCH);
+		frame.insert("text:anchor-type", "page");
+		frame.insert("text:anchor-page-number", 1);
+		generator.openFrame(frame);
+		unsigned char buffer[1000];
+		for (unsigned j=0; j<sizeof(buffer); ++j)
+			buffer[j]=(unsigned char)((j*(unsigned(i)+1)+1)&0xff);
+		// the images whose conversion fails are not written
+		if (i%5==0)
+			buffer[0]=0;
+		librevenge::RVNGPropertyList image;
+		image.insert("librevenge:mime-type", "image/x-test");
+		image.insert("office:binary-data", librevenge::RVNGBinaryData(buffer, sizeof(buffer)));
+		generator.insertBinaryObject(image);
+		generator.closeFrame();
+	}
+	generator.closePageSpan();
+	generator.endDocument();
+}
+
+static bool compareImageConversions()
+{
+	StringDocumentHandler sequential, asynchronous;
+	OdtGenerator sequentialGenerator, asynchronousGenerator;
+	sequentialGenerator.addDocumentHandler(&sequential, ODF_FLAT_XML);
+	asynchronousGenerator.addDocumentHandler(&asynchronous, ODF_FLAT_XML);
+	asynchronousGenerator.setAsynchronousImageConversion(true);
+	createImages(sequentialGenerator);
+	createImages(asynchronousGenerator);
+	if (strcmp(sequential.cstr(), asynchronous.cstr())!=0)
+		return false;
+	// 16 of the 20 conversions succeed
+	int numImages=0;
+	for (char const *pos=strstr(asynchronous.cstr(), "<draw:image>"); pos; pos=strstr(pos+1, "<draw:image>"))
+		++numImages;
+	std::ofstream file("testParallel1-images.fodt");
+	file << asynchronous.cstr();
+	return numImages==16;
+}
+
+static bool createPackage()
+{
+	OdfPackageWriter package;
+	OdtGenerator generator;
+	generator.setPackageWriter(&package);
+	generator.setParallelWriting(true);
+	createText(generator);
+	std::string const data(package.getData(), package.getDataSize());
+	// the mimetype must be the first file and the package must be closed
+	if (data.size()<60 || data.compare(0, 4, "PK\3\4")!=0 || data.compare(30, 8, "mimetype")!=0 ||
+	        data.compare(data.size()-22, 4, "PK\5\6")!=0 || package.hasError())
+		return false;
+	std::ofstream file("testParallel1.odt", std::ios::binary);
+	file.write(data.c_str(), std::streamsize(data.size()));
+	return true;
+}
+
+int main()
+{
+	if (!compareHandlers())
+	{
+		std::cerr << "testParallel1: the files written in parallel differ\n";
+		return 1;
+	}
+	if (!compareImageConversions())
+	{
+		std::cerr << "testParallel1: the images converted asynchronously differ\n";
+		return 1;
+	}
+	if (!createPackage())
+	{
+		std::cerr << "testParallel1: the package written in parallel is bad\n";
+		return 1;
+	}
+	return 0;
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 noexpandtab: */
@@ -0,0 +1,570 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* libodfgen
+ * Version: MPL 2.0 / LGPLv2.1+
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU Lesser General Public License Version 2.1 or later
+ * (LGPLv2.1+), in which case the provisions of the LGPLv2.1+ are
+ * applicable instead of those above.
+ *
+ * For further information visit http://libwpd.sourceforge.net
+ */
+
+#include <string.h>
+
+#include <iostream>
+#include <fstream>
+
+#include <librevenge/librevenge.h>
+#include <libodfgen/libodfgen.hxx>
+
+#include "StringDocumentHandler.hxx"
+
+static void addRow(OdsGenerator &generator, int row, bool withFormula)
+{
+	librevenge::RVNGPropertyList list;
+	list.insert("librevenge:row", row);
+	list.insert("style:row-height", 20, librevenge::RVNG_POINT);
+	generator.openSheetRow(list);
+	for (int c = 0; c < 4; ++c)
+	{
+		librevenge::RVNGPropertyList cell;
+		cell.insert("librevenge:column", c);
+		cell.insert("librevenge:row", row);
+		cell.insert("fo:background-color", "#ff0000");
+		cell.insert("librevenge:value-type", "float");
+		cell.insert("librevenge:value", c<3 ? 1. : 2., librevenge::RVNG_GENERIC);
+		if (withFormula)
+		{
+			librevenge::RVNGPropertyListVector formula;
+			librevenge::RVNGPropertyList instr;
+			instr.insert("librevenge:type", "librevenge-number");
+			instr.insert("librevenge:number", 1., librevenge::RVNG_GENERIC);
+			formula.append(instr);
+			cell.insert("librevenge:formula", formula);
+		}
+		generator.openSheetCell(cell);
+		generator.closeSheetCell();
+	}
+	generator.closeSheetRow();
+}
+
+static bool testRepeated()
+{
+	StringDocumentHandler content;
+	OdsGenerator generator;
+	generator.addDocumentHandler(&content, ODF_FLAT_XML);
+
+	generator.startDocument(librevenge::RVNGPropertyList());
+	librevenge::RVNGPropertyList list;
+	list.insert("librevenge:sheet-name", "Repeated");
+	generator.openSheet(list);
+	// three identical rows, then two rows with formula which must not be merged
+	for (int r = 0; r < 3; ++r)
+		addRow(generator, r, false);
+	for (int r = 3; r < 5; ++r)
+		addRow(generator, r, true);
+	generator.closeSheet();
+	generator.endDocument();
+
+	std::ofstream file("testSheet1.ods");
+	file << content.cstr();
+
+	char const *res=content.cstr();
+	if (!strstr(res, "table:number-rows-repeated=\"3\"") || !strstr(res, "table:number-columns-repeated=\"3\""))
+	{
+		std::cerr << "testSheet1: can not find the repeated rows or cells\n";
+		return false;
+	}
+	if (strstr(res, "table:number-rows-repeated=\"2\"") || strstr(res, "table:number-columns-repeated=\"2\""))
+	{
+		std::cerr << "testSheet1: the cells with formula are merged\n";
+		return false;
+	}
+	// only the first row and the first cell styles are not found in the caches
+	unsigned long hits, misses;
+	generator.getStyleCacheStatistics(hits, misses);
+	if (hits!=4+19 || misses!=2)
+	{
+		std::cerr << "testSheet1: unexpected style cache statistics " << hits << "/" << misses << "\n";
+		return false;
+	}
+	return true;
+}
+
+static double const blockFloats[]= {1, 2.5, 2.5, 0.1};
+static bool const blockBooleans[]= {true, false, false, true};
+static int const blockDays[]= {1, 2, 2, 28};
+static char const *const blockDates[]= {"2015-02-01", "2015-02-02", "2015-02-02", "2015-02-28"};
+static char const *const blockStrings[]= {"first", 0, "third", "last"};
+
+static void createBlock(OdsGenerator &generator, bool useBlock, bool withStrings)
+{
+	generator.startDocument(librevenge::RVNGPropertyList());
+	librevenge::RVNGPropertyList list;
+	list.insert("librevenge:sheet-name", "Block");
+	generator.openSheet(list);
+	librevenge::RVNGPropertyList rowList, cellList;
+	rowList.insert("librevenge:row", 2);
+	rowList.insert("style:row-height", 20, librevenge::RVNG_POINT);
+	cellList.insert("librevenge:column", 1);
+	cellList.insert("fo:background-color", "#00ff00");
+	if (useBlock)
+	{
+		OdsCellBlock block(4);
+		block.addFloatColumn(blockFloats);
+		block.addEmptyColumn();
+		block.addBooleanColumn(blockBooleans);
+		block.addDateColumn(blockDates);
+		if (withStrings)
+			block.addStringColumn(blockStrings);
+		generator.insertSheetCellBlock(rowList, cellList, block);
+	}
+	else
+	{
+		for (int r = 0; r < 4; ++r)
+		{
+			rowList.insert("librevenge:row", 2+r);
+			generator.openSheetRow(rowList);
+			for (int c = 0; c < 4; ++c)
+			{
+				librevenge::RVNGPropertyList cell(cellList);
+				cell.insert("librevenge:column", 1+c);
+				if (c==0)
+				{
+					cell.insert("librevenge:value-type", "float");
+					cell.insert("librevenge:value", blockFloats[r], librevenge::RVNG_GENERIC);
+				}
+				else if (c==2)
+				{
+					cell.insert("librevenge:value-type", "boolean");
+					cell.insert("librevenge:value", blockBooleans[r]);
+				}
+				else if (c==3)
+				{
+					cell.insert("librevenge:value-type", "date");
+					cell.insert("librevenge:year", 2015);
+					cell.insert("librevenge:month", 2);
+					cell.insert("librevenge:day", blockDays[r]);
+				}
+				generator.openSheetCell(cell);
+				generator.closeSheetCell();
+			}
+			generator.closeSheetRow();
+		}
+	}
+	generator.closeSheet();
+	generator.endDocument();
+}
+
+static bool testBlock()
+{
+	StringDocumentHandler cellContent, blockContent, stringContent;
+	{
+		OdsGenerator generator;
+		generator.addDocumentHandler(&cellContent, ODF_FLAT_XML);
+		createBlock(generator, false, false);
+	}
+	{
+		OdsGenerator generator;
+		generator.addDocumentHandler(&blockContent, ODF_FLAT_XML);
+		createBlock(generator, true, false);
+	}
+	if (strcmp(cellContent.cstr(), blockContent.cstr())!=0)
+	{
+		std::cerr << "testSheet1: the block differs from the cells\n";
+		return false;
+	}
+	{
+		OdsGenerator generator;
+		generator.addDocumentHandler(&stringContent, ODF_FLAT_XML);
+		createBlock(generator, true, true);
+	}
+	std::ofstream file("testSheet1-block.ods");
+	file << stringContent.cstr();
+	if (!strstr(stringContent.cstr(), "<text:p>third</text:p>") ||
+	        !strstr(stringContent.cstr(), "<text:p>last</text:p>"))
+	{
+		std::cerr << "testSheet1: can not find the block strings\n";
+		return false;
+	}
+	return true;
+}
+
+static void createSheets(StringDocumentHandler &content, bool spill)
+{
+	OdsGenerator generator;
+	generator.addDocumentHandler(&content, ODF_FLAT_XML);
+	generator.setSheetSpilling(spill);
+	generator.startDocument(librevenge::RVNGPropertyList());
+	for (int s = 0; s < 3; ++s)
+	{
+		librevenge::RVNGPropertyList list;
+		librevenge::RVNGString name;
+		name.sprintf("Sheet %d", s+1);
+		list.insert("librevenge:sheet-name", name);
+		generator.openSheet(list);
+		for (int r = 0; r < 50; ++r)
+		{
+			list.clear();
+			generator.openSheetRow(list);
+			for (int c = 0; c < 10; ++c)
+			{
+				librevenge::RVNGPropertyList cell;
+				cell.insert("librevenge:column", c);
+				cell.insert("librevenge:value-type", "float");
+				cell.insert("librevenge:value", double(100*s+10*r+c), librevenge::RVNG_GENERIC);
+				generator.openSheetCell(cell);
+				generator.closeSheetCell();
+			}
+			generator.closeSheetRow();
+		}
+		generator.closeSheet();
+	}
+	generator.endDocument();
+}
+
+static bool testSpilling()
+{
+	StringDocumentHandler content, spilledContent;
+	createSheets(content, false);
+	createSheets(spilledContent, true);
+	if (strcmp(content.cstr(), spilledContent.cstr())!=0 || !strstr(content.cstr(), "Sheet 3"))
+	{
+		std::cerr << "testSheet1: the spilled sheets differ\n";
+		return false;
+	}
+	return true;
+}
+
+static void addToken(librevenge::RVNGPropertyListVector &formula, char const *type, char const *key, char const *value)
+{
+	librevenge::RVNGPropertyList token;
+	token.insert("librevenge:type", type);
+	token.insert(key, value);
+	formula.append(token);
+}
+
+static bool testFormula()
+{
+	StringDocumentHandler content;
+	OdsGenerator generator;
+	generator.addDocumentHandler(&content, ODF_FLAT_XML);
+	generator.startDocument(librevenge::RVNGPropertyList());
+	librevenge::RVNGPropertyList list;
+	list.insert("librevenge:sheet-name", "Formula");
+	generator.openSheet(list);
+	// the same formula is copied in each row: =A1+$B$1*SUM(A1:B1)&"a<b"
+	for (int r = 0; r < 30; ++r)
+	{
+		list.clear();
+		list.insert("librevenge:row", r);
+		generator.openSheetRow(list);
+		librevenge::RVNGPropertyListVector formula;
+		librevenge::RVNGPropertyList token;
+		token.insert("librevenge:type", "librevenge-cell");
+		token.insert("librevenge:column", 0);
+		token.insert("librevenge:row", r);
+		formula.append(token);
+		addToken(formula, "librevenge-operator", "librevenge:operator", "+");
+		token.insert("librevenge:column", 1);
+		token.insert("librevenge:row", 0);
+		token.insert("librevenge:column-absolute", true);
+		token.insert("librevenge:row-absolute", true);
+		formula.append(token);
+		addToken(formula, "librevenge-operator", "librevenge:operator", "*");
+		addToken(formula, "librevenge-function", "librevenge:function", "SUM");
+		addToken(formula, "librevenge-operator", "librevenge:operator", "(");
+		token.clear();
+		token.insert("librevenge:type", "librevenge-cells");
+		token.insert("librevenge:start-column", 0);
+		token.insert("librevenge:start-row", r);
+		token.insert("librevenge:end-column", 1);
+		formula.append(token);
+		addToken(formula, "librevenge-operator", "librevenge:operator", ")");
+		addToken(formula, "librevenge-operator", "librevenge:operator", "&");
+		addToken(formula, "librevenge-text", "librevenge:text", "a<b");
+		librevenge::RVNGPropertyList cell;
+		cell.insert("librevenge:column", 30);
+		cell.insert("librevenge:row", r);
+		cell.insert("librevenge:formula", formula);
+		generator.openSheetCell(cell);
+		generator.closeSheetCell();
+		generator.closeSheetRow();
+	}
+	generator.closeSheet();
+	generator.endDocument();
+
+	std::ofstream file("testSheet1-formula.ods");
+	file << content.cstr();
+	char const *res=content.cstr();
+	if (!strstr(res, "table:formula=\"of:=[.A1]+[.$B$1]*SUM([.A1:B1])&amp;&quot;a&amp;lt;b&quot;\"") ||
+	        !strstr(res, "table:formula=\"of:=[.A30]+[.$B$1]*SUM([.A30:B30])&amp;&quot;a&amp;lt;b&quot;\""))
+	{
+		std::cerr << "testSheet1: the formulas are bad\n";
+		return false;
+	}
+	return true;
+}
+
+static bool testStringValues()
+{
+	StringDocumentHandler content;
+	OdsGenerator generator;
+	generator.addDocumentHandler(&content, ODF_FLAT_XML);
+	generator.startDocument(librevenge::RVNGPropertyList());
+	librevenge::RVNGPropertyList list;
+	list.insert("librevenge:sheet-name", "Values");
+	generator.openSheet(list);
+	list.clear();
+	list.insert("librevenge:row", 0);
+	generator.openSheetRow(list);
+	// the values are inserted as strings, as some filters do
+	static char const *const values[]= {"12.5", "nan", "0", "-3e2", "abc"};
+	for (int c = 0; c < 5; ++c)
+	{
+		librevenge::RVNGPropertyList cell;
+		cell.insert("librevenge:column", c);
+		cell.insert("librevenge:row", 0);
+		cell.insert("librevenge:value-type", "float");
+		cell.insert("librevenge:value", values[c]);
+		generator.openSheetCell(cell);
+		generator.closeSheetCell();
+	}
+	generator.closeSheetRow();
+	generator.closeSheet();
+	generator.endDocument();
+
+	char const *res=content.cstr();
+	if (!strstr(res, "office:value=\"12.5\"") || !strstr(res, "calcext:value-type=\"error\"") ||
+	        !strstr(res, "office:value=\"0\"") || !strstr(res, "office:value=\"-300\"") ||
+	        !strstr(res, "office:value=\"abc\""))
+	{
+		std::cerr << "testSheet1: the string values are bad\n";
+		return false;
+	}
+	return true;
+}
+
+static void addCondition(librevenge::RVNGPropertyListVector &conditions, char const *oper, int column)
+{
+	librevenge::RVNGPropertyListVector formula;
+	librevenge::RVNGPropertyList token;
+	token.insert("librevenge:type", "librevenge-cell");
+	token.insert("librevenge:column", column);
+	token.insert("librevenge:row", 0);
+	formula.append(token);
+	addToken(formula, "librevenge-operator", "librevenge:operator", oper);
+	addToken(formula, "librevenge-number", "librevenge:number", "1");
+	librevenge::RVNGPropertyList condition;
+	condition.insert("librevenge:name", "Positive");
+	condition.insert("librevenge:formula", formula);
+	conditions.append(condition);
+}
+
+static bool testConditions()
+{
+	StringDocumentHandler content;
+	OdsGenerator generator;
+	generator.addDocumentHandler(&content, ODF_FLAT_XML);
+	generator.startDocument(librevenge::RVNGPropertyList());
+	librevenge::RVNGPropertyList numbering;
+	numbering.insert("librevenge:value-type", "number");
+	numbering.insert("librevenge:name", "Positive");
+	generator.defineSheetNumberingStyle(numbering);
+	// only the first condition is valid: the others have an unknown operator or a bad cell
+	librevenge::RVNGPropertyListVector conditions;
+	addCondition(conditions, ">=", 1);
+	addCondition(conditions, "!", 1);
+	addCondition(conditions, ">=", -1);
+	numbering.insert("librevenge:name", "Conditional");
+	numbering.insert("librevenge::conditions", conditions);
+	generator.defineSheetNumberingStyle(numbering);
+	generator.openSheet(librevenge::RVNGPropertyList());
+	generator.closeSheet();
+	generator.endDocument();
+
+	char const *res=content.cstr();
+	if (!strstr(res, "style:condition=\"of:=[.B1]&gt;=1\"") || strstr(res, "!") || strstr(res, "[.A1]"))
+	{
+		std::cerr << "testSheet1: the numbering conditions are bad\n";
+		return false;
+	}
+	return true;
+}
+
+static bool testStyleSharing()
+{
+	StringDocumentHandler content;
+	OdsGenerator generator;
+	generator.addDocumentHandler(&content, ODF_FLAT_XML);
+	generator.setSheetStyleSharing(true);
+	generator.startDocument(librevenge::RVNGPropertyList());
+	for (int s = 0; s < 4; ++s)
+	{
+		librevenge::RVNGPropertyList list;
+		generator.openSheet(list);
+		list.insert("style:row-height", 20, librevenge::RVNG_POINT);
+		generator.openSheetRow(list);
+		librevenge::RVNGPropertyList cell;
+		cell.insert("librevenge:column", 0);
+		cell.insert("fo:font-weight", "bold");
+		cell.insert("fo:background-color", "#c0c0c0");
+		generator.openSheetCell(cell);
+		generator.closeSheetCell();
+		generator.closeSheetRow();
+		generator.closeSheet();
+	}
+	generator.endDocument();
+
+	std::ofstream file("testSheet1-shared.ods");
+	file << content.cstr();
+	// the header style must be written once and used by each sheet
+	int numCellStyles=0, numUses=0;
+	for (char const *pos=content.cstr(); (pos=strstr(pos, "<style:style style:family=\"table-cell\""))!=0; ++pos)
+		++numCellStyles;
+	for (char const *pos=content.cstr(); (pos=strstr(pos, "table:style-name=\"Sheet_cell0\""))!=0; ++pos)
+		++numUses;
+	if (numCellStyles!=1 || numUses!=4 || strstr(content.cstr(), "Sheet1_cell0"))
+	{
+		std::cerr << "testSheet1: the cell styles are not shared\n";
+		return false;
+	}
+	return true;
+}
+
+static void addGridCell(OdsGenerator &generator, int r, int c)
+{
+	librevenge::RVNGPropertyList cell;
+	cell.insert("librevenge:column", c);
+	cell.insert("librevenge:value-type", "float");
+	cell.insert("librevenge:value", double(r>3 ? 7 : 10*r+c), librevenge::RVNG_GENERIC);
+	generator.openSheetCell(cell);
+	if (c==5)
+	{
+		generator.openParagraph(librevenge::RVNGPropertyList());
+		generator.insertText("end");
+		generator.closeParagraph();
+	}
+	generator.closeSheetCell();
+}
+
+static void createGrid(StringDocumentHandler &content, bool randomOrder)
+{
+	OdsGenerator generator;
+	generator.addDocumentHandler(&content, ODF_FLAT_XML);
+	generator.setSheetRandomOrder(randomOrder);
+	generator.startDocument(librevenge::RVNGPropertyList());
+	librevenge::RVNGPropertyList list;
+	list.insert("librevenge:sheet-name", "Grid");
+	generator.openSheet(list);
+	list.insert("style:row-height", 20, librevenge::RVNG_POINT);
+	// a 6x6 grid with some holes, sent row by row or one cell at a time in a shuffled order
+	for (int i = 0; i < 36; ++i)
+	{
+		int const pos=randomOrder ? (i*13)%36 : i;
+		int const r=pos/6, c=pos%6;
+		// the last two rows are identical, so they must be merged
+		int const row=r<4 ? 2*r : 4+r;
+		if (!randomOrder && c==0)
+		{
+			list.insert("librevenge:row", row);
+			generator.openSheetRow(list);
+		}
+		if ((r!=2 || c==5) && c!=3)
+		{
+			if (randomOrder)
+			{
+				list.insert("librevenge:row", row);
+				generator.openSheetRow(list);
+			}
+			addGridCell(generator, r, c);
+			if (randomOrder)
+				generator.closeSheetRow();
+		}
+		if (!randomOrder && c==5)
+			generator.closeSheetRow();
+	}
+	generator.closeSheet();
+	generator.endDocument();
+}
+
+static bool testRandomOrder()
+{
+	StringDocumentHandler orderedContent, randomContent;
+	createGrid(orderedContent, false);
+	createGrid(randomContent, true);
+	std::ofstream file("testSheet1-random.ods");
+	file << randomContent.cstr();
+	if (strcmp(orderedContent.cstr(), randomContent.cstr())!=0 ||
+	        !strstr(randomContent.cstr(), "table:number-rows-repeated=\"2\""))
+	{
+		std::cerr << "testSheet1: the cells sent in a random order are not sorted\n";
+		return false;
+	}
+	return true;
+}
+
+static void createCategories(StringDocumentHandler &content, unsigned minLength)
+{
+	OdsGenerator generator;
+	generator.addDocumentHandler(&content, ODF_FLAT_XML);
+	generator.setTextInterning(minLength);
+	generator.startDocument(librevenge::RVNGPropertyList());
+	librevenge::RVNGPropertyList list;
+	list.insert("librevenge:sheet-name", "Categories");
+	generator.openSheet(list);
+	static char const *const categories[]= {"red", "green", "green", "blue", "a long category name"};
+	for (int r = 0; r < 20; ++r)
+	{
+		list.clear();
+		generator.openSheetRow(list);
+		for (int c = 0; c < 2; ++c)
+		{
+			librevenge::RVNGPropertyList cell;
+			cell.insert("librevenge:column", c);
+			cell.insert("librevenge:value-type", "string");
+			generator.openSheetCell(cell);
+			generator.openParagraph(librevenge::RVNGPropertyList());
+			generator.insertText(categories[(r/4+c)%5]);
+			generator.closeParagraph();
+			generator.closeSheetCell();
+		}
+		generator.closeSheetRow();
+	}
+	generator.closeSheet();
+	generator.endDocument();
+}
+
+static bool testTextInterning()
+{
+	StringDocumentHandler content, internedContent;
+	createCategories(content, 0);
+	createCategories(internedContent, 4);
+	std::ofstream file("testSheet1-categories.ods");
+	file << internedContent.cstr();
+	// the interned texts must not change the output, the identical rows are still merged
+	if (strcmp(content.cstr(), internedContent.cstr())!=0 ||
+	        !strstr(internedContent.cstr(), "table:number-rows-repeated=\"4\""))
+	{
+		std::cerr << "testSheet1: the interned texts change the output\n";
+		return false;
+	}
+	return true;
+}
+
+int main()
+{
+	if (!testRepeated() || !testBlock() || !testSpilling() || !testFormula() || !testStringValues() || !testConditions() || !testStyleSharing() ||
+	        !testRandomOrder() || !testTextInterning())
+		return 1;
+	return 0;
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 noexpandtab: */
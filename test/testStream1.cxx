@@ -0,0 +1,158 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* libodfgen
+ * Version: MPL 2.0 / LGPLv2.1+
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU Lesser General Public License Version 2.1 or later
+ * (LGPLv2.1+), in which case the provisions of the LGPLv2.1+ are
+ * applicable instead of those above.
+ *
+ * For further information visit http://libwpd.sourceforge.net
+ */
+
+#include <string.h>
+
+#include <iostream>
+#include <fstream>
+
+#include <librevenge/librevenge.h>
+#include <libodfgen/libodfgen.hxx>
+
+#include "StringDocumentHandler.hxx"
+
+static void writeFiles(char const *prefix, StringDocumentHandler const &content, StringDocumentHandler const &styles)
+{
+	std::string name(prefix);
+	std::ofstream contentFile((name+"-content.xml").c_str());
+	contentFile << content.cstr();
+	std::ofstream stylesFile((name+"-styles.xml").c_str());
+	stylesFile << styles.cstr();
+}
+
+static void createOds(StringDocumentHandler &content, StringDocumentHandler &styles, bool streaming)
+{
+	OdsGenerator generator;
+	generator.addDocumentHandler(&content, ODF_CONTENT_XML);
+	generator.addDocumentHandler(&styles, ODF_STYLES_XML);
+	generator.setContentStreaming(streaming);
+
+	generator.startDocument(librevenge::RVNGPropertyList());
+	librevenge::RVNGPropertyList list;
+	librevenge::RVNGPropertyListVector columns;
+	for (int c = 0; c < 2; c++)
+	{
+		librevenge::RVNGPropertyList column;
+		column.insert("style:column-width", 1+c, librevenge::RVNG_INCH);
+		columns.append(column);
+	}
+	list.insert("librevenge:columns", columns);
+	list.insert("librevenge:sheet-name", "Streamed");
+	generator.openSheet(list);
+	// enough cells so that the body is moved several times in the temporary file
+	for (int r = 0; r < 60000; ++r)
+	{
+		list.clear();
+		list.insert("style:row-height", 20+10*(r%3), librevenge::RVNG_POINT);
+		generator.openSheetRow(list);
+		for (int c = 0; c < 2; ++c)
+		{
+			librevenge::RVNGPropertyList cell;
+			cell.insert("librevenge:column", c);
+			cell.insert("librevenge:row", r);
+			if (c==1)
+				cell.insert("fo:background-color", "#ff0000");
+			cell.insert("librevenge:value-type", "float");
+			cell.insert("librevenge:value", double(r*2+c));
+			generator.openSheetCell(cell);
+			generator.closeSheetCell();
+		}
+		generator.closeSheetRow();
+	}
+	generator.closeSheet();
+	generator.endDocument();
+}
+
+static bool testOds()
+{
+	StringDocumentHandler content, styles;
+	createOds(content, styles, true);
+	writeFiles("testStream1-ods", content, styles);
+	StringDocumentHandler memoryContent, memoryStyles;
+	createOds(memoryContent, memoryStyles, false);
+	if (strcmp(content.cstr(), memoryContent.cstr()) || strcmp(styles.cstr(), memoryStyles.cstr()))
+		return false;
+	// the automatic styles must stay in content.xml, before the body
+	char const *autoStyles=strstr(content.cstr(), "<office:automatic-styles");
+	char const *cellStyle=strstr(content.cstr(), "Sheet0_cell1");
+	char const *body=strstr(content.cstr(), "<office:body");
+	return autoStyles && cellStyle && body && autoStyles<cellStyle && cellStyle<body &&
+	       !strstr(styles.cstr(), "Sheet0_cell1");
+}
+
+static void createOdt(StringDocumentHandler &content, StringDocumentHandler &styles, bool streaming)
+{
+	OdtGenerator generator;
+	generator.addDocumentHandler(&content, ODF_CONTENT_XML);
+	generator.addDocumentHandler(&styles, ODF_STYLES_XML);
+	generator.setContentStreaming(streaming);
+
+	generator.startDocument(librevenge::RVNGPropertyList());
+	librevenge::RVNGPropertyList page;
+	page.insert("librevenge:num-pages", 1);
+	page.insert("fo:page-height", 11.5, librevenge::RVNG_INCH);
+	page.insert("fo:page-width", 9, librevenge::RVNG_INCH);
+	generator.openPageSpan(page);
+
+	librevenge::RVNGPropertyList para, span;
+	para.insert("fo:text-align","center");
+	span.insert("style:font-name","Courier");
+	span.insert("fo:font-size", 13, librevenge::RVNG_POINT);
+	for (int i = 0; i < 60000; ++i)
+	{
+		generator.openParagraph(para);
+		generator.openSpan(span);
+		generator.insertText("streamed text");
+		generator.closeSpan();
+		generator.closeParagraph();
+	}
+	generator.closePageSpan();
+	generator.endDocument();
+}
+
+static bool testOdt()
+{
+	StringDocumentHandler content, styles;
+	createOdt(content, styles, true);
+	writeFiles("testStream1-odt", content, styles);
+	StringDocumentHandler memoryContent, memoryStyles;
+	createOdt(memoryContent, memoryStyles, false);
+	if (strcmp(content.cstr(), memoryContent.cstr()) || strcmp(styles.cstr(), memoryStyles.cstr()))
+		return false;
+	// the fonts must stay in content.xml
+	char const *font=strstr(content.cstr(), "Courier");
+	char const *body=strstr(content.cstr(), "<office:body");
+	return font && body && font<body;
+}
+
+int main()
+{
+	if (!testOds())
+	{
+		std::cerr << "testStream1: the streamed ods content differs\n";
+		return 1;
+	}
+	if (!testOdt())
+	{
+		std::cerr << "testStream1: the streamed odt content differs\n";
+		return 1;
+	}
+	return 0;
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 noexpandtab: */
@@ -0,0 +1,161 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* libodfgen
+ * Version: MPL 2.0 / LGPLv2.1+
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU Lesser General Public License Version 2.1 or later
+ * (LGPLv2.1+), in which case the provisions of the LGPLv2.1+ are
+ * applicable instead of those above.
+ *
+ * For further information visit http://libwpd.sourceforge.net
+ */
+
+#include <string.h>
+
+#include <iostream>
+#include <fstream>
+#include <string>
+
+#include <librevenge/librevenge.h>
+#include <libodfgen/libodfgen.hxx>
+
+#include "StringDocumentHandler.hxx"
+#include "XMLChecker.hxx"
+
+static bool appendData(const char *data, unsigned long size, void *userData)
+{
+	static_cast<std::string *>(userData)->append(data, size);
+	return true;
+}
+
+static void createDocument(OdfDocumentHandler &handler)
+{
+	OdtGenerator generator;
+	generator.addDocumentHandler(&handler, ODF_FLAT_XML);
+
+	generator.startDocument(librevenge::RVNGPropertyList());
+	librevenge::RVNGPropertyList page;
+	page.insert("librevenge:num-pages", 1);
+	page.insert("fo:page-height", 11.5, librevenge::RVNG_INCH);
+	page.insert("fo:page-width", 9, librevenge::RVNG_INCH);
+	generator.openPageSpan(page);
+
+	librevenge::RVNGPropertyList para, span;
+	para.insert("fo:text-align","center");
+	span.insert("style:font-name","Courier");
+	span.insert("fo:font-size", 13, librevenge::RVNG_POINT);
+	for (int i=0; i<1000; ++i)
+	{
+		generator.openParagraph(para);
+		generator.openSpan(span);
+		generator.insertText("a long text with <special> & \"quoted\" 'characters' to escape");
+		generator.closeSpan();
+		generator.closeParagraph();
+	}
+
+	generator.closePageSpan();
+	generator.endDocument();
+}
+
+static void createSpreadsheet(OdfDocumentHandler &handler)
+{
+	OdsGenerator generator;
+	generator.addDocumentHandler(&handler, ODF_FLAT_XML);
+
+	generator.startDocument(librevenge::RVNGPropertyList());
+	librevenge::RVNGPropertyList list;
+	librevenge::RVNGPropertyListVector columns;
+	librevenge::RVNGPropertyList column;
+	column.insert("style:column-width", 1, librevenge::RVNG_INCH);
+	columns.append(column);
+	list.insert("librevenge:columns", columns);
+	list.insert("librevenge:sheet-name", "R&D <Q1> \"x\"");
+	generator.openSheet(list);
+	generator.openSheetRow(librevenge::RVNGPropertyList());
+	librevenge::RVNGPropertyList cell;
+	cell.insert("librevenge:column", 0);
+	cell.insert("librevenge:row", 0);
+	generator.openSheetCell(cell);
+	generator.openParagraph(librevenge::RVNGPropertyList());
+	librevenge::RVNGPropertyList span, link;
+	span.insert("style:font-name", "Font & <Co>");
+	generator.openSpan(span);
+	// the link target is escaped by the generator
+	link.insert("librevenge:type", "link");
+	link.insert("xlink:href", "http://example.com/?a=1&b=<2>");
+	generator.openLink(link);
+	generator.insertText("R&D");
+	generator.closeLink();
+	generator.closeSpan();
+	generator.closeParagraph();
+	generator.closeSheetCell();
+	generator.closeSheetRow();
+	generator.closeSheet();
+	generator.endDocument();
+}
+
+static bool testSpecialNames()
+{
+	OdfXMLWriter writer;
+	createSpreadsheet(writer);
+	std::string const data(writer.getData(), writer.getDataSize());
+	// the values must be escaped exactly once
+	return isWellFormedXML(data.c_str(), data.size()) &&
+	       data.find("table:name=\"R&amp;D &lt;Q1&gt; &quot;x&quot;\"")!=std::string::npos &&
+	       data.find("style:name=\"Font &amp; &lt;Co&gt;\"")!=std::string::npos &&
+	       data.find("svg:font-family=\"Font &amp; &lt;Co&gt;\"")!=std::string::npos &&
+	       data.find("xlink:href=\"http://example.com/?a=1&amp;b=&lt;2&gt;\"")!=std::string::npos;
+}
+
+int main()
+{
+	StringDocumentHandler reference;
+	createDocument(reference);
+
+	OdfXMLWriter memoryWriter;
+	createDocument(memoryWriter);
+	std::string const memory(memoryWriter.getData(), memoryWriter.getDataSize());
+	if (memory!=reference.cstr() || !isWellFormedXML(memory.c_str(), memory.size()))
+	{
+		std::cerr << "testXMLWriter1: the memory output differs\n";
+		return 1;
+	}
+	if (!testSpecialNames())
+	{
+		std::cerr << "testXMLWriter1: the sheet and the font names are badly escaped\n";
+		return 1;
+	}
+
+	std::string callbackData;
+	OdfXMLWriter callbackWriter(appendData, &callbackData);
+	createDocument(callbackWriter);
+	if (callbackData!=memory || callbackWriter.getDataSize())
+	{
+		std::cerr << "testXMLWriter1: the callback output differs\n";
+		return 1;
+	}
+
+	FILE *file=fopen("testXMLWriter1.odt", "wb");
+	if (!file)
+	{
+		std::cerr << "testXMLWriter1: can not create the file\n";
+		return 1;
+	}
+	OdfXMLWriter fileWriter(file);
+	createDocument(fileWriter);
+	fclose(file);
+	if (fileWriter.hasError())
+	{
+		std::cerr << "testXMLWriter1: can not write the file\n";
+		return 1;
+	}
+	return 0;
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 noexpandtab: */